@@ -35,14 +35,12 @@ typedef struct
 } ant_bpwr_message_layout_t;
 
 
-/**@brief Function for initializing the ANT Bicycle Power Profile instance.
+/**@brief Function for setting the channel number and the default pages of the ANT Bicycle Power profile instance.
  *
  * @param[in]  p_profile        Pointer to the profile instance.
  * @param[in]  p_channel_config Pointer to the ANT channel configuration structure.
- *
- * @retval     NRF_SUCCESS      If initialization was successful. Otherwise, an error code is returned.
  */
-static ret_code_t ant_bpwr_init(ant_bpwr_profile_t         * p_profile,
+static void ant_bpwr_pages_init(ant_bpwr_profile_t         * p_profile,
                                 ant_channel_config_t const * p_channel_config)
 {
     p_profile->channel_number = p_channel_config->channel_number;
@@ -53,6 +51,20 @@ static ret_code_t ant_bpwr_init(ant_bpwr_profile_t         * p_profile,
     p_profile->page_18 = DEFAULT_ANT_BPWR_PAGE18();
     p_profile->page_80 = DEFAULT_ANT_COMMON_page80();
     p_profile->page_81 = DEFAULT_ANT_COMMON_page81();
+}
+
+
+/**@brief Function for initializing the ANT Bicycle Power Profile instance.
+ *
+ * @param[in]  p_profile        Pointer to the profile instance.
+ * @param[in]  p_channel_config Pointer to the ANT channel configuration structure.
+ *
+ * @retval     NRF_SUCCESS      If initialization was successful. Otherwise, an error code is returned.
+ */
+static ret_code_t ant_bpwr_init(ant_bpwr_profile_t         * p_profile,
+                                ant_channel_config_t const * p_channel_config)
+{
+    ant_bpwr_pages_init(p_profile, p_channel_config);
 
     LOG_BPWR("ANT B-PWR channel %u init\n\r", p_profile->channel_number);
     return ant_channel_init(p_channel_config);
@@ -62,6 +74,22 @@ static ret_code_t ant_bpwr_init(ant_bpwr_profile_t         * p_profile,
 ret_code_t ant_bpwr_disp_init(ant_bpwr_profile_t           * p_profile,
                               ant_channel_config_t const   * p_channel_config,
                               ant_bpwr_disp_config_t const * p_disp_config)
+{
+    ret_code_t err_code = ant_bpwr_disp_scan_init(p_profile, p_channel_config, p_disp_config);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    LOG_BPWR("ANT B-PWR channel %u init\n\r", p_profile->channel_number);
+    return ant_channel_init(p_channel_config);
+}
+
+
+ret_code_t ant_bpwr_disp_scan_init(ant_bpwr_profile_t           * p_profile,
+                                   ant_channel_config_t const   * p_channel_config,
+                                   ant_bpwr_disp_config_t const * p_disp_config)
 {
     ASSERT(p_profile != NULL);
     ASSERT(p_channel_config != NULL);
@@ -75,7 +103,10 @@ ret_code_t ant_bpwr_disp_init(ant_bpwr_profile_t           * p_profile,
     p_profile->_cb.p_disp_cb ->calib_timeout = 0;
     p_profile->_cb.p_disp_cb ->calib_stat    = BPWR_DISP_CALIB_NONE;
 
-    return ant_bpwr_init(p_profile, p_channel_config);
+    ant_bpwr_pages_init(p_profile, p_channel_config);
+
+    LOG_BPWR("ANT B-PWR device %u init\n\r", p_channel_config->device_number);
+    return NRF_SUCCESS;
 }
 
 
@@ -44,14 +44,12 @@ typedef union
 }ant_bsc_message_layout_t;
 
 
-/**@brief Function for initializing the ANT BSC profile instance.
+/**@brief Function for setting the channel number and the default pages of the ANT BSC profile instance.
  *
  * @param[in]  p_profile        Pointer to the profile instance.
  * @param[in]  p_channel_config Pointer to the ANT channel configuration structure.
- *
- * @retval     NRF_SUCCESS      If initialization was successful. Otherwise, an error code is returned.
  */
-static ret_code_t ant_bsc_init(ant_bsc_profile_t          * p_profile,
+static void ant_bsc_pages_init(ant_bsc_profile_t          * p_profile,
                                ant_channel_config_t const * p_channel_config)
 {
     p_profile->channel_number = p_channel_config->channel_number;
@@ -63,6 +61,20 @@ static ret_code_t ant_bsc_init(ant_bsc_profile_t          * p_profile,
     p_profile->page_4       = DEFAULT_ANT_BSC_PAGE4();
     p_profile->page_5       = DEFAULT_ANT_BSC_PAGE5();
     p_profile->page_comb_0  = DEFAULT_ANT_BSC_COMBINED_PAGE0();
+}
+
+
+/**@brief Function for initializing the ANT BSC profile instance.
+ *
+ * @param[in]  p_profile        Pointer to the profile instance.
+ * @param[in]  p_channel_config Pointer to the ANT channel configuration structure.
+ *
+ * @retval     NRF_SUCCESS      If initialization was successful. Otherwise, an error code is returned.
+ */
+static ret_code_t ant_bsc_init(ant_bsc_profile_t          * p_profile,
+                               ant_channel_config_t const * p_channel_config)
+{
+    ant_bsc_pages_init(p_profile, p_channel_config);
 
     LOG_BSC("ANT BSC channel %u init\n\r", p_profile->channel_number);
     return ant_channel_init(p_channel_config);
@@ -71,6 +83,21 @@ static ret_code_t ant_bsc_init(ant_bsc_profile_t          * p_profile,
 ret_code_t ant_bsc_disp_init(ant_bsc_profile_t           * p_profile,
                              ant_channel_config_t const  * p_channel_config,
                              ant_bsc_disp_config_t const * p_disp_config)
+{
+    ret_code_t err_code = ant_bsc_disp_scan_init(p_profile, p_channel_config, p_disp_config);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    LOG_BSC("ANT BSC channel %u init\n\r", p_profile->channel_number);
+    return ant_channel_init(p_channel_config);
+}
+
+ret_code_t ant_bsc_disp_scan_init(ant_bsc_profile_t           * p_profile,
+                                  ant_channel_config_t const  * p_channel_config,
+                                  ant_bsc_disp_config_t const * p_disp_config)
 {
     ASSERT(p_profile != NULL);
     ASSERT(p_channel_config != NULL);
@@ -81,7 +108,10 @@ ret_code_t ant_bsc_disp_init(ant_bsc_profile_t           * p_profile,
 
     p_profile->_cb.p_disp_cb->device_type = p_channel_config->device_type;
 
-    return ant_bsc_init(p_profile, p_channel_config);
+    ant_bsc_pages_init(p_profile, p_channel_config);
+
+    LOG_BSC("ANT BSC device %u init\n\r", p_channel_config->device_number);
+    return NRF_SUCCESS;
 }
 
 ret_code_t ant_bsc_sens_init(ant_bsc_profile_t           * p_profile,
@@ -30,15 +30,13 @@ typedef struct
     uint8_t        page_payload[7];
 } ant_hrm_message_layout_t;
 
-/**@brief Function for initializing the ANT HRM profile instance.
+/**@brief Function for setting the channel number and the default pages of the ANT HRM profile instance.
  *
  * @param[in]  p_profile        Pointer to the profile instance.
  * @param[in]  p_channel_config Pointer to the ANT channel configuration structure.
- *
- * @retval     NRF_SUCCESS      If initialization was successful. Otherwise, an error code is returned.
  */
-static ret_code_t ant_hrm_init(ant_hrm_profile_t          * p_profile,
-                             ant_channel_config_t const * p_channel_config)
+static void ant_hrm_pages_init(ant_hrm_profile_t          * p_profile,
+                               ant_channel_config_t const * p_channel_config)
 {
     p_profile->channel_number = p_channel_config->channel_number;
 
@@ -47,6 +45,20 @@ static ret_code_t ant_hrm_init(ant_hrm_profile_t          * p_profile,
     p_profile->page_2 = DEFAULT_ANT_HRM_PAGE2();
     p_profile->page_3 = DEFAULT_ANT_HRM_PAGE3();
     p_profile->page_4 = DEFAULT_ANT_HRM_PAGE4();
+}
+
+
+/**@brief Function for initializing the ANT HRM profile instance.
+ *
+ * @param[in]  p_profile        Pointer to the profile instance.
+ * @param[in]  p_channel_config Pointer to the ANT channel configuration structure.
+ *
+ * @retval     NRF_SUCCESS      If initialization was successful. Otherwise, an error code is returned.
+ */
+static ret_code_t ant_hrm_init(ant_hrm_profile_t          * p_profile,
+                             ant_channel_config_t const * p_channel_config)
+{
+    ant_hrm_pages_init(p_profile, p_channel_config);
 
     LOG_HRM("ANT HRM channel %u init\n\r", p_profile->channel_number);
     return ant_channel_init(p_channel_config);
@@ -56,6 +68,22 @@ static ret_code_t ant_hrm_init(ant_hrm_profile_t          * p_profile,
 ret_code_t ant_hrm_disp_init(ant_hrm_profile_t          * p_profile,
                            ant_channel_config_t const * p_channel_config,
                            ant_hrm_evt_handler_t        evt_handler)
+{
+    ret_code_t err_code = ant_hrm_disp_scan_init(p_profile, p_channel_config, evt_handler);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    LOG_HRM("ANT HRM channel %u init\n\r", p_profile->channel_number);
+    return ant_channel_init(p_channel_config);
+}
+
+
+ret_code_t ant_hrm_disp_scan_init(ant_hrm_profile_t          * p_profile,
+                                  ant_channel_config_t const * p_channel_config,
+                                  ant_hrm_evt_handler_t        evt_handler)
 {
     ASSERT(p_profile != NULL);
     ASSERT(p_channel_config != NULL);
@@ -63,7 +91,10 @@ ret_code_t ant_hrm_disp_init(ant_hrm_profile_t          * p_profile,
 
     p_profile->evt_handler = evt_handler;
 
-    return ant_hrm_init(p_profile, p_channel_config);
+    ant_hrm_pages_init(p_profile, p_channel_config);
+
+    LOG_HRM("ANT HRM device %u init\n\r", p_channel_config->device_number);
+    return NRF_SUCCESS;
 }
 
 
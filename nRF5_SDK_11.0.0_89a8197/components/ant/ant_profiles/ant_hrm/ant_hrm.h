@@ -200,6 +200,22 @@ ret_code_t ant_hrm_disp_init(ant_hrm_profile_t          * p_profile,
                              ant_channel_config_t const * p_channel_config,
                              ant_hrm_evt_handler_t        evt_handler);
 
+/**@brief Function for initializing an ANT HRM Display profile instance that receives from a scanning channel.
+ *
+ * @details Same as @ref ant_hrm_disp_init, but the channel is not configured. The instance
+ *          decodes the messages of one sensor received on a channel in continuous scanning mode
+ *          (see @ref ant_scan_demux).
+ *
+ * @param[in]  p_profile        Pointer to the profile instance.
+ * @param[in]  p_channel_config Pointer to the ANT channel configuration structure. Only the channel number and the channel ID are used.
+ * @param[in]  evt_handler      Event handler to be called for handling events in the HRM profile.
+ *
+ * @retval     NRF_SUCCESS      If initialization was successful.
+ */
+ret_code_t ant_hrm_disp_scan_init(ant_hrm_profile_t          * p_profile,
+                                  ant_channel_config_t const * p_channel_config,
+                                  ant_hrm_evt_handler_t        evt_handler);
+
 /**@brief Function for initializing the ANT HRM Sensor profile instance.
  *
  * @param[in]  p_profile        Pointer to the profile instance.
@@ -29,15 +29,12 @@ typedef struct
     uint8_t         page_payload[7];
 }ant_sdm_message_layout_t;
 
-/**@brief Function for initializing the ANT SDM profile instance.
+/**@brief Function for setting the channel number and the default pages of the ANT SDM profile instance.
  *
  * @param[in]  p_profile        Pointer to the profile instance.
  * @param[in]  p_channel_config Pointer to the ANT channel configuration structure.
- *
- * @retval     NRF_SUCCESS      Successful initialization.
- *             Error code when initialization failed.
  */
-static ret_code_t ant_sdm_init(ant_sdm_profile_t          * p_profile,
+static void ant_sdm_pages_init(ant_sdm_profile_t          * p_profile,
                                ant_channel_config_t const * p_channel_config)
 {
     p_profile->channel_number = p_channel_config->channel_number;
@@ -49,6 +46,21 @@ static ret_code_t ant_sdm_init(ant_sdm_profile_t          * p_profile,
     p_profile->common  = DEFAULT_ANT_SDM_COMMON_DATA();
     p_profile->page_80 = DEFAULT_ANT_COMMON_page80();
     p_profile->page_81 = DEFAULT_ANT_COMMON_page81();
+}
+
+
+/**@brief Function for initializing the ANT SDM profile instance.
+ *
+ * @param[in]  p_profile        Pointer to the profile instance.
+ * @param[in]  p_channel_config Pointer to the ANT channel configuration structure.
+ *
+ * @retval     NRF_SUCCESS      Successful initialization.
+ *             Error code when initialization failed.
+ */
+static ret_code_t ant_sdm_init(ant_sdm_profile_t          * p_profile,
+                               ant_channel_config_t const * p_channel_config)
+{
+    ant_sdm_pages_init(p_profile, p_channel_config);
 
     LOG_SDM("ANT SDM channel %u init\n\r", p_profile->channel_number);
     return ant_channel_init(p_channel_config);
@@ -57,6 +69,21 @@ static ret_code_t ant_sdm_init(ant_sdm_profile_t          * p_profile,
 ret_code_t ant_sdm_disp_init(ant_sdm_profile_t           * p_profile,
                              ant_channel_config_t const  * p_channel_config,
                              ant_sdm_disp_config_t const * p_disp_config)
+{
+    ret_code_t err_code = ant_sdm_disp_scan_init(p_profile, p_channel_config, p_disp_config);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    LOG_SDM("ANT SDM channel %u init\n\r", p_profile->channel_number);
+    return ant_channel_init(p_channel_config);
+}
+
+ret_code_t ant_sdm_disp_scan_init(ant_sdm_profile_t           * p_profile,
+                                  ant_channel_config_t const  * p_channel_config,
+                                  ant_sdm_disp_config_t const * p_disp_config)
 {
     ASSERT(p_profile != NULL);
     ASSERT(p_channel_config != NULL);
@@ -68,7 +95,10 @@ ret_code_t ant_sdm_disp_init(ant_sdm_profile_t           * p_profile,
     p_profile->_cb.p_disp_cb = p_disp_config->p_cb;
     ant_request_controller_init(&(p_profile->_cb.p_disp_cb->req_controller));
 
-    return ant_sdm_init(p_profile, p_channel_config);
+    ant_sdm_pages_init(p_profile, p_channel_config);
+
+    LOG_SDM("ANT SDM device %u init\n\r", p_channel_config->device_number);
+    return NRF_SUCCESS;
 }
 
 ret_code_t ant_sdm_sens_init(ant_sdm_profile_t           * p_profile,
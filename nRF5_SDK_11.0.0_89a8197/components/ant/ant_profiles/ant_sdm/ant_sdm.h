@@ -229,6 +229,22 @@ ret_code_t ant_sdm_disp_init(ant_sdm_profile_t           * p_profile,
                              ant_channel_config_t const  * p_channel_config,
                              ant_sdm_disp_config_t const * p_disp_config);
 
+/**@brief Function for initializing an ANT SDM RX profile instance that receives from a scanning channel.
+ *
+ * @details Same as @ref ant_sdm_disp_init, but the channel is not configured. The instance
+ *          decodes the messages of one sensor received on a channel in continuous scanning mode
+ *          (see @ref ant_scan_demux). Page requests cannot be sent from such an instance.
+ *
+ * @param[in]  p_profile        Pointer to the profile instance.
+ * @param[in]  p_channel_config Pointer to the ANT channel configuration structure. Only the channel number and the channel ID are used.
+ * @param[in]  p_disp_config    Pointer to the SDM Display configuration structure.
+ *
+ * @retval     NRF_SUCCESS      If initialization was successful.
+ */
+ret_code_t ant_sdm_disp_scan_init(ant_sdm_profile_t           * p_profile,
+                                  ant_channel_config_t const  * p_channel_config,
+                                  ant_sdm_disp_config_t const * p_disp_config);
+
 /**@brief Function for initializing the ANT SDM TX profile instance.
  *
  * @param[in]  p_profile        Pointer to the profile instance.
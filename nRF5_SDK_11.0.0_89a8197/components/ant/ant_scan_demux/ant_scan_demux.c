@@ -0,0 +1,313 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <string.h>
+#include "ant_scan_demux.h"
+#include "ant_interface.h"
+#include "ant_parameters.h"
+#include "app_util.h"
+#include "compiler_abstraction.h"
+#include "nrf_assert.h"
+#include "nrf_error.h"
+
+#define HASH_SIZE               (1u << ANT_SCAN_DEMUX_HASH_BITS)    /**< Number of hash buckets. */
+#define HASH_MULTIPLIER         2654435761u                         /**< Multiplier for Fibonacci hashing of the channel ID. */
+#define DEVICE_TYPE_MASK        0x7F                                /**< Device type without the pairing bit. */
+#define LOST_TICKS_MAX          0x7FFF                              /**< Largest timeout that the 16-bit tick arithmetic can handle. */
+
+STATIC_ASSERT((ANT_SCAN_DEMUX_HASH_BITS > 0) && (ANT_SCAN_DEMUX_HASH_BITS <= 16));
+
+static ant_scan_demux_slot_t * m_buckets[HASH_SIZE];                    ///< Hash table of slots in use.
+static ant_scan_demux_type_t * m_types[ANT_SCAN_DEMUX_TYPES_MAX];       ///< Registered pools.
+static uint8_t                 m_type_count;                            ///< Number of registered pools.
+static uint8_t                 m_channel_number;                        ///< Scanning channel.
+static uint16_t                m_lost_ticks;                            ///< Timeout for releasing instances.
+static uint16_t                m_tick;                                  ///< Current tick count.
+static ant_scan_demux_stats_t  m_stats;                                 ///< Statistics.
+
+
+/**@brief Function for getting the hash bucket of a channel ID. */
+static __INLINE uint32_t bucket_get(ant_scan_demux_id_t const * p_id)
+{
+    uint32_t key = (uint32_t)p_id->device_number
+                 | ((uint32_t)p_id->device_type << 16)
+                 | ((uint32_t)p_id->transmission_type << 24);
+
+    return (key * HASH_MULTIPLIER) >> (32 - ANT_SCAN_DEMUX_HASH_BITS);
+}
+
+
+static __INLINE bool id_equal(ant_scan_demux_id_t const * p_a, ant_scan_demux_id_t const * p_b)
+{
+    return (p_a->device_number     == p_b->device_number)
+        && (p_a->device_type       == p_b->device_type)
+        && (p_a->transmission_type == p_b->transmission_type);
+}
+
+
+/**@brief Function for getting the pool that a slot belongs to. */
+static ant_scan_demux_type_t * slot_type_get(ant_scan_demux_slot_t const * p_slot)
+{
+    for (uint32_t i = 0; i < m_type_count; i++)
+    {
+        ant_scan_demux_type_t * p_type = m_types[i];
+
+        if ((p_slot >= p_type->p_slots) && (p_slot < p_type->p_slots + p_type->pool_size))
+        {
+            return p_type;
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for getting the pool that handles a device type. */
+static ant_scan_demux_type_t * device_type_get(uint8_t device_type)
+{
+    for (uint32_t i = 0; i < m_type_count; i++)
+    {
+        if (m_types[i]->device_type == device_type)
+        {
+            return m_types[i];
+        }
+    }
+    return NULL;
+}
+
+
+/**@brief Function for getting the profile instance of a slot. */
+static __INLINE void * instance_get(ant_scan_demux_type_t const * p_type,
+                                    ant_scan_demux_slot_t const * p_slot)
+{
+    return (uint8_t *)p_type->p_instances + (p_slot - p_type->p_slots) * p_type->instance_size;
+}
+
+
+static ant_scan_demux_slot_t * slot_find(ant_scan_demux_id_t const * p_id)
+{
+    ant_scan_demux_slot_t * p_slot = m_buckets[bucket_get(p_id)];
+
+    while ((p_slot != NULL) && !id_equal(&p_slot->id, p_id))
+    {
+        p_slot = p_slot->p_next;
+    }
+    return p_slot;
+}
+
+
+/**@brief Function for taking a slot from a pool and initializing its instance for a new sensor.
+ *
+ * @return     The slot, or NULL if the pool is full or the instance could not be initialized.
+ */
+static ant_scan_demux_slot_t * slot_create(ant_scan_demux_type_t     * p_type,
+                                           ant_scan_demux_id_t const * p_id)
+{
+    ant_scan_demux_slot_t * p_slot = p_type->p_free;
+    ant_channel_config_t    channel_config;
+    uint32_t                bucket;
+
+    if (p_slot == NULL)
+    {
+        return NULL;
+    }
+
+    memset(&channel_config, 0, sizeof(channel_config));
+    channel_config.channel_number    = m_channel_number;
+    channel_config.device_number     = p_id->device_number;
+    channel_config.device_type       = p_id->device_type;
+    channel_config.transmission_type = p_id->transmission_type;
+
+    if (p_type->init_handler(instance_get(p_type, p_slot), &channel_config) != NRF_SUCCESS)
+    {
+        return NULL;
+    }
+
+    p_type->p_free = p_slot->p_next;
+
+    bucket          = bucket_get(p_id);
+    p_slot->id      = *p_id;
+    p_slot->in_use  = true;
+    p_slot->p_next  = m_buckets[bucket];
+    m_buckets[bucket] = p_slot;
+
+    m_stats.created++;
+
+    return p_slot;
+}
+
+
+/**@brief Function for releasing a slot in use and returning it to its pool. */
+static void slot_release(ant_scan_demux_type_t * p_type, ant_scan_demux_slot_t * p_slot)
+{
+    ant_scan_demux_slot_t ** pp_link = &m_buckets[bucket_get(&p_slot->id)];
+
+    while (*pp_link != p_slot)
+    {
+        pp_link = &(*pp_link)->p_next;
+    }
+    *pp_link = p_slot->p_next;
+
+    if (p_type->lost_handler != NULL)
+    {
+        p_type->lost_handler(instance_get(p_type, p_slot));
+    }
+
+    p_slot->in_use = false;
+    p_slot->p_next = p_type->p_free;
+    p_type->p_free = p_slot;
+
+    m_stats.released++;
+}
+
+
+ret_code_t ant_scan_demux_init(uint8_t channel_number, uint16_t lost_ticks)
+{
+    if ((lost_ticks == 0) || (lost_ticks > LOST_TICKS_MAX))
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    memset(m_buckets, 0, sizeof(m_buckets));
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    m_type_count     = 0;
+    m_channel_number = channel_number;
+    m_lost_ticks     = lost_ticks;
+    m_tick           = 0;
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t ant_scan_demux_type_add(ant_scan_demux_type_t * p_type)
+{
+    ASSERT(p_type != NULL);
+    ASSERT(p_type->init_handler != NULL);
+    ASSERT(p_type->evt_handler != NULL);
+
+    if (m_type_count >= ANT_SCAN_DEMUX_TYPES_MAX)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    if (device_type_get(p_type->device_type) != NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    p_type->p_free = NULL;
+
+    for (uint32_t i = p_type->pool_size; i > 0; i--)
+    {
+        ant_scan_demux_slot_t * p_slot = &p_type->p_slots[i - 1];
+
+        p_slot->in_use = false;
+        p_slot->p_next = p_type->p_free;
+        p_type->p_free = p_slot;
+    }
+
+    m_types[m_type_count++] = p_type;
+
+    return NRF_SUCCESS;
+}
+
+
+void ant_scan_demux_evt_handler(ant_evt_t * p_ant_evt)
+{
+    ANT_MESSAGE           * p_message = (ANT_MESSAGE *)p_ant_evt->msg.evt_buffer;
+    ant_scan_demux_type_t * p_type;
+    ant_scan_demux_slot_t * p_slot;
+    ant_scan_demux_id_t     id;
+
+    if ((p_ant_evt->channel != m_channel_number) || (p_ant_evt->event != EVENT_RX))
+    {
+        return;
+    }
+
+    if (!p_message->ANT_MESSAGE_stExtMesgBF.bANTDeviceID)
+    {
+        m_stats.unidentified++;
+        return;
+    }
+
+    id.device_number     = (uint16_t)(p_message->ANT_MESSAGE_aucExtData[0]
+                                      | ((uint16_t)p_message->ANT_MESSAGE_aucExtData[1] << 8));
+    id.device_type       = p_message->ANT_MESSAGE_aucExtData[2] & DEVICE_TYPE_MASK;
+    id.transmission_type = p_message->ANT_MESSAGE_aucExtData[3];
+
+    p_slot = slot_find(&id);
+
+    if (p_slot != NULL)
+    {
+        p_type = slot_type_get(p_slot);
+    }
+    else
+    {
+        p_type = device_type_get(id.device_type);
+
+        if (p_type == NULL)
+        {
+            m_stats.unknown_type++;
+            return;
+        }
+
+        p_slot = slot_create(p_type, &id);
+
+        if (p_slot == NULL)
+        {
+            m_stats.dropped++;
+            return;
+        }
+    }
+
+    p_slot->last_seen = m_tick;
+    p_type->evt_handler(instance_get(p_type, p_slot), p_ant_evt);
+}
+
+
+void ant_scan_demux_tick(void)
+{
+    m_tick++;
+
+    for (uint32_t i = 0; i < m_type_count; i++)
+    {
+        ant_scan_demux_type_t * p_type = m_types[i];
+
+        for (uint32_t j = 0; j < p_type->pool_size; j++)
+        {
+            ant_scan_demux_slot_t * p_slot = &p_type->p_slots[j];
+
+            if (p_slot->in_use && ((uint16_t)(m_tick - p_slot->last_seen) > m_lost_ticks))
+            {
+                slot_release(p_type, p_slot);
+            }
+        }
+    }
+}
+
+
+void * ant_scan_demux_instance_get(ant_scan_demux_id_t const * p_id)
+{
+    ant_scan_demux_slot_t * p_slot = slot_find(p_id);
+
+    if (p_slot == NULL)
+    {
+        return NULL;
+    }
+    return instance_get(slot_type_get(p_slot), p_slot);
+}
+
+
+void ant_scan_demux_stats_get(ant_scan_demux_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
@@ -0,0 +1,227 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef ANT_SCAN_DEMUX_H__
+#define ANT_SCAN_DEMUX_H__
+
+/** @file
+ *
+ * @defgroup ant_scan_demux ANT continuous scanning demultiplexer
+ * @{
+ * @ingroup ant_sdk_utils
+ * @brief Module for receiving many ANT+ sensors on one channel in continuous scanning mode.
+ *
+ * @details A channel in continuous scanning mode receives the broadcasts of all sensors in
+ *          range. The module reads the channel ID from the extended data of each received
+ *          message and passes the message to a profile instance dedicated to that sensor.
+ *
+ *          Profile instances are taken from fixed pools, one pool per device type, declared
+ *          with @ref ANT_SCAN_DEMUX_TYPE_DEF and registered with @ref ant_scan_demux_type_add.
+ *          An instance is initialized by the init handler of its pool when the first message
+ *          of a new sensor is received, and is released when the sensor has not been heard
+ *          for the configured number of ticks (see @ref ant_scan_demux_tick). Instances are
+ *          found through a hash table of channel IDs, so that the cost of dispatching a message
+ *          does not grow with the number of sensors.
+ *
+ *          The display profiles provide scan variants of their init functions
+ *          (for example, @ref ant_hrm_disp_scan_init), which set up an instance without
+ *          configuring a channel. The init handler of a pool usually calls one of them:
+ *
+ * @code
+ * static ret_code_t hrm_scan_init(void * p_instance, ant_channel_config_t const * p_channel_config)
+ * {
+ *     return ant_hrm_disp_scan_init(p_instance, p_channel_config, hrm_evt_handler);
+ * }
+ *
+ * static void hrm_scan_evt_handler(void * p_instance, ant_evt_t * p_ant_evt)
+ * {
+ *     ant_hrm_disp_evt_handler(p_instance, p_ant_evt);
+ * }
+ *
+ * ANT_SCAN_DEMUX_TYPE_DEF(m_hrm_sensors, HRM_DEVICE_TYPE, ant_hrm_profile_t, 16,
+ *                         hrm_scan_init, hrm_scan_evt_handler, NULL);
+ * @endcode
+ *
+ *          Profiles that need a control block per instance use a pool of structures that
+ *          hold both the profile and its control block.
+ *
+ * @note    The scanning channel must be configured by the application, and the extended
+ *          message data must include the channel ID
+ *          (sd_ant_lib_config_set(ANT_LIB_CONFIG_MESG_OUT_INC_DEVICE_ID)). Messages without
+ *          a channel ID are counted as unidentified and dropped.
+ *
+ * @note    The instances only receive. Messages that would be sent by a profile (page
+ *          requests, calibration requests) cannot be addressed to one sensor on a scanning
+ *          channel.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "ant_stack_handler_types.h"
+#include "ant_channel_config.h"
+#include "sdk_errors.h"
+
+#ifndef ANT_SCAN_DEMUX_HASH_BITS
+#define ANT_SCAN_DEMUX_HASH_BITS    6   ///< Number of bits of the hash table index. The table has 2^ANT_SCAN_DEMUX_HASH_BITS buckets; it should not be much smaller than the total number of instances.
+#endif
+
+#ifndef ANT_SCAN_DEMUX_TYPES_MAX
+#define ANT_SCAN_DEMUX_TYPES_MAX    4   ///< Maximum number of device types (pools) that can be registered.
+#endif
+
+/**@brief Handler for initializing a profile instance for a newly received sensor.
+ *
+ * @param[in]  p_instance       Pointer to the profile instance.
+ * @param[in]  p_channel_config Channel number of the scanning channel and channel ID of the sensor.
+ *                              The other fields are zero.
+ *
+ * @retval     NRF_SUCCESS      If the instance was initialized. Otherwise, the instance is released
+ *                              and the message is dropped.
+ */
+typedef ret_code_t (* ant_scan_demux_init_handler_t)(void                       * p_instance,
+                                                     ant_channel_config_t const * p_channel_config);
+
+/**@brief Handler for passing an ANT event to a profile instance. */
+typedef void (* ant_scan_demux_evt_handler_t)(void * p_instance, ant_evt_t * p_ant_evt);
+
+/**@brief Handler called before the instance of a sensor that is no longer received is released. */
+typedef void (* ant_scan_demux_lost_handler_t)(void * p_instance);
+
+/**@brief Channel ID of a sensor. */
+typedef struct
+{
+    uint16_t device_number;         ///< Device number.
+    uint8_t  device_type;           ///< Device type, without the pairing bit.
+    uint8_t  transmission_type;     ///< Transmission type.
+} ant_scan_demux_id_t;
+
+/**@brief Pool slot. For internal use. */
+typedef struct ant_scan_demux_slot_s ant_scan_demux_slot_t;
+
+struct ant_scan_demux_slot_s
+{
+    ant_scan_demux_slot_t * p_next;     ///< Next slot in the same hash bucket, or next free slot.
+    ant_scan_demux_id_t     id;         ///< Channel ID of the sensor using the slot.
+    uint16_t                last_seen;  ///< Tick count when the sensor was last received.
+    bool                    in_use;     ///< Whether the slot is assigned to a sensor.
+};
+
+/**@brief Profile instance pool for one device type. */
+typedef struct
+{
+    uint8_t                         device_type;    ///< Device type handled by the pool.
+    uint8_t                         pool_size;      ///< Number of instances.
+    uint16_t                        instance_size;  ///< Size of one instance, in bytes.
+    void                          * p_instances;    ///< Instance array.
+    ant_scan_demux_slot_t         * p_slots;        ///< Slot array, one slot per instance.
+    ant_scan_demux_slot_t         * p_free;         ///< List of free slots.
+    ant_scan_demux_init_handler_t   init_handler;   ///< Handler for initializing an instance.
+    ant_scan_demux_evt_handler_t    evt_handler;    ///< Handler for passing events to an instance.
+    ant_scan_demux_lost_handler_t   lost_handler;   ///< Handler called before an instance is released. Can be NULL.
+} ant_scan_demux_type_t;
+
+/**@brief Demultiplexer statistics. */
+typedef struct
+{
+    uint32_t created;       ///< Number of instances initialized for new sensors.
+    uint32_t released;      ///< Number of instances released because their sensor was not received.
+    uint32_t dropped;       ///< Number of messages dropped because the pool of their device type was full, or the instance could not be initialized.
+    uint32_t unknown_type;  ///< Number of messages dropped because no pool handles their device type.
+    uint32_t unidentified;  ///< Number of messages received without a channel ID.
+} ant_scan_demux_stats_t;
+
+/**@brief Macro for defining a profile instance pool.
+ *
+ * @param[in]  NAME             Name of the pool.
+ * @param[in]  DEVICE_TYPE      Device type handled by the pool.
+ * @param[in]  INSTANCE_TYPE    Type of the profile instances.
+ * @param[in]  POOL_SIZE        Number of instances, at most 255.
+ * @param[in]  INIT_HANDLER     Handler for initializing an instance (@ref ant_scan_demux_init_handler_t).
+ * @param[in]  EVT_HANDLER      Handler for passing events to an instance (@ref ant_scan_demux_evt_handler_t).
+ * @param[in]  LOST_HANDLER     Handler called before an instance is released (@ref ant_scan_demux_lost_handler_t), or NULL.
+ */
+#define ANT_SCAN_DEMUX_TYPE_DEF(NAME,                                   \
+                                DEVICE_TYPE,                            \
+                                INSTANCE_TYPE,                          \
+                                POOL_SIZE,                              \
+                                INIT_HANDLER,                           \
+                                EVT_HANDLER,                            \
+                                LOST_HANDLER)                           \
+static INSTANCE_TYPE            NAME##_instances[(POOL_SIZE)];          \
+static ant_scan_demux_slot_t    NAME##_slots[(POOL_SIZE)];              \
+static ant_scan_demux_type_t    NAME =                                  \
+    {                                                                   \
+        .device_type    = (DEVICE_TYPE),                                \
+        .pool_size      = (POOL_SIZE),                                  \
+        .instance_size  = sizeof(INSTANCE_TYPE),                        \
+        .p_instances    = NAME##_instances,                             \
+        .p_slots        = NAME##_slots,                                 \
+        .p_free         = NULL,                                         \
+        .init_handler   = (INIT_HANDLER),                               \
+        .evt_handler    = (EVT_HANDLER),                                \
+        .lost_handler   = (LOST_HANDLER),                               \
+    }
+
+/**@brief Function for initializing the demultiplexer.
+ *
+ * @details All registered pools are removed.
+ *
+ * @param[in]  channel_number   Number of the channel in continuous scanning mode.
+ * @param[in]  lost_ticks       Number of ticks without a message after which an instance is released.
+ *
+ * @retval     NRF_SUCCESS              If the demultiplexer was initialized.
+ * @retval     NRF_ERROR_INVALID_PARAM  If @p lost_ticks is 0 or larger than 0x7FFF.
+ */
+ret_code_t ant_scan_demux_init(uint8_t channel_number, uint16_t lost_ticks);
+
+/**@brief Function for registering a profile instance pool.
+ *
+ * @param[in]  p_type           Pool defined with @ref ANT_SCAN_DEMUX_TYPE_DEF.
+ *
+ * @retval     NRF_SUCCESS              If the pool was registered.
+ * @retval     NRF_ERROR_NO_MEM         If @ref ANT_SCAN_DEMUX_TYPES_MAX pools are already registered.
+ * @retval     NRF_ERROR_INVALID_PARAM  If a pool for the same device type is already registered.
+ */
+ret_code_t ant_scan_demux_type_add(ant_scan_demux_type_t * p_type);
+
+/**@brief Function for handling ANT events.
+ *
+ * @details Events of other channels, and events other than received messages, are ignored.
+ *
+ * @param[in]  p_ant_evt        Event received from the ANT stack.
+ */
+void ant_scan_demux_evt_handler(ant_evt_t * p_ant_evt);
+
+/**@brief Function for advancing the time base and releasing the instances of lost sensors.
+ *
+ * @details Should be called periodically, for example from an app_timer handler. It takes
+ *          time proportional to the total number of instances, and must not be called from
+ *          a context that can interrupt @ref ant_scan_demux_evt_handler.
+ */
+void ant_scan_demux_tick(void);
+
+/**@brief Function for finding the profile instance of a sensor.
+ *
+ * @param[in]  p_id             Channel ID of the sensor.
+ *
+ * @return     Pointer to the profile instance, or NULL if the sensor has no instance.
+ */
+void * ant_scan_demux_instance_get(ant_scan_demux_id_t const * p_id);
+
+/**@brief Function for reading the demultiplexer statistics.
+ *
+ * @param[out] p_stats          Statistics.
+ */
+void ant_scan_demux_stats_get(ant_scan_demux_stats_t * p_stats);
+
+#endif // ANT_SCAN_DEMUX_H__
+/** @} */
@@ -36,6 +36,9 @@
 
 #define PHYS_CH_MAX      39     /**< Maximum number of valid channels in BLE. */
 
+#define SWEEP_TICKS_PER_DWELL_UNIT  16  /**< Number of 625 us timer cycles in one RX_SWEEP dwell unit (10 ms). */
+#define SWEEP_DWELL_DEFAULT         10  /**< Default RX_SWEEP dwell time per channel, in units of 10 ms. */
+
 // Values that for now are "constants" - they could be configured by a function setting them,
 // but most of these are set by the BLE DTM standard, so changing them is not relevant.
 #define RFPHY_TEST_0X0F_REF_PATTERN  0x0f  /**<  RF-PHY test packet patterns, for the repeated octet packets. */
@@ -62,19 +65,28 @@ typedef enum
     STATE_IDLE,                                                              /**< State when system has just initialized, or current test has completed. */
     STATE_TRANSMITTER_TEST,                                                  /**< State used when a DTM Transmission test is running. */
     STATE_CARRIER_TEST,                                                      /**< State used when a DTM Carrier test is running (Vendor specific test). */
-    STATE_RECEIVER_TEST                                                      /**< State used when a DTM Receive test is running. */
+    STATE_RECEIVER_TEST,                                                     /**< State used when a DTM Receive test is running. */
+    STATE_SWEEP_TEST                                                         /**< State used when a receiver channel sweep is running (Vendor specific test). */
 } state_t;
 
 // Internal variables set as side effects of commands or events.
 static state_t           m_state = STATE_UNINITIALIZED;                      /**< Current machine state. */
-static uint16_t          m_rx_pkt_count;                                     /**< Number of valid packets received. */
+static volatile uint16_t m_rx_pkt_count;                                     /**< Number of valid packets received. */
+static volatile uint32_t m_rx_rssi_sum;                                      /**< Sum of the RSSI of the valid packets received, in -dBm. */
 static pdu_type_t        m_pdu;                                              /**< PDU to be sent. */
+static pdu_type_t        m_rx_pdu[2];                                        /**< PDUs used alternately for reception, so that the radio can receive into one while the other is checked. */
+static pdu_type_t *      mp_rx_pdu = &m_rx_pdu[0];                           /**< PDU the radio receives into. */
 static uint16_t          m_event;                                            /**< current command status - initially "ok", may be set if error detected, or to packet count. */
 static bool              m_new_event;                                        /**< Command has been processed - number of not yet reported event bytes. */
 static uint8_t           m_packet_length;                                    /**< Payload length of transmitted PDU, bits 2:7 of 16-bit dtm command. */
 static dtm_pkt_type_t    m_packet_type;                                      /**< Bits 0..1 of 16-bit transmit command, or 0xFFFFFFFF. */
 static dtm_freq_t        m_phys_ch;                                          /**< 0..39 physical channel number (base 2402 MHz, Interval 2 MHz), bits 8:13 of 16-bit dtm command. */
 static uint32_t          m_current_time = 0;                                 /**< Counter for interrupts from timer to ensure that the 2 bytes forming a DTM command are received within the time window. */
+static dtm_freq_t        m_sweep_last_ch;                                    /**< Last channel of the ongoing receiver channel sweep. */
+static uint32_t          m_sweep_ticks_left;                                 /**< Timer cycles left on the current channel of the sweep. */
+static uint16_t          m_sweep_report[PHYS_CH_MAX + 1];                    /**< Sweep result table, one report word per channel. */
+static uint8_t           m_sweep_report_count;                               /**< Number of valid words in the sweep result table. */
+static uint8_t           m_sweep_report_index;                               /**< Next word of the sweep result table to be returned by dtm_event_get(). */
 
 // Nordic specific configuration values (not defined by BLE standard).
 // Definition of initial values found in ble_dtm.h
@@ -97,19 +109,22 @@ static uint32_t          m_crc_poly          = 0x0000065B;                   /**
 static uint32_t          m_crc_init          = 0x00555555;                   /**< Initial value for CRC calculation. */
 static uint8_t           m_radio_mode        = RADIO_MODE_MODE_Ble_1Mbit;    /**< nRF51 specific radio mode vale. */
 static uint32_t          m_txIntervaluS      = 625;                          /**< Time between start of Tx packets (in uS). */
+static uint32_t          m_sweep_dwell       = SWEEP_DWELL_DEFAULT;          /**< Receiver sweep dwell time per channel, in units of 10 ms. */
 
 
 /**@brief Function for verifying that a received PDU has the expected structure and content.
+ *
+ * @param[in] p_pdu  Received PDU.
  */
-static bool check_pdu(void)
+static bool check_pdu(pdu_type_t const * p_pdu)
 {
     uint8_t        k;                // Byte pointer for running through PDU payload
     uint8_t        pattern;          // Repeating octet value in payload
     dtm_pkt_type_t pdu_packet_type;  // Note: PDU packet type is a 4-bit field in HCI, but 2 bits in BLE DTM
     uint8_t        length;
 
-    pdu_packet_type = (dtm_pkt_type_t)(m_pdu.content[DTM_HEADER_OFFSET] & 0x0F);
-    length          = m_pdu.content[DTM_LENGTH_OFFSET];
+    pdu_packet_type = (dtm_pkt_type_t)(p_pdu->content[DTM_HEADER_OFFSET] & 0x0F);
+    length          = p_pdu->content[DTM_LENGTH_OFFSET];
 
     if ((pdu_packet_type > (dtm_pkt_type_t)PACKET_TYPE_MAX) || (length > DTM_PAYLOAD_MAX_SIZE))
     {
@@ -119,7 +134,7 @@ static bool check_pdu(void)
     if (pdu_packet_type == DTM_PKT_PRBS9)
     {
         // Payload does not consist of one repeated octet; must compare ir with entire block into
-        return (memcmp(m_pdu.content+DTM_HEADER_SIZE, m_prbs_content, length) == 0);
+        return (memcmp(p_pdu->content+DTM_HEADER_SIZE, m_prbs_content, length) == 0);
     }
 
     if (pdu_packet_type == DTM_PKT_0X0F)
@@ -134,7 +149,7 @@ static bool check_pdu(void)
     for (k = 0; k < length; k++)
     {
         // Check repeated pattern filling the PDU payload 
-        if (m_pdu.content[k + 2] != pattern)
+        if (p_pdu->content[k + 2] != pattern)
         {
             return false;
         }
@@ -148,6 +163,9 @@ static bool check_pdu(void)
  */
 static void radio_reset(void)
 {
+    NVIC_DisableIRQ(RADIO_IRQn);
+    NRF_RADIO->INTENCLR = RADIO_INTENCLR_END_Msk;
+
     NRF_PPI->CHENCLR = PPI_CHENCLR_CH0_Msk | PPI_CHENCLR_CH1_Msk;
 
     NRF_RADIO->SHORTS          = 0;
@@ -162,8 +180,11 @@ static void radio_reset(void)
     NRF_RADIO->EVENTS_DISABLED = 0;
     NRF_RADIO->TASKS_RXEN      = 0;
     NRF_RADIO->TASKS_TXEN      = 0;
+    NRF_RADIO->EVENTS_END      = 0;
+    NVIC_ClearPendingIRQ(RADIO_IRQn);
 
     m_rx_pkt_count = 0;
+    m_rx_rssi_sum  = 0;
 }
 
 
@@ -231,6 +252,9 @@ static uint32_t radio_init(void)
 /**@brief Function for preparing the radio. At start of each test: Turn off RF, clear interrupt flags of RF, initialize the radio
  *        at given RF channel.
  *
+ * @details In rx mode, the radio is re-armed by shortcuts after every packet, and the packets are
+ *          counted in the RADIO interrupt handler. The RSSI is sampled for every packet.
+ *
  *@param[in] rx     boolean indicating if radio should be prepared in rx mode (true) or tx mode.
  */
 static void radio_prepare(bool rx)
@@ -244,19 +268,33 @@ static void radio_prepare(bool rx)
     NRF_RADIO->CRCPOLY      = m_crc_poly;
     NRF_RADIO->CRCINIT      = m_crc_init;
     NRF_RADIO->FREQUENCY    = (m_phys_ch << 1) + 2;                  // Actual frequency (MHz): 2400 + register value
-    NRF_RADIO->PACKETPTR    = (uint32_t)&m_pdu;                      // Setting packet pointer will start the radio
     NRF_RADIO->EVENTS_READY = 0;
     NRF_RADIO->SHORTS       = (1 << RADIO_SHORTS_READY_START_Pos) |  // Shortcut between READY event and START task
                               (1 << RADIO_SHORTS_END_DISABLE_Pos);   // Shortcut between END event and DISABLE task
 
     if (rx)
     {
+        // Zero fill all pdu fields to avoid stray data from earlier test run
+        memset(m_rx_pdu, 0, sizeof(m_rx_pdu));
+        mp_rx_pdu            = &m_rx_pdu[0];
+        NRF_RADIO->PACKETPTR = (uint32_t)mp_rx_pdu;
+
+        // Restart reception after every packet, and sample the RSSI of every packet
+        NRF_RADIO->SHORTS   |= (1 << RADIO_SHORTS_DISABLED_RXEN_Pos)    |
+                               (1 << RADIO_SHORTS_ADDRESS_RSSISTART_Pos) |
+                               (1 << RADIO_SHORTS_DISABLED_RSSISTOP_Pos);
+
         NRF_RADIO->EVENTS_END = 0;
+        NRF_RADIO->INTENSET   = RADIO_INTENSET_END_Msk;
+        NVIC_ClearPendingIRQ(RADIO_IRQn);
+        NVIC_EnableIRQ(RADIO_IRQn);
+
         NRF_RADIO->TASKS_RXEN = 1;  // shorts will start radio in RX mode when it is ready
     }
     else // tx
     {
-        NRF_RADIO->TXPOWER = m_tx_power;
+        NRF_RADIO->PACKETPTR = (uint32_t)&m_pdu;
+        NRF_RADIO->TXPOWER   = m_tx_power;
     }
 }
 
@@ -302,8 +340,8 @@ static uint32_t timer_init(void)
     mp_timer->EVENTS_COMPARE[2] = 0;
     mp_timer->EVENTS_COMPARE[3] = 0;
 
-    // Timer is polled, but enable the compare0 interrupt in order to wakeup from CPU sleep
-    mp_timer->INTENSET    = TIMER_INTENSET_COMPARE0_Msk;
+    // Timer is polled, but enable the compare interrupts in order to wakeup from CPU sleep
+    mp_timer->INTENSET    = TIMER_INTENSET_COMPARE0_Msk | TIMER_INTENSET_COMPARE1_Msk;
     mp_timer->SHORTS      = 1 << TIMER_SHORTS_COMPARE0_CLEAR_Pos;  // Clear the count every time timer reaches the CCREG0 count
     mp_timer->PRESCALER   = 4;                                     // Input clock is 16MHz, timer clock = 2 ^ prescale -> interval 1us
     mp_timer->CC[0]       = m_txIntervaluS;                        // 625uS with 1MHz clock to the timer
@@ -314,6 +352,61 @@ static uint32_t timer_init(void)
 }
 
 
+/**@brief Function for building the sweep report word of the channel that has been swept.
+ */
+static uint16_t sweep_report_word(void)
+{
+    uint32_t count = m_rx_pkt_count;
+    uint32_t rssi  = DTM_SWEEP_RSSI_Msk;
+
+    if (count != 0)
+    {
+        rssi = (m_rx_rssi_sum / count) >> 1;
+    }
+    if (count > (DTM_SWEEP_COUNT_Msk >> DTM_SWEEP_COUNT_Pos))
+    {
+        count = DTM_SWEEP_COUNT_Msk >> DTM_SWEEP_COUNT_Pos;
+    }
+    if (rssi > DTM_SWEEP_RSSI_Msk)
+    {
+        rssi = DTM_SWEEP_RSSI_Msk;
+    }
+
+    return (uint16_t)(LE_PACKET_REPORTING_EVENT | (count << DTM_SWEEP_COUNT_Pos) | rssi);
+}
+
+
+/**@brief Function for advancing the receiver channel sweep. Called every 625 us timer cycle.
+ *        At the end of the dwell time, the result of the channel is stored, and reception moves
+ *        to the next channel. After the last channel, the test ends and the result table is
+ *        reported through dtm_event_get().
+ */
+static void sweep_tick(void)
+{
+    if ((m_state != STATE_SWEEP_TEST) || (--m_sweep_ticks_left != 0))
+    {
+        return;
+    }
+
+    NVIC_DisableIRQ(RADIO_IRQn);
+    m_sweep_report[m_phys_ch] = sweep_report_word();
+
+    if (m_phys_ch < m_sweep_last_ch)
+    {
+        m_phys_ch++;
+        m_sweep_ticks_left = m_sweep_dwell * SWEEP_TICKS_PER_DWELL_UNIT;
+        radio_reset();
+        radio_prepare(RX_MODE);
+    }
+    else
+    {
+        dtm_test_done();
+        m_sweep_report_count = m_sweep_last_ch + 1;
+        m_sweep_report_index = 0;
+    }
+}
+
+
 /**@brief Function for handling vendor specific commands.
  *        Used when packet type is set to Vendor specific.
  *        The length field is used for encoding vendor specific command.
@@ -364,6 +457,32 @@ static uint32_t dtm_vendor_specific_pkt(uint32_t vendor_cmd, dtm_freq_t vendor_o
                 return DTM_ERROR_ILLEGAL_CONFIGURATION;
             }
             break;
+
+#if (DTM_RX_SWEEP_ENABLED == 1)
+        case RX_SWEEP:
+            // Any result table not yet reported is replaced by the new sweep.
+            m_sweep_report_count = 0;
+            m_sweep_last_ch      = vendor_option;
+            m_sweep_ticks_left   = m_sweep_dwell * SWEEP_TICKS_PER_DWELL_UNIT;
+            m_phys_ch            = 0;
+            radio_prepare(RX_MODE);
+            m_state              = STATE_SWEEP_TEST;
+            break;
+
+        case SET_SWEEP_DWELL:
+            if (vendor_option == 0)
+            {
+                return DTM_ERROR_ILLEGAL_CONFIGURATION;
+            }
+            m_sweep_dwell = vendor_option;
+            break;
+#else
+        case RX_SWEEP:
+        case SET_SWEEP_DWELL:
+            // dtm_wait() is not called periodically, so a sweep would never advance.
+            m_event = LE_TEST_STATUS_EVENT_ERROR;
+            return DTM_ERROR_ILLEGAL_CONFIGURATION;
+#endif // DTM_RX_SWEEP_ENABLED
     }
     // Event code is unchanged, successful
     return DTM_SUCCESS;
@@ -393,43 +512,58 @@ uint32_t dtm_wait(void)
 
     for (;;)
     {
-        // Event may be the reception of a packet - 
-        // handle radio first, to give it highest priority:
-        if (NRF_RADIO->EVENTS_END != 0)
-        {
-            NRF_RADIO->EVENTS_END = 0;
-            NVIC_ClearPendingIRQ(RADIO_IRQn);
-
-            if (m_state == STATE_RECEIVER_TEST)
-            {
-                NRF_RADIO->TASKS_RXEN = 1;
-                if ((NRF_RADIO->CRCSTATUS == 1) && check_pdu())
-                {
-                    // Count the number of successfully received packets
-                    m_rx_pkt_count++;
-                }
-                // Note that failing packets are simply ignored (CRC or contents error).
-
-                // Zero fill all pdu fields to avoid stray data
-                memset(&m_pdu, 0, DTM_PDU_MAX_MEMORY_SIZE);
-            }
-            // If no RECEIVER_TEST is running, ignore incoming packets (but do clear IRQ!)
-        }
-
-        // Check for timeouts:
+        // Received packets are handled in RADIO_IRQHandler(), only timeouts are handled here.
         if (mp_timer->EVENTS_COMPARE[0] != 0)
         {
             mp_timer->EVENTS_COMPARE[0] = 0;
+            NVIC_ClearPendingIRQ(m_timer_irq);
         }
         else if (mp_timer->EVENTS_COMPARE[1] != 0)
         {
             // Reset timeout event flag for next iteration.
             mp_timer->EVENTS_COMPARE[1] = 0;
             NVIC_ClearPendingIRQ(m_timer_irq);
+            sweep_tick();
             return ++m_current_time;
         }
+        else
+        {
+            // Sleep until the next timer event, packet or other interrupt. An event occurring
+            // after the checks above sets the event register, so the wake-up is not lost.
+            __WFE();
+        }
+    }
+}
+
+
+/**@brief Function for handling the RADIO END event of a receiver test or receiver sweep.
+ *
+ * @details The radio restarts reception by itself through the DISABLED_RXEN shortcut. The packet
+ *          pointer is switched to the other PDU buffer before the radio has ramped up, so the
+ *          received PDU can be checked while the next packet is received.
+ */
+void RADIO_IRQHandler(void)
+{
+    pdu_type_t * p_pdu;
+
+    if (NRF_RADIO->EVENTS_END != 0)
+    {
+        NRF_RADIO->EVENTS_END = 0;
 
-        // Other events: No processing
+        p_pdu                = mp_rx_pdu;
+        mp_rx_pdu            = (p_pdu == &m_rx_pdu[0]) ? &m_rx_pdu[1] : &m_rx_pdu[0];
+        NRF_RADIO->PACKETPTR = (uint32_t)mp_rx_pdu;
+
+        if ((NRF_RADIO->CRCSTATUS == 1) && check_pdu(p_pdu))
+        {
+            // Count the number of successfully received packets
+            m_rx_pkt_count++;
+            m_rx_rssi_sum += NRF_RADIO->RSSISAMPLE & RADIO_RSSISAMPLE_RSSISAMPLE_Msk;
+        }
+        // Note that failing packets are simply ignored (CRC or contents error).
+
+        // Zero fill all pdu fields to avoid stray data
+        memset(p_pdu, 0, DTM_PDU_MAX_MEMORY_SIZE);
     }
 }
 
@@ -457,6 +591,7 @@ uint32_t dtm_cmd(dtm_cmd_t cmd, dtm_freq_t freq, uint32_t length, dtm_pkt_type_t
     if (cmd == LE_RESET)
     {
         // Note that timer will continue running after a reset
+        m_sweep_report_count = 0;
         dtm_test_done();
         return DTM_SUCCESS;
     }
@@ -494,8 +629,6 @@ uint32_t dtm_cmd(dtm_cmd_t cmd, dtm_freq_t freq, uint32_t length, dtm_pkt_type_t
 
     if (cmd == LE_RECEIVER_TEST)
     {
-        // Zero fill all pdu fields to avoid stray data from earlier test run
-        memset(&m_pdu, 0, DTM_PDU_MAX_MEMORY_SIZE);
         radio_prepare(RX_MODE);                      // Reinitialize "everything"; RF interrupts OFF
         m_state = STATE_RECEIVER_TEST;
         return DTM_SUCCESS;
@@ -557,6 +690,13 @@ uint32_t dtm_cmd(dtm_cmd_t cmd, dtm_freq_t freq, uint32_t length, dtm_pkt_type_t
 bool dtm_event_get(dtm_event_t *p_dtm_event)
 {
     bool was_new = m_new_event;
+
+    if (!was_new && (m_sweep_report_index < m_sweep_report_count))
+    {
+        // Command events are reported first, then the sweep result table one word per call.
+        *p_dtm_event = m_sweep_report[m_sweep_report_index++];
+        return true;
+    }
     // mark the current event as retrieved
     m_new_event  = false;
     *p_dtm_event = m_event;
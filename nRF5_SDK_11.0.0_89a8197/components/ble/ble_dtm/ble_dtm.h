@@ -16,6 +16,9 @@
  * @{
  * @ingroup ble_sdk_lib
  * @brief Module for testing RF/PHY using DTM commands.
+ *
+ * @details Received packets are counted in RADIO_IRQHandler(), which is defined by this module.
+ *          The radio is re-armed for reception by shortcuts, without CPU involvement.
  */
 
 #ifndef BLE_DTM_H__
@@ -46,6 +49,25 @@ typedef uint32_t dtm_cmd_t;                                             /**< DTM
 #define CARRIER_TEST_STUDIO             1                               /**< nRFgo Studio uses value 1 in length field, to indicate a constant, unmodulated carrier until LE_TEST_END or LE_RESET */
 #define SET_TX_POWER                    2                               /**< Set transmission power, value -40..+4 dBm in steps of 4 */
 #define SELECT_TIMER                    3                               /**< Select on of the 16 MHz timers 0, 1 or 2 */
+#define RX_SWEEP                        4                               /**< Receive on channels 0 up to the channel given as value, for one dwell time each. Ends by itself, after which one sweep report word per channel is returned by dtm_event_get() */
+#define SET_SWEEP_DWELL                 5                               /**< Set the RX_SWEEP dwell time per channel, value 1..39 in units of 10 ms (default 100 ms) */
+
+// The receiver sweep advances in dtm_wait(), which must then be called every 625 us while the sweep
+// runs. The serialization connectivity firmware blocks on UART reception between calls, so it
+// rejects RX_SWEEP and SET_SWEEP_DWELL with DTM_ERROR_ILLEGAL_CONFIGURATION.
+#ifndef DTM_RX_SWEEP_ENABLED
+#ifdef SER_CONNECTIVITY
+#define DTM_RX_SWEEP_ENABLED            0                               /**< Receiver sweep not supported by the serialization connectivity DTM loop. */
+#else
+#define DTM_RX_SWEEP_ENABLED            1                               /**< Set to 0 to reject the receiver sweep commands. */
+#endif
+#endif
+
+// Sweep report word: LE_PACKET_REPORTING_EVENT | packet count | mean RSSI.
+// The packet count saturates at 511. The RSSI is given in units of -2 dBm, 0x3F if no packet was received.
+#define DTM_SWEEP_COUNT_Pos             6                               /**< Position of the packet count in a sweep report word. */
+#define DTM_SWEEP_COUNT_Msk             (0x1FF << DTM_SWEEP_COUNT_Pos)  /**< Mask of the packet count in a sweep report word. */
+#define DTM_SWEEP_RSSI_Msk              0x3F                            /**< Mask of the mean RSSI in a sweep report word. */
 
 #define LE_PACKET_REPORTING_EVENT       0x8000                          /**< DTM Packet reporting event, returned by the device to the tester. */
 #define LE_TEST_STATUS_EVENT_SUCCESS    0x0000                          /**< DTM Status event, indicating success. */
@@ -84,9 +106,11 @@ typedef uint32_t dtm_pkt_type_t;                                        /**< Typ
 uint32_t dtm_init(void);
 
 
-/**@brief Function for giving control to dtmlib for handling timer and radio events.
- *        Will return to caller at 625us intervals or whenever another event than radio occurs
- *        (such as UART input). Function will put MCU to sleep between events.
+/**@brief Function for giving control to dtmlib for handling timer events.
+ *        Will return to caller at 625us intervals. Function will put MCU to sleep between events.
+ *        Received packets are handled in interrupt context, and the receiver sweep advances
+ *        to the next channel in this function, so it must be called without gaps while a
+ *        sweep runs.
  *
  * @return      Time counter, incremented every 625 us.
  */
@@ -107,6 +131,9 @@ uint32_t dtm_cmd(dtm_cmd_t cmd, dtm_freq_t freq, uint32_t length, dtm_pkt_type_t
 
 
 /**@brief Function for reading the result of a DTM command
+ *
+ * @details When a receiver sweep has completed, the following calls return the sweep report
+ *          words, one per channel, in channel order.
  *
  * @param[out]  p_dtm_event   Pointer to buffer for 16 bit event code according to DTM standard.
  * 
@@ -0,0 +1,285 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_radio_job.h"
+#include <stdlib.h>
+#include <string.h>
+#include "nrf_error.h"
+#include "app_timer.h"
+#include "app_util_platform.h"
+
+
+static ble_radio_job_t        * mp_head;                            /**< First job in the queue. */
+static ble_radio_job_t        * mp_tail;                            /**< Last job in the queue. */
+static uint32_t                 m_guard_ticks;                      /**< Margin kept before the next radio event. */
+static uint32_t                 m_idle_ticks;                       /**< Time without radio events after which the radio is considered idle. */
+static volatile bool            m_radio_active;                     /**< Current radio state. */
+static volatile bool            m_radio_idle;                       /**< True when no radio events are expected. */
+static volatile bool            m_window_fresh;                     /**< True until the first job step of the current gap has run. */
+static volatile uint32_t        m_active_count;                     /**< Number of radio Active events, used to detect pre-emption. */
+static volatile uint32_t        m_inactive_at;                      /**< Time of the last radio Inactive event. */
+static uint32_t                 m_gaps[BLE_RADIO_JOB_GAP_HISTORY];  /**< Most recent radio-idle gaps. */
+static uint8_t                  m_gap_idx;                          /**< Next position in m_gaps. */
+static volatile uint32_t        m_gap_predicted;                    /**< Shortest gap in m_gaps. */
+static ble_radio_job_stats_t    m_stats;
+
+
+static uint32_t ticks_now(void)
+{
+    uint32_t ticks = 0;
+    (void)app_timer_cnt_get(&ticks);
+    return ticks;
+}
+
+
+static uint32_t ticks_since(uint32_t from)
+{
+    uint32_t diff = 0;
+    (void)app_timer_cnt_diff_compute(ticks_now(), from, &diff);
+    return diff;
+}
+
+
+/**@brief Function for recording a measured gap and updating the prediction.
+ *
+ * @details The shortest of the recent gaps is used, so a change of connection interval or an
+ *          extra radio event makes the prediction more conservative immediately.
+ */
+static void gap_record(uint32_t gap)
+{
+    uint32_t min_gap = UINT32_MAX;
+    uint8_t  i;
+
+    m_gaps[m_gap_idx] = gap;
+    m_gap_idx         = (m_gap_idx + 1) % BLE_RADIO_JOB_GAP_HISTORY;
+
+    for (i = 0; i < BLE_RADIO_JOB_GAP_HISTORY; i++)
+    {
+        if ((m_gaps[i] != 0) && (m_gaps[i] < min_gap))
+        {
+            min_gap = m_gaps[i];
+        }
+    }
+
+    m_gap_predicted = min_gap;
+}
+
+
+static uint32_t gap_budget(void)
+{
+    return (m_gap_predicted > m_guard_ticks) ? (m_gap_predicted - m_guard_ticks) : 0;
+}
+
+
+void ble_radio_job_init(uint32_t guard_ticks, uint32_t idle_ticks)
+{
+    mp_head         = NULL;
+    mp_tail         = NULL;
+    m_guard_ticks   = guard_ticks;
+    m_idle_ticks    = idle_ticks;
+    m_radio_active  = false;
+    m_radio_idle    = true;
+    m_window_fresh  = true;
+    m_active_count  = 0;
+    m_gap_idx       = 0;
+    m_gap_predicted = 0;
+
+    memset(m_gaps, 0, sizeof(m_gaps));
+    memset(&m_stats, 0, sizeof(m_stats));
+}
+
+
+void ble_radio_job_on_radio_evt(bool radio_active)
+{
+    if (radio_active)
+    {
+        if (!m_radio_idle && !m_radio_active)
+        {
+            uint32_t gap = ticks_since(m_inactive_at);
+            if (gap < m_idle_ticks)
+            {
+                gap_record(gap);
+            }
+        }
+        m_radio_active = true;
+        m_radio_idle   = false;
+        m_active_count++;
+    }
+    else
+    {
+        m_inactive_at  = ticks_now();
+        m_radio_active = false;
+        m_window_fresh = true;
+    }
+}
+
+
+uint32_t ble_radio_job_schedule(ble_radio_job_t * p_job)
+{
+    if ((p_job == NULL) || (p_job->handler == NULL))
+    {
+        return NRF_ERROR_NULL;
+    }
+
+    p_job->p_next    = NULL;
+    p_job->started   = false;
+    p_job->queued_at = ticks_now();
+
+    CRITICAL_REGION_ENTER();
+    if (mp_tail == NULL)
+    {
+        mp_head = p_job;
+    }
+    else
+    {
+        mp_tail->p_next = p_job;
+    }
+    mp_tail = p_job;
+    CRITICAL_REGION_EXIT();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t ble_radio_job_window_remaining(void)
+{
+    uint32_t remaining;
+
+    CRITICAL_REGION_ENTER();
+    if (m_radio_active)
+    {
+        remaining = 0;
+    }
+    else if (m_radio_idle || (m_gap_predicted == 0))
+    {
+        remaining = UINT32_MAX;
+    }
+    else
+    {
+        uint32_t elapsed = ticks_since(m_inactive_at);
+
+        if (elapsed >= m_idle_ticks)
+        {
+            // The expected radio event did not come, for example because the link was closed.
+            m_radio_idle = true;
+            remaining    = UINT32_MAX;
+        }
+        else
+        {
+            uint32_t budget = gap_budget();
+            remaining       = (elapsed < budget) ? (budget - elapsed) : 0;
+        }
+    }
+    CRITICAL_REGION_EXIT();
+
+    return remaining;
+}
+
+
+void ble_radio_job_execute(void)
+{
+    for (;;)
+    {
+        ble_radio_job_t * p_job;
+        uint32_t          remaining;
+        uint32_t          active_count;
+        bool              fits;
+        bool              done;
+
+        CRITICAL_REGION_ENTER();
+        p_job = mp_head;
+        CRITICAL_REGION_EXIT();
+
+        if (p_job == NULL)
+        {
+            return;
+        }
+
+        remaining = ble_radio_job_window_remaining();
+        if (remaining == 0)
+        {
+            return;
+        }
+
+        // A job that is longer than any gap would never fit, so it is started at the beginning
+        // of a gap instead of being starved.
+        fits = (remaining == UINT32_MAX)        ||
+               (p_job->duration <= remaining)   ||
+               (m_window_fresh && (p_job->duration > gap_budget()));
+        if (!fits)
+        {
+            return;
+        }
+
+        if (!p_job->started)
+        {
+            uint32_t deferred = ticks_since(p_job->queued_at);
+
+            p_job->started         = true;
+            m_stats.deferred_total += deferred;
+            if (deferred > m_stats.deferred_max)
+            {
+                m_stats.deferred_max = deferred;
+            }
+        }
+
+        m_window_fresh = false;
+        active_count   = m_active_count;
+
+        // The job is taken off the queue while its handler runs, so the handler can schedule it,
+        // or other jobs, again without corrupting the list.
+        CRITICAL_REGION_ENTER();
+        mp_head = p_job->p_next;
+        if (mp_head == NULL)
+        {
+            mp_tail = NULL;
+        }
+        CRITICAL_REGION_EXIT();
+
+        done = p_job->handler(p_job->p_context);
+
+        m_stats.steps_run++;
+        if (active_count != m_active_count)
+        {
+            m_stats.steps_preempted++;
+        }
+
+        if (!done)
+        {
+            // A job that was scheduled again by its handler is already queued (started is
+            // cleared by ble_radio_job_schedule). Otherwise it goes back to the head of the queue.
+            CRITICAL_REGION_ENTER();
+            if (p_job->started)
+            {
+                p_job->p_next = mp_head;
+                mp_head       = p_job;
+                if (mp_tail == NULL)
+                {
+                    mp_tail = p_job;
+                }
+            }
+            CRITICAL_REGION_EXIT();
+
+            // Return to the main loop; the job is resumed on the next call.
+            return;
+        }
+
+        m_stats.jobs_completed++;
+    }
+}
+
+
+void ble_radio_job_stats_get(ble_radio_job_stats_t * p_stats)
+{
+    *p_stats               = m_stats;
+    p_stats->gap_predicted = m_gap_predicted;
+}
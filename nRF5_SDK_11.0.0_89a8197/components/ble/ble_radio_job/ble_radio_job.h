@@ -0,0 +1,127 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup ble_radio_job Radio-aware Job Scheduler
+ * @{
+ * @ingroup ble_sdk_lib
+ * @brief Module for running CPU-heavy work in the gaps between radio events.
+ *
+ * @details The module learns the length of the radio-idle gaps from Radio Notification events
+ *          and runs queued jobs only when their estimated duration fits in the remaining part of
+ *          the current gap. When no radio activity has been seen for a while, jobs run without
+ *          restriction.
+ *
+ *          Feed the module from the @ref ble_radio_notification event handler by calling
+ *          @ref ble_radio_job_on_radio_evt, and call @ref ble_radio_job_execute from the main loop.
+ *
+ *          Long jobs can be split into steps: the job handler returns false to be resumed in a
+ *          later gap. Handlers can check @ref ble_radio_job_window_remaining to yield when the gap
+ *          is about to end. When a radio event starts while a job is running, the job is counted
+ *          as pre-empted.
+ *
+ * @note All time values are in app_timer ticks. The app_timer module must be initialized.
+ */
+
+#ifndef BLE_RADIO_JOB_H__
+#define BLE_RADIO_JOB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**@brief Number of radio-idle gaps used to predict the next gap. */
+#define BLE_RADIO_JOB_GAP_HISTORY   4
+
+/**@brief Job handler type.
+ *
+ * @param[in] p_context  Context pointer given in the job structure.
+ *
+ * @retval true   If the job is complete.
+ * @retval false  If the job must be resumed in a later gap.
+ */
+typedef bool (*ble_radio_job_handler_t)(void * p_context);
+
+/**@brief Job structure. The memory must be kept by the application until the job completes. */
+typedef struct ble_radio_job_s
+{
+    ble_radio_job_handler_t  handler;        /**< Job handler. */
+    void                   * p_context;      /**< Context passed to the handler. */
+    uint32_t                 duration;       /**< Estimated duration of one handler call, in ticks. */
+    uint32_t                 queued_at;      /**< Internal: time the job was scheduled. */
+    bool                     started;        /**< Internal: set when the first step has run. */
+    struct ble_radio_job_s * p_next;         /**< Internal: next job in the queue. */
+} ble_radio_job_t;
+
+/**@brief Scheduler statistics. */
+typedef struct
+{
+    uint32_t jobs_completed;    /**< Number of completed jobs. */
+    uint32_t steps_run;         /**< Number of handler calls. */
+    uint32_t steps_preempted;   /**< Number of handler calls during which a radio event started. */
+    uint32_t deferred_total;    /**< Sum of the time jobs waited in the queue before their first step, in ticks. */
+    uint32_t deferred_max;      /**< Longest time a job waited in the queue before its first step, in ticks. */
+    uint32_t gap_predicted;     /**< Currently predicted radio-idle gap, in ticks. */
+} ble_radio_job_stats_t;
+
+/**@brief Function for initializing the module.
+ *
+ * @param[in] guard_ticks  Safety margin kept free before the predicted start of the next radio
+ *                         event.
+ * @param[in] idle_ticks   Time without a radio event after which the radio is considered idle
+ *                         and jobs run without restriction.
+ */
+void ble_radio_job_init(uint32_t guard_ticks, uint32_t idle_ticks);
+
+/**@brief Function for passing a Radio Notification event to the module.
+ *
+ * @param[in] radio_active  State received in the @ref ble_radio_notification_evt_handler_t.
+ */
+void ble_radio_job_on_radio_evt(bool radio_active);
+
+/**@brief Function for adding a job to the end of the queue.
+ *
+ * @details A job handler can schedule its own job, or other jobs, again. A job must not be
+ *          scheduled while it is waiting in the queue.
+ *
+ * @param[in] p_job  Job to schedule. The handler and duration fields must be set.
+ *
+ * @retval NRF_SUCCESS              If the job was queued.
+ * @retval NRF_ERROR_NULL           If p_job or its handler is NULL.
+ */
+uint32_t ble_radio_job_schedule(ble_radio_job_t * p_job);
+
+/**@brief Function for running the jobs that fit in the current radio-idle gap.
+ *
+ * @details Jobs are run in order. The first job that does not fit in the remaining gap blocks the
+ *          jobs behind it, except at the start of a gap when the job is longer than any
+ *          predicted gap: then it runs anyway so it is not starved. When a job handler returns
+ *          false, the function returns and the job is resumed on the next call. Call this
+ *          function from the main loop.
+ */
+void ble_radio_job_execute(void);
+
+/**@brief Function for getting the time left before the next predicted radio event.
+ *
+ * @return Remaining ticks, 0 while the radio is active, or UINT32_MAX if the radio is idle.
+ */
+uint32_t ble_radio_job_window_remaining(void);
+
+/**@brief Function for getting the scheduler statistics.
+ *
+ * @param[out] p_stats  Pointer to the structure to fill.
+ */
+void ble_radio_job_stats_get(ble_radio_job_stats_t * p_stats);
+
+#endif // BLE_RADIO_JOB_H__
+
+/** @} */
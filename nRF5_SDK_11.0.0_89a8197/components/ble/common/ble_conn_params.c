@@ -17,6 +17,10 @@
 #include "app_timer.h"
 #include "ble_srv_common.h"
 #include "app_util.h"
+#ifdef BLE_EVT_OBSERVERS_ENABLED
+#include "ble_evt_observer.h"
+#include "ble_ranges.h"
+#endif // BLE_EVT_OBSERVERS_ENABLED
 
 
 static ble_conn_params_init_t m_conn_params_config;     /**< Configuration as specified by the application. */
@@ -291,6 +295,31 @@ void ble_conn_params_on_ble_evt(ble_evt_t * p_ble_evt)
 }
 
 
+#ifdef BLE_EVT_OBSERVERS_ENABLED
+static void ble_evt_observer_handler(ble_evt_t * p_ble_evt, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+    ble_conn_params_on_ble_evt(p_ble_evt);
+}
+
+
+// Registered separately for GAP and GATTS events, so that GATTC events are not passed to the module.
+BLE_EVT_OBSERVER_REGISTER(m_gap_observer,
+                          BLE_GAP_EVT_BASE,
+                          BLE_GAP_EVT_LAST,
+                          BLE_CONN_PARAMS_BLE_OBSERVER_PRIO,
+                          ble_evt_observer_handler,
+                          NULL);
+
+BLE_EVT_OBSERVER_REGISTER(m_gatts_observer,
+                          BLE_GATTS_EVT_BASE,
+                          BLE_GATTS_EVT_LAST,
+                          BLE_CONN_PARAMS_BLE_OBSERVER_PRIO,
+                          ble_evt_observer_handler,
+                          NULL);
+#endif // BLE_EVT_OBSERVERS_ENABLED
+
+
 uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t * new_params)
 {
     uint32_t err_code;
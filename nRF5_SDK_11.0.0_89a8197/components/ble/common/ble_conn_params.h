@@ -25,6 +25,10 @@
 #include "ble.h"
 #include "ble_srv_common.h"
 
+#ifndef BLE_CONN_PARAMS_BLE_OBSERVER_PRIO
+#define BLE_CONN_PARAMS_BLE_OBSERVER_PRIO   1   /**< Priority of the BLE event observers of the module (see @ref ble_evt_observer). */
+#endif
+
 /**@brief Connection Parameters Module event type. */
 typedef enum
 {
@@ -102,6 +106,10 @@ uint32_t ble_conn_params_change_conn_params(ble_gap_conn_params_t *new_params);
  *
  * @details Handles all events from the BLE stack that are of interest to this module.
  *
+ * @note    When BLE_EVT_OBSERVERS_ENABLED is defined, the module registers itself as a BLE event
+ *          observer, and receives its events from @ref ble_evt_observers_dispatch. The
+ *          application must then not call this function.
+ *
  * @param[in]   p_ble_evt  The event received from the BLE stack.
  */
 void ble_conn_params_on_ble_evt(ble_evt_t * p_ble_evt);
@@ -0,0 +1,152 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "ble_evt_observer.h"
+#include <stdbool.h>
+#include "ble_ranges.h"
+#include "nrf_error.h"
+#include "sdk_common.h"
+
+
+// Register the section 'ble_evt_observers'.
+//lint -save -e19
+NRF_SECTION_VARS_REGISTER_SECTION(ble_evt_observers);
+//lint -restore
+
+// Declare symbols into the 'ble_evt_observers' section.
+NRF_SECTION_VARS_REGISTER_SYMBOLS(ble_evt_observer_t, ble_evt_observers);
+//lint -esym(526,ble_evt_observersBase)
+//lint -esym(526,ble_evt_observersLimit)
+
+#define OBSERVER_COUNT      NRF_SECTION_VARS_COUNT(ble_evt_observer_t, ble_evt_observers)
+#define OBSERVER_GET(i)     NRF_SECTION_VARS_GET((i), ble_evt_observer_t, ble_evt_observers)
+
+
+/**@brief Event groups, in the order of their event ID ranges. */
+typedef enum
+{
+    EVT_GROUP_COMMON,
+    EVT_GROUP_GAP,
+    EVT_GROUP_GATTC,
+    EVT_GROUP_GATTS,
+    EVT_GROUP_L2CAP,
+    EVT_GROUP_COUNT
+} evt_group_t;
+
+static uint16_t const m_group_last[EVT_GROUP_COUNT] =
+{
+    BLE_EVT_LAST,
+    BLE_GAP_EVT_LAST,
+    BLE_GATTC_EVT_LAST,
+    BLE_GATTS_EVT_LAST,
+    BLE_L2CAP_EVT_LAST
+};
+
+// Observer lists of all groups, stored back to back. The list of group g is
+// m_table[m_group_start[g]] to m_table[m_group_start[g + 1] - 1].
+static ble_evt_observer_t const * m_table[BLE_EVT_OBSERVER_TABLE_SIZE];
+static uint8_t                    m_group_start[EVT_GROUP_COUNT + 1];
+
+STATIC_ASSERT(BLE_EVT_OBSERVER_TABLE_SIZE <= UINT8_MAX);
+
+
+static uint16_t group_first_get(uint32_t group)
+{
+    return (group == EVT_GROUP_COMMON) ? BLE_EVT_BASE : (m_group_last[group - 1] + 1);
+}
+
+
+/**@brief Function for finding the group of an event ID.
+ *
+ * @return The event group, or EVT_GROUP_COUNT if the event ID is outside all groups.
+ */
+static uint32_t group_get(uint16_t evt_id)
+{
+    uint32_t group;
+
+    for (group = 0; group < EVT_GROUP_COUNT; group++)
+    {
+        if (evt_id <= m_group_last[group])
+        {
+            break;
+        }
+    }
+
+    return group;
+}
+
+
+ret_code_t ble_evt_observers_init(void)
+{
+    uint32_t const count = OBSERVER_COUNT;
+    uint32_t       entries = 0;
+
+    for (uint32_t group = 0; group < EVT_GROUP_COUNT; group++)
+    {
+        uint16_t const first = group_first_get(group);
+        uint16_t const last  = m_group_last[group];
+
+        m_group_start[group] = entries;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            ble_evt_observer_t const * p_observer = OBSERVER_GET(i);
+            uint32_t                   pos;
+
+            if ((p_observer->evt_id_first > last) || (p_observer->evt_id_last < first))
+            {
+                continue;
+            }
+
+            if (entries >= BLE_EVT_OBSERVER_TABLE_SIZE)
+            {
+                return NRF_ERROR_NO_MEM;
+            }
+
+            // Insertion sort on priority. Observers with equal priority keep section order.
+            pos = entries;
+            while ((pos > m_group_start[group]) && (m_table[pos - 1]->priority > p_observer->priority))
+            {
+                m_table[pos] = m_table[pos - 1];
+                pos--;
+            }
+            m_table[pos] = p_observer;
+            entries++;
+        }
+    }
+
+    m_group_start[EVT_GROUP_COUNT] = entries;
+
+    return NRF_SUCCESS;
+}
+
+
+void ble_evt_observers_dispatch(ble_evt_t * p_ble_evt)
+{
+    uint16_t const evt_id = p_ble_evt->header.evt_id;
+    uint32_t const group  = group_get(evt_id);
+
+    if (group >= EVT_GROUP_COUNT)
+    {
+        return;
+    }
+
+    for (uint32_t i = m_group_start[group]; i < m_group_start[group + 1]; i++)
+    {
+        ble_evt_observer_t const * p_observer = m_table[i];
+
+        if ((evt_id >= p_observer->evt_id_first) && (evt_id <= p_observer->evt_id_last))
+        {
+            p_observer->handler(p_ble_evt, p_observer->p_context);
+        }
+    }
+}
@@ -0,0 +1,125 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/**
+ * @file
+ *
+ * @defgroup ble_evt_observer BLE event observers
+ * @ingroup ble_sdk_lib
+ * @{
+ * @brief Module for dispatching BLE events to observers registered at compile time.
+ *
+ * @details Modules register an observer with @ref BLE_EVT_OBSERVER_REGISTER, stating the range
+ *          of event IDs they handle. The observers are placed in the section
+ *          "ble_evt_observers" (see @ref section_vars). @ref ble_evt_observers_init builds one
+ *          observer list per event group (common, GAP, GATTC, GATTS, L2CAP), so that
+ *          @ref ble_evt_observers_dispatch only visits observers that can be interested in the
+ *          group of the event, instead of calling every module for every event.
+ *
+ *          @ref ble_evt_observers_dispatch has the signature of @ref ble_evt_handler_t, and can be
+ *          passed directly to @ref softdevice_ble_evt_handler_set.
+ *
+ *          Modules that can register observers do so when BLE_EVT_OBSERVERS_ENABLED is defined
+ *          (for example @ref ble_sdk_lib_conn_params). The application then passes events to
+ *          @ref ble_evt_observers_dispatch instead of calling the *_on_ble_evt functions of those
+ *          modules.
+ *
+ * @note    When using GCC, the linker script must keep the section and define its start and stop
+ *          symbols, as is done in the DFU bootloader linker scripts:
+ * @code
+ *  .ble_evt_observers_out ALIGN(4):
+ *  {
+ *    PROVIDE( __start_ble_evt_observers = .);
+ *    KEEP(*(.ble_evt_observers))
+ *    PROVIDE( __stop_ble_evt_observers = .);
+ *  } = 0
+ * @endcode
+ */
+
+#ifndef BLE_EVT_OBSERVER_H__
+#define BLE_EVT_OBSERVER_H__
+
+#include <stdint.h>
+#include "ble.h"
+#include "sdk_errors.h"
+#include "section_vars.h"
+
+
+#ifndef BLE_EVT_OBSERVER_TABLE_SIZE
+#define BLE_EVT_OBSERVER_TABLE_SIZE     32      /**< Maximum number of observer entries summed over all event groups. An observer spanning several groups takes one entry per group. */
+#endif
+
+
+/**@brief BLE event observer handler type.
+ *
+ * @param[in] p_ble_evt     Event received from the SoftDevice.
+ * @param[in] p_context     Context registered together with the handler.
+ */
+typedef void (*ble_evt_observer_handler_t)(ble_evt_t * p_ble_evt, void * p_context);
+
+
+/**@brief BLE event observer. */
+typedef struct
+{
+    ble_evt_observer_handler_t handler;         //!< Handler called for events in the range.
+    void                     * p_context;       //!< Context passed to the handler.
+    uint16_t                   evt_id_first;    //!< First event ID handled by the observer.
+    uint16_t                   evt_id_last;     //!< Last event ID handled by the observer.
+    uint8_t                    priority;        //!< Observers with a lower value receive events first.
+} ble_evt_observer_t;
+
+
+/**@brief Macro for registering a BLE event observer.
+ *
+ * @details The event ID range is inclusive. Use BLE_EVT_BASE and BLE_L2CAP_EVT_LAST for
+ *          receiving all events, or the group limits from ble_ranges.h for one group.
+ *
+ * @param[in] name          Name of the observer variable.
+ * @param[in] first         First event ID handled.
+ * @param[in] last          Last event ID handled.
+ * @param[in] prio          Dispatch priority. Observers with a lower value receive events first.
+ * @param[in] handler_fn    Handler, of type @ref ble_evt_observer_handler_t.
+ * @param[in] p_ctx         Context passed to the handler.
+ */
+#define BLE_EVT_OBSERVER_REGISTER(name, first, last, prio, handler_fn, p_ctx)  \
+    NRF_SECTION_VARS_ADD(ble_evt_observers, ble_evt_observer_t const name) =    \
+    {                                                                           \
+        .handler      = (handler_fn),                                           \
+        .p_context    = (p_ctx),                                                \
+        .evt_id_first = (first),                                                \
+        .evt_id_last  = (last),                                                 \
+        .priority     = (prio)                                                  \
+    }
+
+
+/**@brief Function for building the per-group observer lists.
+ *
+ * @details Must be called before the first event is dispatched.
+ *
+ * @retval NRF_SUCCESS          The observer lists were built.
+ * @retval NRF_ERROR_NO_MEM     The observers need more than @ref BLE_EVT_OBSERVER_TABLE_SIZE
+ *                              entries.
+ */
+ret_code_t ble_evt_observers_init(void);
+
+
+/**@brief Function for dispatching a BLE event to the registered observers.
+ *
+ * @details Observers are called in priority order, and only if the event ID is within their range.
+ *
+ * @param[in] p_ble_evt     Event received from the SoftDevice.
+ */
+void ble_evt_observers_dispatch(ble_evt_t * p_ble_evt);
+
+/** @} */
+
+#endif // BLE_EVT_OBSERVER_H__
@@ -171,6 +171,28 @@ typedef enum
 
 #define DM_GATTS_INVALID_SIZE        0xFFFFFFFF                                     /**< Identifer for GATTS invalid size. */
 
+#ifndef DM_PEER_INDEX_SIZE
+#define DM_PEER_INDEX_SIZE           16                                             /**< Number of buckets in the peer lookup index. Must be a power of two. */
+#endif
+
+#ifndef DM_SERVICE_CONTEXT_DEFERRED
+#define DM_SERVICE_CONTEXT_DEFERRED  1                                              /**< Set to 1 to store service contexts set while connected on disconnection, instead of immediately. */
+#endif
+
+#define DM_SKIPPED_UPDATE_QUEUE_SIZE 4                                              /**< Number of skipped context updates whose completion can be pending at a time. */
+
+STATIC_ASSERT(IS_POWER_OF_TWO(DM_PEER_INDEX_SIZE));
+STATIC_ASSERT(DEVICE_MANAGER_MAX_BONDS < DM_INVALID_ID);       /**< Peer instances are chained in the lookup index using DM_INVALID_ID as terminator. */
+STATIC_ASSERT(DEVICE_MANAGER_MAX_CONNECTIONS <= 32);           /**< Pending service contexts are tracked in a 32-bit bitmap. */
+
+/**@brief Context update skipped by storage_changed_update, waiting for its completion to be notified. */
+typedef struct
+{
+    pstorage_handle_t block_handle;                                                 /**< Block of the update. */
+    uint8_t         * p_data;                                                       /**< Source data of the update. */
+    pstorage_size_t   size;                                                         /**< Size of the update in bytes. */
+} skipped_update_t;
+
 /**
  * @defgroup api_param_check API Parameters check macros.
  *
@@ -446,6 +468,12 @@ static pstorage_handle_t       m_storage_handle;
 static uint32_t                m_peer_addr_update;                                    /**< 32-bit bitmap to remember peer device address update. */
 static ble_gap_id_key_t        m_local_id_info;                                       /**< ID information of central in case resolvable address is used. */
 static bool                    m_module_initialized = false;                          /**< State indicating if module is initialized or not. */
+static uint8_t                 m_addr_index[DM_PEER_INDEX_SIZE];                      /**< First peer instance of each address bucket in the peer lookup index. */
+static uint8_t                 m_addr_index_next[DEVICE_MANAGER_MAX_BONDS];           /**< Next peer instance in the same address bucket. */
+static bool                    m_peer_index_valid = false;                            /**< State indicating if the peer lookup index matches the peer table. */
+static uint32_t                m_service_context_pending;                             /**< 32-bit bitmap of connection instances with a service context not yet stored. */
+static skipped_update_t        m_skipped_update[DM_SKIPPED_UPDATE_QUEUE_SIZE];        /**< Context updates skipped because flash already held the data, in order. Their completion is notified by skipped_updates_notify. */
+static uint32_t                m_skipped_update_count;                                /**< Number of entries in m_skipped_update. */
 
 SDK_MUTEX_DEFINE(m_dm_mutex) /**< Mutex variable. Currently unused, this declaration does not occupy any space in RAM. */
 /** @} */
@@ -561,6 +589,143 @@ static __INLINE void application_instance_init(uint32_t index)
 }
 
 
+/**@brief Function for getting the peer lookup index bucket of a peer address.
+ *
+ * @param[in] p_addr Peer address.
+ *
+ * @return Bucket in the address index.
+ */
+static __INLINE uint32_t addr_bucket_get(ble_gap_addr_t const * p_addr)
+{
+    uint32_t hash = p_addr->addr_type;
+    uint32_t index;
+
+    for (index = 0; index < BLE_GAP_ADDR_LEN; index++)
+    {
+        hash = (hash * 31) + p_addr->addr[index];
+    }
+
+    return (hash ^ (hash >> 8)) & (DM_PEER_INDEX_SIZE - 1);
+}
+
+
+/**@brief Function for marking the peer lookup index as outdated.
+ *
+ * @details Called whenever the identification information of a peer instance changes. The index
+ *          is rebuilt on the next lookup.
+ */
+static __INLINE void peer_index_invalidate(void)
+{
+    m_peer_index_valid = false;
+}
+
+
+/**@brief Function for rebuilding the peer lookup index from the peer table.
+ *
+ * @details Instances are added in decreasing order, so that every bucket lists them in increasing
+ *          order and a lookup returns the same instance as a search of the whole table.
+ */
+static void peer_index_build(void)
+{
+    uint32_t count;
+    uint32_t index;
+    uint32_t bucket;
+
+    memset(m_addr_index, DM_INVALID_ID, sizeof(m_addr_index));
+
+    for (count = 0; count < DEVICE_MANAGER_MAX_BONDS; count++)
+    {
+        index = DEVICE_MANAGER_MAX_BONDS - 1 - count;
+
+        bucket                   = addr_bucket_get(&m_peer_table[index].peer_id.id_addr_info);
+        m_addr_index_next[index] = m_addr_index[bucket];
+        m_addr_index[bucket]     = index;
+    }
+
+    m_peer_index_valid = true;
+}
+
+
+static void dm_pstorage_cb_handler(pstorage_handle_t * p_handle,
+                                   uint8_t             op_code,
+                                   uint32_t            result,
+                                   uint8_t           * p_data,
+                                   uint32_t            data_len);
+
+
+/**@brief Function for updating data in a storage block, skipping the update if flash already holds
+ *        the same data.
+ *
+ * @details An update rewrites the whole flash page through the swap page, so it is only issued for
+ *          data that has changed. Flash is not compared while other storage operations are queued,
+ *          as they may still change its contents. The completion of a skipped update is notified
+ *          by @ref skipped_updates_notify.
+ *
+ * @param[in] p_dest Destination block.
+ * @param[in] p_src  Source data. Must be resident until the operation has completed.
+ * @param[in] size   Size of data in bytes.
+ * @param[in] offset Offset in the block in bytes.
+ *
+ * @retval NRF_SUCCESS On success, else an error code indicating reason for failure.
+ */
+static uint32_t storage_changed_update(pstorage_handle_t * p_dest,
+                                       uint8_t           * p_src,
+                                       pstorage_size_t     size,
+                                       pstorage_size_t     offset)
+{
+    uint32_t count;
+
+    if ((m_skipped_update_count < DM_SKIPPED_UPDATE_QUEUE_SIZE) &&
+        (pstorage_access_status_get(&count) == NRF_SUCCESS) &&
+        (count == 0) &&
+        (memcmp((uint8_t *)(p_dest->block_id + offset), p_src, size) == 0))
+    {
+        DM_LOG("[DM]: Data at offset 0x%04X unchanged, update skipped.\r\n", offset);
+
+        //The application is notified as if the update had been done, once the module call that
+        //requested it has completed.
+        m_skipped_update[m_skipped_update_count].block_handle = (*p_dest);
+        m_skipped_update[m_skipped_update_count].p_data       = p_src;
+        m_skipped_update[m_skipped_update_count].size         = size;
+        m_skipped_update_count++;
+
+        return NRF_SUCCESS;
+    }
+
+    return pstorage_update(p_dest, p_src, size, offset);
+}
+
+
+/**@brief Function for notifying the completion of the context updates skipped by
+ *        @ref storage_changed_update.
+ *
+ * @details The completions are passed to the pstorage callback handler in the order the updates
+ *          were requested, so that the same events are generated, and the same update status is
+ *          cleared, as for an update done in flash. Called at the end of the module functions that
+ *          store contexts, outside the module mutex.
+ */
+static void skipped_updates_notify(void)
+{
+    skipped_update_t update;
+
+    while (m_skipped_update_count > 0)
+    {
+        update = m_skipped_update[0];
+
+        m_skipped_update_count--;
+        memmove(&m_skipped_update[0],
+                &m_skipped_update[1],
+                m_skipped_update_count * sizeof(skipped_update_t));
+
+        dm_pstorage_cb_handler(&update.block_handle,
+                               PSTORAGE_UPDATE_OP_CODE,
+                               NRF_SUCCESS,
+                               update.p_data,
+                               update.size);
+    }
+}
+
+
 /**@brief Function for initialiasing the connection instance identified by 'index'.
  *
  * @param[in] index Device identifier.
@@ -574,6 +739,8 @@ static __INLINE void connection_instance_init(uint32_t index)
     m_connection_table[index].bonded_dev_id = DM_INVALID_ID;
     
     memset(&m_connection_table[index].peer_addr, 0, sizeof (ble_gap_addr_t));
+
+    m_service_context_pending &= (~((uint32_t)BIT_0 << index));
 }
 
 
@@ -597,6 +764,8 @@ static __INLINE void peer_instance_init(uint32_t index)
     //Reset the status bit.
     update_status_bit_reset(index);
 
+    peer_index_invalidate();
+
 #if (DEVICE_MANAGER_APP_CONTEXT_SIZE != 0)
     //Initialize the application context for bond device.
     m_app_context_table[index] = NULL;
@@ -687,6 +856,8 @@ static __INLINE ret_code_t device_instance_allocate(uint8_t *              p_dev
             {
                 m_peer_table[index].id_bitmap           &= (~ADDR_ENTRY);
                 m_peer_table[index].peer_id.id_addr_info = (*p_addr);
+
+                peer_index_invalidate();
             }
             else
             {
@@ -747,43 +918,39 @@ static __INLINE ret_code_t device_instance_free(uint32_t device_index)
  */
 static ret_code_t device_instance_find(ble_gap_addr_t const * p_addr, uint32_t * p_device_index)
 {
-    ret_code_t err_code;
-    uint32_t     index;
+    uint32_t index;
+
+    if (!m_peer_index_valid)
+    {
+        peer_index_build();
+    }
 
-    err_code = NRF_ERROR_NOT_FOUND;
-    
     DM_TRC("[DM]: Searching for device 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X.\r\n",
-           p_addr->addr[0], 
-           p_addr->addr[1], 
-           p_addr->addr[2], 
+           p_addr->addr[0],
+           p_addr->addr[1],
+           p_addr->addr[2],
            p_addr->addr[3],
-           p_addr->addr[4], 
+           p_addr->addr[4],
            p_addr->addr[5]);
 
-    for (index = 0; index < DEVICE_MANAGER_MAX_BONDS; index++)
+    index = m_addr_index[addr_bucket_get(p_addr)];
+
+    while ((index != DM_INVALID_ID) &&
+           (memcmp(&m_peer_table[index].peer_id.id_addr_info, p_addr, sizeof(ble_gap_addr_t)) != 0))
     {
-        DM_TRC("[DM]:[DI 0x%02X]: Device type 0x%02X.\r\n",
-               index, m_peer_table[index].peer_id.id_addr_info.addr_type);
-        DM_TRC("[DM]: Device Addr 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X 0x%02X.\r\n",
-               m_peer_table[index].peer_id.id_addr_info.addr[0],
-               m_peer_table[index].peer_id.id_addr_info.addr[1],
-               m_peer_table[index].peer_id.id_addr_info.addr[2],
-               m_peer_table[index].peer_id.id_addr_info.addr[3],
-               m_peer_table[index].peer_id.id_addr_info.addr[4],
-               m_peer_table[index].peer_id.id_addr_info.addr[5]);
+        index = m_addr_index_next[index];
+    }
 
-        if (memcmp(&m_peer_table[index].peer_id.id_addr_info, p_addr, sizeof(ble_gap_addr_t)) == 0)
-        {
-            DM_LOG("[DM]: Found device at instance 0x%02X\r\n", index);
+    if (index == DM_INVALID_ID)
+    {
+        return NRF_ERROR_NOT_FOUND;
+    }
 
-            (*p_device_index) = index;
-            err_code          = NRF_SUCCESS;
+    DM_LOG("[DM]: Found device at instance 0x%02X\r\n", index);
 
-            break;
-        }
-    }
+    (*p_device_index) = index;
 
-    return err_code;
+    return NRF_SUCCESS;
 }
 
 
@@ -908,7 +1075,7 @@ static __INLINE void device_context_store(dm_handle_t const * p_handle, device_s
             DM_LOG("[DM]:[DI %02X]:[CI %02X]: -> Updating bonding information.\r\n",
                    p_handle->device_id, p_handle->connection_id);
 
-            store_fn = pstorage_update;
+            store_fn = storage_changed_update;
         }
         else if (state == FIRST_BOND_STORE)
         {
@@ -974,6 +1141,38 @@ static __INLINE void device_context_store(dm_handle_t const * p_handle, device_s
 }
 
 
+/**@brief Function for storing a service context deferred by @ref dm_service_context_set.
+ *
+ * @details Used on disconnection of a bonded link that was not encrypted, in which case the device
+ *          context is not stored.
+ *
+ * @param[in] p_handle Device handle identifying device.
+ */
+static void service_context_pending_store(dm_handle_t const * p_handle)
+{
+    pstorage_handle_t block_handle;
+    ret_code_t        err_code;
+
+    err_code = pstorage_block_identifier_get(&m_storage_handle,
+                                             p_handle->device_id,
+                                             &block_handle);
+
+    if (err_code == NRF_SUCCESS)
+    {
+        err_code = m_service_context_store[m_application_table[p_handle->appl_id].service]
+                (
+                    &block_handle,
+                    p_handle
+                );
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        DM_ERR("[DM]: Failed to store deferred service context, reason %08X\r\n", err_code);
+    }
+}
+
+
 /**@brief Function for storing when there is no service registered.
  *
  * @param[in] p_block_handle Storage block identifier.
@@ -1037,7 +1236,7 @@ static __INLINE ret_code_t gatts_context_store(pstorage_handle_t const * p_block
                 //There is data already stored in persistent memory, therefore an update is needed.
                 DM_LOG("[DM]:[0x%02X]: Updating stored service context\r\n", p_handle->device_id);
 
-                store_fn = pstorage_update;
+                store_fn = storage_changed_update;
             }
             else
             {
@@ -1986,16 +2185,35 @@ ret_code_t dm_service_context_set(dm_handle_t const          * p_handle,
     }
 
     pstorage_handle_t block_handle;
-    uint32_t          err_code = pstorage_block_identifier_get(&m_storage_handle,
-                                                               p_handle->device_id,
-                                                               &block_handle);
+    uint32_t          err_code = NRF_SUCCESS;
 
-    err_code = m_service_context_store[p_context->service_type](&block_handle, p_handle);
+#if (DM_SERVICE_CONTEXT_DEFERRED == 1)
+    if ((m_connection_table[p_handle->connection_id].state & STATE_CONNECTED) == STATE_CONNECTED)
+    {
+        //Stored on disconnection.
+        DM_LOG("[DM]:[CI 0x%02X]: Service context store deferred.\r\n", p_handle->connection_id);
+
+        m_service_context_pending |= (BIT_0 << p_handle->connection_id);
+    }
+    else
+#endif //DM_SERVICE_CONTEXT_DEFERRED
+    {
+        err_code = pstorage_block_identifier_get(&m_storage_handle,
+                                                 p_handle->device_id,
+                                                 &block_handle);
+
+        if (err_code == NRF_SUCCESS)
+        {
+            err_code = m_service_context_store[p_context->service_type](&block_handle, p_handle);
+        }
+    }
 
     DM_TRC("[DM]: << dm_service_context_set\r\n");
 
     DM_MUTEX_UNLOCK();
 
+    skipped_updates_notify();
+
     return err_code;
 }
 
@@ -2096,7 +2314,7 @@ ret_code_t dm_application_context_set(dm_handle_t const              * p_handle,
         if ((err_code == NRF_SUCCESS) && (context_len != INVALID_CONTEXT_LEN))
         {
             //Data already exists. Need an update.
-            store_fn = pstorage_update;
+            store_fn = storage_changed_update;
 
             DM_LOG("[DM]:[DI 0x%02X]: Updating existing application context, existing len 0x%08X, "
                    "new length 0x%08X.\r\n",
@@ -2119,10 +2337,10 @@ ret_code_t dm_application_context_set(dm_handle_t const              * p_handle,
         {
             //Update context data is used for application context as flash is never
             //cleared if a delete of application context is called.
-            err_code = pstorage_update(&block_handle,
-                                       p_context->p_data,
-                                       DEVICE_MANAGER_APP_CONTEXT_SIZE,
-                                       (APP_CONTEXT_STORAGE_OFFSET + sizeof(uint32_t)));
+            err_code = storage_changed_update(&block_handle,
+                                              p_context->p_data,
+                                              DEVICE_MANAGER_APP_CONTEXT_SIZE,
+                                              (APP_CONTEXT_STORAGE_OFFSET + sizeof(uint32_t)));
             if (err_code == NRF_SUCCESS)
             {
                 m_app_context_table[p_handle->device_id] = p_context->p_data;
@@ -2134,6 +2352,8 @@ ret_code_t dm_application_context_set(dm_handle_t const              * p_handle,
 
     DM_MUTEX_UNLOCK();
 
+    skipped_updates_notify();
+
     return err_code;
 
 #else //DEVICE_MANAGER_APP_CONTEXT_SIZE
@@ -2312,6 +2532,7 @@ ret_code_t dm_peer_addr_set(dm_handle_t const    * p_handle,
         (p_addr->addr_type != BLE_GAP_ADDR_TYPE_RANDOM_PRIVATE_RESOLVABLE))
     {
         m_peer_table[p_handle->device_id].peer_id.id_addr_info = (*p_addr);
+        peer_index_invalidate();
         update_status_bit_set(p_handle->device_id);
         device_context_store(p_handle, UPDATE_PEER_ADDR);
         err_code = NRF_SUCCESS;
@@ -2325,6 +2546,8 @@ ret_code_t dm_peer_addr_set(dm_handle_t const    * p_handle,
 
     DM_MUTEX_UNLOCK();
 
+    skipped_updates_notify();
+
     return err_code;
 }
 
@@ -2569,6 +2792,11 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
                     //Write bond information persistently.
                     device_context_store(&handle, STORE_ALL_CONTEXT);
                 }
+                else if ((m_service_context_pending & (BIT_0 << index)) != 0)
+                {
+                    //Write the service context deferred by dm_service_context_set.
+                    service_context_pending_store(&handle);
+                }
             }
             else
             {
@@ -2639,6 +2867,9 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
             m_connection_table[index].state &= (~STATE_PAIRING);
             event.event_id                   = DM_EVT_SECURITY_SETUP_COMPLETE;
             notify_app                       = true;
+
+            //The distributed identity keys have been written to the peer table.
+            peer_index_invalidate();
             start_sec_procedure              = true;
 
             if (p_ble_evt->evt.gap_evt.params.auth_status.auth_status != BLE_GAP_SEC_STATUS_SUCCESS)
@@ -2801,4 +3032,6 @@ void dm_ble_evt_handler(ble_evt_t * p_ble_evt)
     UNUSED_VARIABLE(err_code);
 
     DM_MUTEX_UNLOCK();
+
+    skipped_updates_notify();
 }
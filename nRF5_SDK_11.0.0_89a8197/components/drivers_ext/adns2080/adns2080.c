@@ -59,6 +59,8 @@
 #define REG_MOUSE_CTRL_RES_EN        (0x40U) /*!< Mouse control register resolution enable bit */
 #define REG_MOUSE_CTRL_BIT_REPORTING (0x80U) /*!< Mouse control register "number of motion bits" bit*/
 
+static adns2080_motion_bits_t m_motion_bits = ADNS2080_MOTION_BITS_8; /*!< Number of motion bits last written to the chip, so that motion reads do not have to read REG_MOUSE_CTRL */
+
 void adns2080_movement_read(int16_t * deltaX, int16_t * deltaY)
 {
     uint8_t delta_x;       /*!< Stores REG_DELTA_X contents */
@@ -73,7 +75,7 @@ void adns2080_movement_read(int16_t * deltaX, int16_t * deltaY)
     delta_x = sdio_read_byte(REG_DELTA_X);
     delta_y = sdio_read_byte(REG_DELTA_Y);
 
-    if (adns2080_motion_bits_read() == ADNS2080_MOTION_BITS_12)
+    if (m_motion_bits == ADNS2080_MOTION_BITS_12)
     {
         // In 12 bit mode the upper 4 bits are stored in a separate register
         // where first 4 upper bits are for delta_x and lower 4 bits for delta_y.
@@ -104,8 +106,8 @@ void adns2080_movement_read(int16_t * deltaX, int16_t * deltaY)
             u16_deltaY = 0x0000;
         }
 
-        u16_deltaX |= (delta_x_high << 4) | delta_x;
-        u16_deltaY |= (delta_y_high << 4) | delta_y;
+        u16_deltaX |= (delta_x_high << 8) | delta_x;
+        u16_deltaY |= (delta_y_high << 8) | delta_y;
     }
     else // Only 8 bits is used for motion data
     {
@@ -142,7 +144,8 @@ void adns2080_movement_read(int16_t * deltaX, int16_t * deltaY)
 adns2080_motion_bits_t adns2080_motion_bits_read(void)
 {
     /* Read the most significant bit */
-    return (adns2080_motion_bits_t)((sdio_read_byte(REG_MOUSE_CTRL) >> 7) & 0x01);
+    m_motion_bits = (adns2080_motion_bits_t)((sdio_read_byte(REG_MOUSE_CTRL) >> 7) & 0x01);
+    return m_motion_bits;
 }
 
 bool adns2080_is_motion_detected(void)
@@ -179,6 +182,7 @@ adns2080_status_t adns2080_init(void)
 void adns2080_reset(void)
 {
     sdio_write_byte(REG_RESET, ADNS2080_RESET_NUMBER);
+    m_motion_bits = ADNS2080_MOTION_BITS_8;
 }
 
 void adns2080_powerdown(void)
@@ -293,11 +297,24 @@ adns2080_status_t adns2080_motion_bits_set(adns2080_motion_bits_t motion_bits)
     if (status == ADNS2080_OK)
     {
         sdio_write_byte(REG_MOUSE_CTRL, databyte);
+        m_motion_bits = motion_bits;
     }
 
     return status;
 }
 
+uint8_t adns2080_motion_burst_setup(void)
+{
+    // In 12 bit mode the burst has to reach REG_DELTA_XY_HIGH, which also
+    // returns the registers between REG_DELTA_Y and REG_DELTA_XY_HIGH.
+    uint8_t last = (adns2080_motion_bits_read() == ADNS2080_MOTION_BITS_12) ? REG_DELTA_XY_HIGH : REG_DELTA_Y;
+
+    sdio_write_byte(REG_BURST_READ_FIRST, REG_DELTA_X);
+    sdio_write_byte(REG_BURST_READ_LAST, last);
+
+    return (uint8_t)(last - REG_DELTA_X + 1);
+}
+
 void adns2080_rest_periods_set(uint8_t rest1_period, uint8_t rest2_period, uint8_t rest3_period)
 {
     adns2080_mode_t current_mode = adns2080_force_mode_read();
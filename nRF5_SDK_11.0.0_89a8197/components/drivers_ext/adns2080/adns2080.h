@@ -27,6 +27,8 @@
 * @brief ADNS2080 mouse sensor driver.
 */
 
+#define ADNS2080_MOTION_BURST_ADDRESS (0x63U) /*!< Register address that starts a motion burst read */
+
 /**
  * Describes return values for @ref adns2080_init.
  */
@@ -150,6 +152,7 @@ void adns2080_powerdown(void);
  *
  * After wakeup, all mouse sensor settings must be reloaded. Valid mouse sensor 
  * information will be available 55 milliseconds after this function finishes. 
+ * If the motion reader is used, @ref adns2080_motion_init reloads its settings.
  */
 void adns2080_wakeup(void);
 
@@ -203,6 +206,19 @@ adns2080_status_t adns2080_motion_bits_set(adns2080_motion_bits_t motion_bits);
  */
 adns2080_motion_bits_t adns2080_motion_bits_read(void);
 
+/**
+ * @brief Function for configuring the motion burst read.
+ *
+ * Sets the burst range so that a read of @ref ADNS2080_MOTION_BURST_ADDRESS
+ * returns DELTA_X and DELTA_Y first. In 12 bit mode, the burst continues up to
+ * DELTA_XY_HIGH, which is the last byte.
+ * Chip is expected to be initialized before calling this function, and the
+ * number of motion bits must not be changed afterwards.
+ *
+ * @return Number of bytes returned by a motion burst read.
+ */
+uint8_t adns2080_motion_burst_setup(void);
+
 /**
  * @brief Function for reading X- and Y-axis movement (in counts) since last report.
  *
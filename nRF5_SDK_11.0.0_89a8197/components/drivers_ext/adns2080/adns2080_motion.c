@@ -0,0 +1,312 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "adns2080_motion.h"
+#include "app_util_platform.h"
+#include "nordic_common.h"
+#include "nrf_assert.h"
+#include "nrf_drv_gpiote.h"
+#include "nrf_error.h"
+
+/*lint ++flb "Enter library region" */
+
+#define BURST_LENGTH_MAX (10U) /*!< Motion burst length in 12 bit mode, DELTA_X to DELTA_XY_HIGH */
+
+/**
+ * Motion reader states.
+ */
+typedef enum
+{
+  STATE_IDLE,    /*!< No read in progress */
+  STATE_ADDRESS, /*!< Sending the burst read address */
+  STATE_GAP,     /*!< Waiting between the address and the burst data */
+  STATE_DATA     /*!< Receiving the burst data */
+} motion_state_t;
+
+static nrf_drv_spi_t const *   mp_spi;                         /*!< SPI master instance */
+static nrf_drv_timer_t const * mp_timer;                       /*!< Timer instance for the address gap */
+static bool                    m_initialized;                  /*!< Motion reader is initialized */
+static volatile motion_state_t m_state;                        /*!< Current state */
+static uint8_t                 m_motion_pin;                   /*!< MOTION pin */
+static bool                    m_motion_active_high;           /*!< MOTION pin polarity */
+static adns2080_motion_bits_t  m_motion_bits;                  /*!< Number of motion bits */
+static uint8_t                 m_burst_length;                 /*!< Number of bytes in a motion burst */
+static uint8_t                 m_tx_address;                   /*!< Burst read address. Kept in RAM for EasyDMA */
+static uint8_t                 m_rx_buffer[BURST_LENGTH_MAX];  /*!< Burst data */
+static int32_t                 m_delta_x;                      /*!< Accumulated X-axis movement */
+static int32_t                 m_delta_y;                      /*!< Accumulated Y-axis movement */
+
+/**
+ * @brief Function for starting a burst read if none is in progress and the MOTION pin is active.
+ */
+static void read_start(void)
+{
+    bool start;
+
+    CRITICAL_REGION_ENTER();
+    start = (m_state == STATE_IDLE) && (nrf_drv_gpiote_in_is_set(m_motion_pin) == m_motion_active_high);
+    if (start)
+    {
+        m_state = STATE_ADDRESS;
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (start)
+    {
+        UNUSED_RETURN_VALUE(nrf_drv_spi_transfer(mp_spi, &m_tx_address, 1, NULL, 0));
+    }
+}
+
+/**
+ * @brief Function for sign extending a 12 bit delta.
+ */
+static int16_t delta_12_bit_get(uint8_t low, uint8_t high)
+{
+    uint16_t value = (uint16_t)(((uint16_t)(high & 0x0F) << 8) | low);
+
+    if (value & 0x0800)
+    {
+        value |= 0xF000;
+    }
+    return (int16_t)value;
+}
+
+/**
+ * @brief Function for adding the deltas of a completed burst to the accumulators.
+ */
+static void burst_accumulate(void)
+{
+    int16_t delta_x;
+    int16_t delta_y;
+
+    if (m_motion_bits == ADNS2080_MOTION_BITS_12)
+    {
+        // The last byte of the burst is DELTA_XY_HIGH: upper 4 bits for X, lower 4 bits for Y.
+        uint8_t delta_xy_high = m_rx_buffer[m_burst_length - 1];
+
+        delta_x = delta_12_bit_get(m_rx_buffer[0], delta_xy_high >> 4);
+        delta_y = delta_12_bit_get(m_rx_buffer[1], delta_xy_high);
+    }
+    else
+    {
+        delta_x = (int8_t)m_rx_buffer[0];
+        delta_y = (int8_t)m_rx_buffer[1];
+    }
+
+    CRITICAL_REGION_ENTER();
+    m_delta_x += delta_x;
+    m_delta_y += delta_y;
+    CRITICAL_REGION_EXIT();
+}
+
+static void spi_event_handler(nrf_drv_spi_evt_t const * p_event)
+{
+    UNUSED_PARAMETER(p_event);
+
+    switch (m_state)
+    {
+        case STATE_ADDRESS:
+            // The timer stops and clears itself on the compare event.
+            m_state = STATE_GAP;
+            nrf_drv_timer_resume(mp_timer);
+            break;
+
+        case STATE_DATA:
+            burst_accumulate();
+            m_state = STATE_IDLE;
+            // Reading the deltas releases the MOTION pin unless there is new motion.
+            read_start();
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void timer_event_handler(nrf_timer_event_t event_type, void * p_context)
+{
+    UNUSED_PARAMETER(p_context);
+
+    if ((event_type == NRF_TIMER_EVENT_COMPARE0) && (m_state == STATE_GAP))
+    {
+        m_state = STATE_DATA;
+        UNUSED_RETURN_VALUE(nrf_drv_spi_transfer(mp_spi, NULL, 0, m_rx_buffer, m_burst_length));
+    }
+}
+
+static void motion_pin_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+    UNUSED_PARAMETER(pin);
+    UNUSED_PARAMETER(action);
+
+    read_start();
+}
+
+/**
+ * @brief Function for limiting an accumulated delta and removing the returned part from it.
+ */
+static int16_t delta_take(int32_t * p_accumulator, int16_t limit)
+{
+    int32_t delta = *p_accumulator;
+
+    if (delta > limit)
+    {
+        delta = limit;
+    }
+    else if (delta < -limit)
+    {
+        delta = -limit;
+    }
+
+    *p_accumulator -= delta;
+    return (int16_t)delta;
+}
+
+ret_code_t adns2080_motion_init(nrf_drv_spi_t const *            p_spi,
+                                nrf_drv_timer_t const *          p_timer,
+                                adns2080_motion_config_t const * p_config)
+{
+    ret_code_t err_code;
+
+    ASSERT(p_spi != NULL);
+    ASSERT(p_timer != NULL);
+    ASSERT(p_config != NULL);
+
+    if (m_initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    // Configure the sensor while the GPIO serial port still owns the pins.
+    if (adns2080_motion_interrupt_set(p_config->motion_polarity, ADNS2080_MOTION_OUTPUT_SENSITIVITY_LEVEL) != ADNS2080_OK)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    m_burst_length = adns2080_motion_burst_setup();
+    m_motion_bits  = adns2080_motion_bits_read();
+    ASSERT(m_burst_length <= BURST_LENGTH_MAX);
+
+    nrf_drv_spi_config_t const spi_config =
+    {
+        .sck_pin      = p_config->sclk_pin,
+        .mosi_pin     = p_config->mosi_pin,
+        .miso_pin     = p_config->miso_pin,
+        .ss_pin       = NRF_DRV_SPI_PIN_NOT_USED,
+        .irq_priority = p_config->irq_priority,
+        .orc          = 0xFF,
+        .frequency    = p_config->frequency,
+        .mode         = NRF_DRV_SPI_MODE_3, // SCLK idles high, SDIO is sampled on the rising edge.
+        .bit_order    = NRF_DRV_SPI_BIT_ORDER_MSB_FIRST,
+    };
+
+    mp_spi       = p_spi;
+    mp_timer     = p_timer;
+    m_tx_address = ADNS2080_MOTION_BURST_ADDRESS;
+    m_state      = STATE_IDLE;
+    m_delta_x    = 0;
+    m_delta_y    = 0;
+
+    err_code = nrf_drv_timer_init(mp_timer, NULL, timer_event_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Power the timer on but leave it stopped. Each address gap starts it, and the compare
+    // event stops and clears it.
+    nrf_drv_timer_extended_compare(mp_timer,
+                                   NRF_TIMER_CC_CHANNEL0,
+                                   nrf_drv_timer_us_to_ticks(mp_timer, ADNS2080_MOTION_ADDRESS_DELAY_US),
+                                   (nrf_timer_short_mask_t)(NRF_TIMER_SHORT_COMPARE0_STOP_MASK |
+                                                            NRF_TIMER_SHORT_COMPARE0_CLEAR_MASK),
+                                   true);
+    nrf_drv_timer_enable(mp_timer);
+    nrf_drv_timer_pause(mp_timer);
+    nrf_drv_timer_clear(mp_timer);
+
+    err_code = nrf_drv_spi_init(mp_spi, &spi_config, spi_event_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_timer_uninit(mp_timer);
+        return err_code;
+    }
+
+    if (!nrf_drv_gpiote_is_init())
+    {
+        err_code = nrf_drv_gpiote_init();
+        if (err_code != NRF_SUCCESS)
+        {
+            nrf_drv_spi_uninit(mp_spi);
+            nrf_drv_timer_uninit(mp_timer);
+            return err_code;
+        }
+    }
+
+    m_motion_pin         = p_config->motion_pin;
+    m_motion_active_high = (p_config->motion_polarity == ADNS2080_MOTION_OUTPUT_POLARITY_HIGH);
+
+    nrf_drv_gpiote_in_config_t motion_config = GPIOTE_CONFIG_IN_SENSE_HITOLO(false);
+    if (m_motion_active_high)
+    {
+        motion_config.sense = NRF_GPIOTE_POLARITY_LOTOHI;
+    }
+
+    err_code = nrf_drv_gpiote_in_init(m_motion_pin, &motion_config, motion_pin_handler);
+    if (err_code != NRF_SUCCESS)
+    {
+        nrf_drv_spi_uninit(mp_spi);
+        nrf_drv_timer_uninit(mp_timer);
+        return err_code;
+    }
+
+    nrf_drv_gpiote_in_event_enable(m_motion_pin, true);
+    m_initialized = true;
+
+    // The MOTION pin may have become active before its event was enabled.
+    read_start();
+
+    return NRF_SUCCESS;
+}
+
+void adns2080_motion_uninit(void)
+{
+    if (!m_initialized)
+    {
+        return;
+    }
+
+    nrf_drv_gpiote_in_event_disable(m_motion_pin);
+    nrf_drv_gpiote_in_uninit(m_motion_pin);
+    nrf_drv_spi_uninit(mp_spi);
+    nrf_drv_timer_uninit(mp_timer);
+
+    m_state       = STATE_IDLE;
+    m_initialized = false;
+}
+
+bool adns2080_motion_get(int16_t * p_delta_x, int16_t * p_delta_y, int16_t limit)
+{
+    ASSERT(limit > 0);
+
+    CRITICAL_REGION_ENTER();
+    *p_delta_x = delta_take(&m_delta_x, limit);
+    *p_delta_y = delta_take(&m_delta_y, limit);
+    CRITICAL_REGION_EXIT();
+
+    return (*p_delta_x != 0) || (*p_delta_y != 0);
+}
+
+/*lint --flb "Leave library region" */
@@ -0,0 +1,122 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef ADNS2080_MOTION_H
+#define ADNS2080_MOTION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "adns2080.h"
+#include "nrf_drv_spi.h"
+#include "nrf_drv_timer.h"
+#include "sdk_errors.h"
+
+/** @file
+* @brief ADNS2080 interrupt driven motion reader
+*
+* @defgroup nrf_drivers_adns2080_motion ADNS2080 motion reader
+* @{
+* @ingroup nrf_drivers_adns2080
+* @brief Reads ADNS2080 motion with the SPI master, triggered by the MOTION pin.
+*
+* The MOTION pin of the sensor is configured as level sensitive. While it is
+* active, motion burst reads are done with the SPI master in the background and
+* the deltas are added to accumulators. A TIMER instance times the gap between
+* the address byte and the burst data. The application takes the accumulated
+* motion when it builds a HID report, with @ref adns2080_motion_get. Motion
+* that does not fit in one report is kept for the next one.
+*
+* The 2-wire serial port of the sensor is connected to the SPI master as
+* follows: SCLK to SCK, SDIO directly to MISO, and SDIO through a series
+* resistor (for example 1 kOhm) to MOSI. The resistor lets the sensor override
+* MOSI when it drives SDIO.
+*
+* The sensor is set up with the @ref nrf_drivers_adns2080 functions before
+* @ref adns2080_motion_init is called. While the motion reader is initialized,
+* the SPI master owns the pins and those functions must not be used. After
+* @ref adns2080_motion_uninit, @ref sdio_init must be called before using them
+* again.
+*
+* @ref adns2080_wakeup resets the sensor, which loses the MOTION pin and burst
+* settings made by @ref adns2080_motion_init. To power the sensor down, call
+* @ref adns2080_motion_uninit first, and call @ref adns2080_motion_init again
+* after the wakeup.
+*/
+
+#ifndef ADNS2080_MOTION_ADDRESS_DELAY_US
+#define ADNS2080_MOTION_ADDRESS_DELAY_US 20 /*!< Delay between the address byte and the first data byte of a burst read, in microseconds. Same as for register reads over GPIO. */
+#endif
+
+/**
+ * Motion reader configuration.
+ */
+typedef struct
+{
+  uint8_t                  sclk_pin;        /*!< Pin connected to SCLK */
+  uint8_t                  mosi_pin;        /*!< Pin connected to SDIO through a series resistor */
+  uint8_t                  miso_pin;        /*!< Pin connected to SDIO */
+  uint8_t                  motion_pin;      /*!< Pin connected to MOTION */
+  motion_output_polarity_t motion_polarity; /*!< Polarity of the MOTION pin */
+  nrf_drv_spi_frequency_t  frequency;       /*!< SPI frequency. Must not exceed the maximum SCLK frequency of the sensor */
+  uint8_t                  irq_priority;    /*!< Interrupt priority of the SPI master */
+} adns2080_motion_config_t;
+
+/**
+ * @brief Function for initializing the motion reader.
+ *
+ * Configures the MOTION pin of the sensor as level sensitive and sets up the
+ * motion burst read over the GPIO serial port, then hands the pins over to the
+ * SPI master. If the MOTION pin is already active, the first read is started.
+ * GPIOTE is initialized if it is not already.
+ *
+ * @param p_spi    SPI master instance. The instance is initialized by this function.
+ * @param p_timer  Timer instance, configured in Timer mode in nrf_drv_config.h. The
+ *                 instance is initialized by this function.
+ * @param p_config Motion reader configuration.
+ * @return
+ * @retval NRF_SUCCESS             Motion reader was initialized.
+ * @retval NRF_ERROR_INVALID_STATE Motion reader is already initialized.
+ * @retval NRF_ERROR_INVALID_PARAM Invalid MOTION pin polarity.
+ * @return Other errors from @ref nrf_drv_timer_init, @ref nrf_drv_spi_init, and
+ *         @ref nrf_drv_gpiote_in_init.
+ */
+ret_code_t adns2080_motion_init(nrf_drv_spi_t const *            p_spi,
+                                nrf_drv_timer_t const *          p_timer,
+                                adns2080_motion_config_t const * p_config);
+
+/**
+ * @brief Function for uninitializing the motion reader.
+ *
+ * A read in progress is aborted, and accumulated motion is discarded.
+ */
+void adns2080_motion_uninit(void);
+
+/**
+ * @brief Function for taking the motion accumulated since the last call.
+ *
+ * Each axis is limited to [-limit, limit]. The part of the motion that
+ * exceeds the limit is kept and returned by the next call.
+ *
+ * @param p_delta_x Location to store X-axis movement
+ * @param p_delta_y Location to store Y-axis movement
+ * @param limit     Largest absolute value returned for each axis
+ * @return
+ * @retval true, if any movement was returned
+ * @retval false, if no movement has been accumulated
+ */
+bool adns2080_motion_get(int16_t * p_delta_x, int16_t * p_delta_y, int16_t limit);
+
+/**
+ *@}
+ **/
+
+#endif
@@ -26,10 +26,20 @@
 #include "app_scheduler.h"
 #include "nrf_delay.h"
 #include "sdk_common.h"
+#include <stddef.h>
 
 #define IRQ_ENABLED             0x01                    /**< Field identifying if an interrupt is enabled. */
 #define MAX_NUMBER_INTERRUPTS   32                      /**< Maximum number of interrupts available. */
 
+#ifndef BOOTLOADER_REVALIDATE_ON_POWER_ON
+#define BOOTLOADER_REVALIDATE_ON_POWER_ON   1           /**< Verify the full application CRC on every power-on reset, even when the image has already been validated. The fingerprint only samples the image, so this is what catches corruption of the other words. Set to 0 to rely on the fingerprint alone. */
+#endif
+
+#define FINGERPRINT_HEAD_WORDS  16                      /**< Number of words at the start of the image (the vector table) always included in the fingerprint. */
+#define FINGERPRINT_STRIDE      64                      /**< Distance, in words, between the sampled words of the remaining image. */
+#define FNV_PRIME               16777619UL              /**< FNV-1a prime used for the fingerprint. */
+#define FNV_OFFSET_BASIS        2166136261UL            /**< FNV-1a offset basis used for the fingerprint. */
+
 /**@brief Enumeration for specifying current bootloader status.
  */
 typedef enum
@@ -43,6 +53,8 @@ typedef enum
 
 static pstorage_handle_t        m_bootsettings_handle;  /**< Pstorage handle to use for registration and identifying the bootloader module on subsequent calls to the pstorage module for load and store of bootloader setting in flash. */
 static bootloader_status_t      m_update_status;        /**< Current update status for the bootloader module to ensure correct behaviour when updating settings and when update completes. */
+static bool                     m_bank_0_checked;       /**< The image in bank0 has been checked since reset. */
+static bool                     m_bank_0_valid;         /**< Result of the check of the image in bank0. */
 
 /**@brief   Function for handling callbacks from pstorage module.
  *
@@ -96,6 +108,110 @@ static void wait_for_events(void)
 }
 
 
+static void bootloader_settings_save(bootloader_settings_t * p_settings)
+{
+    uint32_t err_code = pstorage_clear(&m_bootsettings_handle, sizeof(bootloader_settings_t));
+    APP_ERROR_CHECK(err_code);
+
+    err_code = pstorage_store(&m_bootsettings_handle,
+                              (uint8_t *)p_settings,
+                              sizeof(bootloader_settings_t),
+                              0);
+    APP_ERROR_CHECK(err_code);
+}
+
+
+/**@brief   Function for computing the fingerprint of the image in bank0.
+ *
+ * @details The fingerprint is an FNV-1a hash of the vector table and of every
+ *          @ref FINGERPRINT_STRIDE th word of the rest of the image, including the last word. It is
+ *          cheap enough to compute on every boot, and detects an image that has been replaced
+ *          without going through DFU, for example by a debugger.
+ */
+static uint32_t bank_0_fingerprint_compute(uint32_t size)
+{
+    uint32_t const * p_image = (uint32_t *)DFU_BANK_0_REGION_START;
+    uint32_t const   words   = size / sizeof(uint32_t);
+    uint32_t         hash    = FNV_OFFSET_BASIS ^ size;
+    uint32_t         i;
+
+    for (i = 0; (i < FINGERPRINT_HEAD_WORDS) && (i < words); i++)
+    {
+        hash = (hash ^ p_image[i]) * FNV_PRIME;
+    }
+
+    for (; i < words; i += FINGERPRINT_STRIDE)
+    {
+        hash = (hash ^ p_image[i]) * FNV_PRIME;
+    }
+
+    if (words > 0)
+    {
+        hash = (hash ^ p_image[words - 1]) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+
+/**@brief   Function for checking whether the image in bank0 must be verified with a full CRC,
+ *          given the reset reason.
+ *
+ * @details Soft, pin and watchdog resets use the validation record, so that they stay fast. A
+ *          power-on reset verifies the whole image again, see @ref BOOTLOADER_REVALIDATE_ON_POWER_ON.
+ */
+static bool full_check_required(void)
+{
+#if BOOTLOADER_REVALIDATE_ON_POWER_ON
+    // No reset reason flag set indicates a power-on or brown-out reset.
+    return (NRF_POWER->RESETREAS == 0);
+#else
+    return false;
+#endif
+}
+
+
+/**@brief   Function for recording in the bootloader settings that the image in bank0 is valid.
+ *
+ * @details The record is normally written over the erased record fields. If they are not erased,
+ *          the settings page is rewritten. The function waits until the record is in flash.
+ */
+static void bank_0_validation_record_save(bootloader_settings_t const * p_settings, uint32_t fingerprint)
+{
+    static uint32_t              record[2];
+    static bootloader_settings_t settings;
+    bootloader_status_t          status = m_update_status;
+    uint32_t                     err_code;
+
+    record[0] = BOOTLOADER_BANK_0_VALID_TAG(p_settings->bank_0_crc);
+    record[1] = fingerprint;
+
+    m_update_status = BOOTLOADER_SETTINGS_SAVING;
+
+    if ((p_settings->bank_0_valid_tag   == BOOTLOADER_BANK_0_NOT_VALIDATED) &&
+        (p_settings->bank_0_fingerprint == BOOTLOADER_BANK_0_NOT_VALIDATED))
+    {
+        err_code = pstorage_store(&m_bootsettings_handle,
+                                  (uint8_t *)record,
+                                  sizeof(record),
+                                  offsetof(bootloader_settings_t, bank_0_valid_tag));
+        APP_ERROR_CHECK(err_code);
+    }
+    else
+    {
+        settings                    = *p_settings;
+        settings.bank_0_valid_tag   = record[0];
+        settings.bank_0_fingerprint = record[1];
+
+        bootloader_settings_save(&settings);
+    }
+
+    wait_for_events();
+
+    m_update_status = status;
+}
+
+
 bool bootloader_app_is_valid(uint32_t app_addr)
 {
     const bootloader_settings_t * p_bootloader_settings;
@@ -114,35 +230,52 @@ bool bootloader_app_is_valid(uint32_t app_addr)
     if (p_bootloader_settings->bank_0 == BANK_VALID_APP)
     {
         uint16_t image_crc = 0;
+        uint32_t fingerprint;
+        bool     recorded;
 
         // A stored crc value of 0 indicates that CRC checking is not used.
-        if (p_bootloader_settings->bank_0_crc != 0)
+        if (p_bootloader_settings->bank_0_crc == 0)
+        {
+            return true;
+        }
+
+        // The image does not change between calls, so it is only checked once per reset.
+        if (m_bank_0_checked)
+        {
+            return m_bank_0_valid;
+        }
+
+        fingerprint = bank_0_fingerprint_compute(p_bootloader_settings->bank_0_size);
+        recorded    = (p_bootloader_settings->bank_0_valid_tag ==
+                       BOOTLOADER_BANK_0_VALID_TAG(p_bootloader_settings->bank_0_crc)) &&
+                      (p_bootloader_settings->bank_0_fingerprint == fingerprint);
+
+        if (recorded && !full_check_required())
+        {
+            success = true;
+        }
+        else
         {
             image_crc = crc16_compute((uint8_t *)DFU_BANK_0_REGION_START,
                                       p_bootloader_settings->bank_0_size,
                                       NULL);
+
+            success = (image_crc == p_bootloader_settings->bank_0_crc);
+
+            if (success && !recorded)
+            {
+                bank_0_validation_record_save(p_bootloader_settings, fingerprint);
+            }
         }
 
-        success = (image_crc == p_bootloader_settings->bank_0_crc);
+        m_bank_0_checked = true;
+        m_bank_0_valid   = success;
     }
 
     return success;
 }
 
 
-static void bootloader_settings_save(bootloader_settings_t * p_settings)
-{
-    uint32_t err_code = pstorage_clear(&m_bootsettings_handle, sizeof(bootloader_settings_t));
-    APP_ERROR_CHECK(err_code);
-
-    err_code = pstorage_store(&m_bootsettings_handle,
-                              (uint8_t *)p_settings,
-                              sizeof(bootloader_settings_t),
-                              0);
-    APP_ERROR_CHECK(err_code);
-}
-
-
 void bootloader_dfu_update_process(dfu_update_status_t update_status)
 {
     static bootloader_settings_t  settings;
@@ -150,6 +283,11 @@ void bootloader_dfu_update_process(dfu_update_status_t update_status)
 
     bootloader_util_settings_get(&p_bootloader_settings);
 
+    // Any change to bank0 invalidates its validation record.
+    settings.bank_0_valid_tag   = BOOTLOADER_BANK_0_NOT_VALIDATED;
+    settings.bank_0_fingerprint = BOOTLOADER_BANK_0_NOT_VALIDATED;
+    m_bank_0_checked            = false;
+
     if (update_status.status_code == DFU_UPDATE_APP_COMPLETE)
     {
         settings.bank_0_crc  = update_status.app_crc;
@@ -378,5 +516,8 @@ void bootloader_settings_get(bootloader_settings_t * const p_settings)
     p_settings->bl_image_size  = p_bootloader_settings->bl_image_size;
     p_settings->app_image_size = p_bootloader_settings->app_image_size;
     p_settings->sd_image_start = p_bootloader_settings->sd_image_start;
+
+    p_settings->bank_0_valid_tag   = p_bootloader_settings->bank_0_valid_tag;
+    p_settings->bank_0_fingerprint = p_bootloader_settings->bank_0_fingerprint;
 }
 
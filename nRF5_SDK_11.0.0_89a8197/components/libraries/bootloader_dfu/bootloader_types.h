@@ -40,6 +40,9 @@ typedef enum
     BANK_INVALID_APP = 0xFF,
 } bootloader_bank_code_t;
 
+#define BOOTLOADER_BANK_0_NOT_VALIDATED     0xFFFFFFFF                          /**< Value of the validation record fields while the image in bank0 has not been validated. */
+#define BOOTLOADER_BANK_0_VALID_TAG(crc)    (0xA5A50000UL | (uint16_t)(crc))    /**< Validation tag recorded for an image with the given CRC. */
+
 /**@brief Structure holding bootloader settings for application and bank data.
  */
 typedef struct
@@ -52,6 +55,8 @@ typedef struct
     uint32_t               bl_image_size;   /**< Size of Bootloader image in bank0 if bank_0 code is BANK_VALID_SD. */
     uint32_t               app_image_size;  /**< Size of Application image in bank0 if bank_0 code is BANK_VALID_SD. */
     uint32_t               sd_image_start;  /**< Location in flash where SoftDevice image is stored for SoftDevice update. */
+    uint32_t               bank_0_valid_tag;    /**< Set once the CRC of the image in bank0 has been verified, see @ref BOOTLOADER_BANK_0_VALID_TAG. Erased (0xFFFFFFFF) until then. */
+    uint32_t               bank_0_fingerprint;  /**< Fingerprint of the image in bank0 recorded together with bank_0_valid_tag. */
 } bootloader_settings_t;
 
 #endif // BOOTLOADER_TYPES_H__ 
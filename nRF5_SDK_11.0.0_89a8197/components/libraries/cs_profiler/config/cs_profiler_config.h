@@ -0,0 +1,46 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef CS_PROFILER_CONFIG_H__
+#define CS_PROFILER_CONFIG_H__
+
+ /**
+ * @file cs_profiler_config.h
+ *
+ * @defgroup cs_profiler_config Configuration options
+ * @ingroup cs_profiler
+ * @{
+ * @brief   Configuration options for the critical section profiler.
+ */
+
+/**@brief   Configures the number of histogram bins.
+ *
+ * Bin n counts durations in the range [2^n, 2^(n+1)) microseconds. The first bin also counts
+ * durations below 1 microsecond, and the last bin counts everything above its lower bound.
+ */
+#define CS_PROFILER_HIST_BINS           (8)
+
+/**@brief   Configures the RTT up-buffer used by @ref cs_profiler_dump. */
+#define CS_PROFILER_RTT_BUFFER_INDEX    (0)
+
+/**@brief   Configures the timer instance used for timestamps on nRF51 ICs.
+ *
+ * TIMER0 is used by the SoftDevice. The timer runs in 16-bit mode with 1 MHz resolution, so
+ * durations longer than 65 ms wrap around.
+ */
+#if defined(NRF51)
+    #define CS_PROFILER_TIMER           NRF_TIMER1
+#endif
+
+/** @} */
+
+#endif // CS_PROFILER_CONFIG_H__
@@ -0,0 +1,218 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "cs_profiler.h"
+#include <stddef.h>
+#include <string.h>
+#include "nrf.h"
+#include "nordic_common.h"
+#include "app_util_platform.h"
+#include "SEGGER_RTT.h"
+
+#if defined(NRF51)
+    #define CS_PROFILER_IRQ_COUNT       (SWI5_IRQn + 1)
+    #define TICKS_TO_US(ticks)          (ticks)                 /**< The timer runs at 1 MHz. */
+    #define TICKS_MASK                  (0xFFFFUL)              /**< The timer runs in 16-bit mode. */
+#elif defined(NRF52)
+    #define CS_PROFILER_IRQ_COUNT       (FPU_IRQn + 1)
+    #define TICKS_TO_US(ticks)          ((ticks) / 64)          /**< The CPU runs at 64 MHz. */
+    #define TICKS_MASK                  (0xFFFFFFFFUL)
+#endif
+
+static cs_profiler_site_t   m_isr_sites[CS_PROFILER_IRQ_COUNT];  /**< Statistics for each interrupt. */
+static cs_profiler_site_t * mp_sites_head;                      /**< List of critical region call sites that have been recorded. */
+static uint32_t             m_cr_start;                         /**< Timestamp of the entry into the outermost critical region. */
+static uint8_t              m_cr_depth;                         /**< Critical region nesting depth. */
+
+
+static void site_record(cs_profiler_site_t * p_site, uint32_t start)
+{
+    uint32_t duration = TICKS_TO_US((cs_profiler_timestamp_get() - start) & TICKS_MASK);
+    uint32_t bin      = 0;
+    uint32_t value    = duration >> 1;
+
+    while ((value != 0) && (bin < CS_PROFILER_HIST_BINS - 1))
+    {
+        value >>= 1;
+        bin++;
+    }
+
+    p_site->count++;
+    if (p_site->hist[bin] != UINT16_MAX)
+    {
+        p_site->hist[bin]++;
+    }
+    if (duration > p_site->max_us)
+    {
+        p_site->max_us = duration;
+    }
+}
+
+
+void cs_profiler_init(void)
+{
+    uint8_t i;
+
+#if defined(NRF52)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT       = 0;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#elif defined(NRF51)
+    CS_PROFILER_TIMER->TASKS_STOP  = 1;
+    CS_PROFILER_TIMER->MODE        = TIMER_MODE_MODE_Timer;
+    CS_PROFILER_TIMER->BITMODE     = TIMER_BITMODE_BITMODE_16Bit;
+    CS_PROFILER_TIMER->PRESCALER   = 4;
+    CS_PROFILER_TIMER->TASKS_CLEAR = 1;
+    CS_PROFILER_TIMER->TASKS_START = 1;
+#endif
+
+    for (i = 0; i < CS_PROFILER_IRQ_COUNT; i++)
+    {
+        m_isr_sites[i].line = i;
+    }
+
+    cs_profiler_reset();
+}
+
+
+uint32_t cs_profiler_timestamp_get(void)
+{
+#if defined(NRF52)
+    return DWT->CYCCNT;
+#elif defined(NRF51)
+    CS_PROFILER_TIMER->TASKS_CAPTURE[0] = 1;
+    return CS_PROFILER_TIMER->CC[0];
+#endif
+}
+
+
+void cs_profiler_cr_enter(cs_profiler_site_t * p_site)
+{
+    UNUSED_PARAMETER(p_site);
+
+    if (m_cr_depth++ == 0)
+    {
+        m_cr_start = cs_profiler_timestamp_get();
+    }
+}
+
+
+void cs_profiler_cr_exit(cs_profiler_site_t * p_site)
+{
+    if (--m_cr_depth != 0)
+    {
+        // Only the outermost critical region is recorded.
+        return;
+    }
+
+    site_record(p_site, m_cr_start);
+
+    if (!p_site->registered)
+    {
+        p_site->registered = 1;
+        p_site->p_next     = mp_sites_head;
+        mp_sites_head      = p_site;
+    }
+}
+
+
+void cs_profiler_isr_record(uint32_t start)
+{
+    int32_t irq = (int32_t)(__get_IPSR() & IPSR_ISR_Msk) - EXTERNAL_INT_VECTOR_OFFSET;
+
+    if ((irq >= 0) && (irq < CS_PROFILER_IRQ_COUNT))
+    {
+        site_record(&m_isr_sites[irq], start);
+    }
+}
+
+
+static void site_clear(cs_profiler_site_t * p_site)
+{
+    p_site->count  = 0;
+    p_site->max_us = 0;
+    memset(p_site->hist, 0, sizeof(p_site->hist));
+}
+
+
+void cs_profiler_reset(void)
+{
+    cs_profiler_site_t * p_site;
+    uint8_t              nested = 0;
+    uint8_t              i;
+
+    // The profiler must not profile itself, so the critical region macros are not used here.
+    app_util_critical_region_enter(&nested);
+
+    for (p_site = mp_sites_head; p_site != NULL; p_site = p_site->p_next)
+    {
+        site_clear(p_site);
+    }
+    for (i = 0; i < CS_PROFILER_IRQ_COUNT; i++)
+    {
+        site_clear(&m_isr_sites[i]);
+    }
+
+    app_util_critical_region_exit(nested);
+}
+
+
+static void site_print(char const * p_kind, cs_profiler_site_t * p_site)
+{
+    cs_profiler_site_t snapshot;
+    uint8_t            nested = 0;
+    uint8_t            i;
+
+    app_util_critical_region_enter(&nested);
+    snapshot = *p_site;
+    app_util_critical_region_exit(nested);
+
+    if (snapshot.count == 0)
+    {
+        return;
+    }
+
+    if (snapshot.p_file != NULL)
+    {
+        (void)SEGGER_RTT_printf(CS_PROFILER_RTT_BUFFER_INDEX, "%s %s:%u", p_kind,
+                                snapshot.p_file, snapshot.line);
+    }
+    else
+    {
+        (void)SEGGER_RTT_printf(CS_PROFILER_RTT_BUFFER_INDEX, "%s %u", p_kind, snapshot.line);
+    }
+
+    (void)SEGGER_RTT_printf(CS_PROFILER_RTT_BUFFER_INDEX, " n=%u max=%uus hist=",
+                            snapshot.count, snapshot.max_us);
+
+    for (i = 0; i < CS_PROFILER_HIST_BINS; i++)
+    {
+        (void)SEGGER_RTT_printf(CS_PROFILER_RTT_BUFFER_INDEX, "%u%s", snapshot.hist[i],
+                                (i == CS_PROFILER_HIST_BINS - 1) ? "\r\n" : ",");
+    }
+}
+
+
+void cs_profiler_dump(void)
+{
+    cs_profiler_site_t * p_site;
+    uint8_t              i;
+
+    for (p_site = mp_sites_head; p_site != NULL; p_site = p_site->p_next)
+    {
+        site_print("CR", p_site);
+    }
+    for (i = 0; i < CS_PROFILER_IRQ_COUNT; i++)
+    {
+        site_print("IRQ", &m_isr_sites[i]);
+    }
+}
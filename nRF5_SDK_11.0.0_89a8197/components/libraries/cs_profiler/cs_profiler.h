@@ -0,0 +1,118 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup cs_profiler Critical section profiler
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for measuring how long interrupts are masked.
+ *
+ * @details When CS_PROFILER_ENABLED is defined in the project, @ref CRITICAL_REGION_ENTER and
+ *          @ref CRITICAL_REGION_EXIT record the duration of every outermost critical region,
+ *          per call site. Interrupt handlers can be measured by placing @ref CS_PROFILER_ISR_ENTER
+ *          and @ref CS_PROFILER_ISR_EXIT at the start and end of the handler.
+ *
+ *          Timestamps come from the DWT cycle counter on nRF52 ICs and from a free-running TIMER
+ *          on nRF51 ICs (see @ref cs_profiler_config). For each call site and each interrupt, the
+ *          module keeps the number of occurrences, the maximum duration, and a histogram.
+ *          @ref cs_profiler_dump prints the results over RTT.
+ *
+ *          When CS_PROFILER_ENABLED is not defined, all macros compile to nothing.
+ */
+
+#ifndef CS_PROFILER_H__
+#define CS_PROFILER_H__
+
+#include <stdint.h>
+#include "cs_profiler_config.h"
+
+/**@brief Statistics for one call site or interrupt. */
+typedef struct cs_profiler_site_s
+{
+    char const                * p_file;                          /**< File of the call site, or NULL for interrupts. */
+    uint16_t                    line;                            /**< Line of the call site, or IRQ number for interrupts. */
+    uint16_t                    registered;                      /**< Set when the site is linked into the site list. */
+    uint32_t                    count;                           /**< Number of recorded occurrences. */
+    uint32_t                    max_us;                          /**< Longest recorded duration in microseconds. */
+    uint16_t                    hist[CS_PROFILER_HIST_BINS];     /**< Duration histogram (saturating counters). */
+    struct cs_profiler_site_s * p_next;                          /**< Next registered site. */
+} cs_profiler_site_t;
+
+/**@brief Static initializer for a call site. */
+#define CS_PROFILER_SITE_INIT { .p_file = __FILE__, .line = __LINE__ }
+
+/**@brief Function for initializing the profiler and starting the timestamp source.
+ *
+ * @note On nRF51 ICs, the timer given by @ref CS_PROFILER_TIMER is reserved for the profiler.
+ */
+void cs_profiler_init(void);
+
+/**@brief Function for getting the current timestamp in timer ticks. */
+uint32_t cs_profiler_timestamp_get(void);
+
+/**@brief Function for recording the entry into a critical region.
+ *
+ * @note Do not call this function directly. It is called by @ref CRITICAL_REGION_ENTER after
+ *       interrupts have been masked.
+ */
+void cs_profiler_cr_enter(cs_profiler_site_t * p_site);
+
+/**@brief Function for recording the exit from a critical region.
+ *
+ * @note Do not call this function directly. It is called by @ref CRITICAL_REGION_EXIT before
+ *       interrupts are unmasked.
+ */
+void cs_profiler_cr_exit(cs_profiler_site_t * p_site);
+
+/**@brief Function for recording the duration of the currently executing interrupt handler.
+ *
+ * @note Do not call this function directly. Use @ref CS_PROFILER_ISR_EXIT instead.
+ *
+ * @param[in] start  Timestamp taken at handler entry.
+ */
+void cs_profiler_isr_record(uint32_t start);
+
+/**@brief Function for clearing all recorded statistics. */
+void cs_profiler_reset(void);
+
+/**@brief Function for printing all recorded statistics over RTT.
+ *
+ * @details One line is printed per call site and per interrupt that has been recorded. Call
+ *          this function from thread mode, for example from the main loop.
+ */
+void cs_profiler_dump(void);
+
+#ifdef CS_PROFILER_ENABLED
+
+/**@brief Macro for marking the start of an interrupt handler.
+ *
+ * @note The handler duration includes the time spent in higher priority interrupts that preempt it.
+ */
+#define CS_PROFILER_ISR_ENTER() uint32_t __CS_PROFILER_ISR_START = cs_profiler_timestamp_get()
+
+/**@brief Macro for marking the end of an interrupt handler. Must be in the same scope as
+ *        @ref CS_PROFILER_ISR_ENTER.
+ */
+#define CS_PROFILER_ISR_EXIT()  cs_profiler_isr_record(__CS_PROFILER_ISR_START)
+
+#else
+
+#define CS_PROFILER_ISR_ENTER()
+#define CS_PROFILER_ISR_EXIT()
+
+#endif // CS_PROFILER_ENABLED
+
+#endif // CS_PROFILER_H__
+
+/** @} */
@@ -0,0 +1,298 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_drbg.h"
+#include <stdbool.h>
+#include <string.h>
+#include "nrf_error.h"
+#include "nrf_drv_rng.h"
+#include "app_util_platform.h"
+#ifdef SOFTDEVICE_PRESENT
+#include "nrf_soc.h"
+#else
+#include "nrf.h"
+#endif
+
+#define BLOCK_LEN   (16)                /**< AES block length. */
+#define KEY_LEN     (16)                /**< AES-128 key length. */
+#define SEED_LEN    (KEY_LEN + BLOCK_LEN) /**< CTR_DRBG seed length. */
+
+typedef struct
+{
+    uint8_t          key[KEY_LEN];      /**< Working key. */
+    uint8_t          v[BLOCK_LEN];      /**< Counter block. */
+    uint32_t         reseed_counter;    /**< Requests since the last reseed. */
+    uint8_t          seed[SEED_LEN];    /**< Entropy collected for the next reseed. */
+    uint8_t          seed_len;          /**< Number of bytes in @ref seed. */
+    bool             initialized;
+    app_drbg_stats_t stats;
+} app_drbg_cb_t;
+
+static app_drbg_cb_t m_drbg;
+
+#ifndef SOFTDEVICE_PRESENT
+#define ECB_TIMEOUT (0x1000000)         /**< Polling iterations before an ECB operation is considered failed. Same as in the ECB HAL. */
+
+/**@brief ECB data structure (key, cleartext, ciphertext) used only by this module. The ECB HAL
+ *        keeps its own structure and key, which are used for example by Gazell pairing. */
+static uint8_t m_ecb_data[KEY_LEN + 2 * BLOCK_LEN];
+#endif
+
+
+/**@brief Function for incrementing the counter block as a 128-bit big-endian integer. */
+static void v_increment(void)
+{
+    uint8_t i = BLOCK_LEN;
+
+    while (i > 0)
+    {
+        i--;
+        if (++m_drbg.v[i] != 0)
+        {
+            break;
+        }
+    }
+}
+
+
+/**@brief Function for encrypting the counter block with the working key. */
+static ret_code_t block_encrypt(uint8_t * p_out)
+{
+#ifdef SOFTDEVICE_PRESENT
+    nrf_ecb_hal_data_t ecb_data;
+    ret_code_t         err_code;
+
+    memcpy(ecb_data.key,       m_drbg.key, KEY_LEN);
+    memcpy(ecb_data.cleartext, m_drbg.v,   BLOCK_LEN);
+
+    err_code = sd_ecb_block_encrypt(&ecb_data);
+    if (err_code == NRF_SUCCESS)
+    {
+        memcpy(p_out, ecb_data.ciphertext, BLOCK_LEN);
+    }
+    memset(&ecb_data, 0, sizeof(ecb_data));
+
+    return (err_code == NRF_SUCCESS) ? NRF_SUCCESS : NRF_ERROR_INTERNAL;
+#else
+    // The ECB peripheral is pointed at the private data structure for this operation only, so
+    // the key loaded through the ECB HAL is preserved. The caller holds a critical region, so
+    // no other user can start an ECB operation in between.
+    uint32_t const ecb_data_ptr = NRF_ECB->ECBDATAPTR;
+    uint32_t       timeout      = ECB_TIMEOUT;
+    bool           done;
+
+    memcpy(&m_ecb_data[0],       m_drbg.key, KEY_LEN);
+    memcpy(&m_ecb_data[KEY_LEN], m_drbg.v,   BLOCK_LEN);
+
+    NRF_ECB->ECBDATAPTR      = (uint32_t)m_ecb_data;
+    NRF_ECB->EVENTS_ENDECB   = 0;
+    NRF_ECB->EVENTS_ERRORECB = 0;
+    NRF_ECB->TASKS_STARTECB  = 1;
+
+    while ((NRF_ECB->EVENTS_ENDECB == 0) && (NRF_ECB->EVENTS_ERRORECB == 0) && (--timeout > 0))
+    {
+        // Wait for the operation to complete.
+    }
+
+    done = (NRF_ECB->EVENTS_ENDECB != 0);
+
+    NRF_ECB->EVENTS_ENDECB   = 0;
+    NRF_ECB->EVENTS_ERRORECB = 0;
+    NRF_ECB->ECBDATAPTR      = ecb_data_ptr;
+
+    if (done)
+    {
+        memcpy(p_out, &m_ecb_data[KEY_LEN + BLOCK_LEN], BLOCK_LEN);
+    }
+    memset(m_ecb_data, 0, sizeof(m_ecb_data));
+
+    return done ? NRF_SUCCESS : NRF_ERROR_INTERNAL;
+#endif
+}
+
+
+/**@brief CTR_DRBG update function.
+ *
+ * @param[in] p_data  Provided data of @ref SEED_LEN bytes, or NULL for none.
+ */
+static ret_code_t drbg_update(uint8_t const * p_data)
+{
+    uint8_t    temp[SEED_LEN];
+    ret_code_t err_code;
+    uint8_t    i;
+
+    for (i = 0; i < SEED_LEN; i += BLOCK_LEN)
+    {
+        v_increment();
+        err_code = block_encrypt(&temp[i]);
+        if (err_code != NRF_SUCCESS)
+        {
+            memset(temp, 0, sizeof(temp));
+            return err_code;
+        }
+    }
+
+    if (p_data != NULL)
+    {
+        for (i = 0; i < SEED_LEN; i++)
+        {
+            temp[i] ^= p_data[i];
+        }
+    }
+
+    memcpy(m_drbg.key, &temp[0],       KEY_LEN);
+    memcpy(m_drbg.v,   &temp[KEY_LEN], BLOCK_LEN);
+    memset(temp, 0, sizeof(temp));
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for mixing fresh entropy from the pool into the state without blocking.
+ *
+ * @details As required by SP 800-90A for CTR_DRBG without derivation function, the reseed uses
+ *          seedlen (@ref SEED_LEN) bytes of entropy. The entropy pool can be smaller than that,
+ *          so the bytes available are collected over several calls until the seed is complete.
+ *
+ * @retval true   If the generator was reseeded.
+ * @retval false  If the seed is not complete yet.
+ */
+static bool drbg_reseed(void)
+{
+    uint8_t available = 0;
+    bool    success;
+
+    if (nrf_drv_rng_bytes_available(&available) != NRF_SUCCESS)
+    {
+        return false;
+    }
+
+    if (available > (SEED_LEN - m_drbg.seed_len))
+    {
+        available = SEED_LEN - m_drbg.seed_len;
+    }
+
+    if ((available > 0) && (nrf_drv_rng_rand(&m_drbg.seed[m_drbg.seed_len], available) == NRF_SUCCESS))
+    {
+        m_drbg.seed_len += available;
+    }
+
+    if (m_drbg.seed_len < SEED_LEN)
+    {
+        return false;
+    }
+
+    success = (drbg_update(m_drbg.seed) == NRF_SUCCESS);
+    memset(m_drbg.seed, 0, sizeof(m_drbg.seed));
+    m_drbg.seed_len = 0;
+
+    return success;
+}
+
+
+ret_code_t app_drbg_init(void)
+{
+    uint8_t    seed[SEED_LEN];
+    ret_code_t err_code;
+
+    memset(&m_drbg, 0, sizeof(m_drbg));
+
+    err_code = nrf_drv_rng_block_rand(seed, SEED_LEN);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Instantiate: key and counter start at zero, the seed is mixed in through the update function.
+    err_code = drbg_update(seed);
+    memset(seed, 0, sizeof(seed));
+
+    if (err_code == NRF_SUCCESS)
+    {
+        m_drbg.initialized = true;
+    }
+
+    return err_code;
+}
+
+
+/**@brief CTR_DRBG generate function. Must be called in a critical region. */
+static ret_code_t drbg_generate(uint8_t * p_buff, uint32_t length)
+{
+    uint8_t    block[BLOCK_LEN];
+    ret_code_t err_code;
+
+    if (m_drbg.reseed_counter >= APP_DRBG_RESEED_INTERVAL)
+    {
+        if (drbg_reseed())
+        {
+            m_drbg.reseed_counter = 0;
+            m_drbg.stats.reseeds++;
+        }
+        else
+        {
+            m_drbg.stats.reseeds_missed++;
+        }
+    }
+
+    m_drbg.stats.requests++;
+    m_drbg.stats.bytes += length;
+
+    while (length > 0)
+    {
+        uint32_t len = (length > BLOCK_LEN) ? BLOCK_LEN : length;
+
+        v_increment();
+        err_code = block_encrypt(block);
+        if (err_code != NRF_SUCCESS)
+        {
+            memset(block, 0, sizeof(block));
+            return err_code;
+        }
+
+        memcpy(p_buff, block, len);
+        p_buff += len;
+        length -= len;
+    }
+    memset(block, 0, sizeof(block));
+
+    // Backtracking resistance: the key used for this request is replaced before returning.
+    m_drbg.reseed_counter++;
+    return drbg_update(NULL);
+}
+
+
+ret_code_t app_drbg_rand(uint8_t * p_buff, uint32_t length)
+{
+    ret_code_t err_code;
+
+    if (!m_drbg.initialized)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    // The generator is shared by callers in different contexts (for example ECC in thread mode
+    // and Gazell pairing in an interrupt), so each request updates the state atomically.
+    CRITICAL_REGION_ENTER();
+    err_code = drbg_generate(p_buff, length);
+    CRITICAL_REGION_EXIT();
+
+    return err_code;
+}
+
+
+void app_drbg_stats_get(app_drbg_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_drbg.stats;
+    CRITICAL_REGION_EXIT();
+}
@@ -0,0 +1,86 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_drbg Deterministic random bit generator
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Non-blocking cryptographically secure random numbers.
+ *
+ * @details The module implements CTR_DRBG with AES-128 (NIST SP 800-90A, without derivation
+ *          function) on top of the ECB peripheral. The generator is seeded from the RNG driver
+ *          (@ref nrf_drv_rng), whose entropy pool is refilled in the background by the RNG
+ *          interrupt or by the SoftDevice.
+ *
+ *          Random numbers are produced at AES speed, so requests complete without waiting for
+ *          the RNG peripheral. The generator is reseeded every @ref APP_DRBG_RESEED_INTERVAL
+ *          requests with a full seed (32 bytes) from the pool, without blocking. If the pool holds
+ *          fewer bytes, they are kept and the reseed is completed on a later request.
+ *
+ * @note @ref app_drbg_rand can be called from any context. Each request runs in a critical
+ *       region, so interrupts are blocked for the time of one AES operation per 16 bytes
+ *       generated, plus three for the state update.
+ *
+ * @note Without a SoftDevice, the ECB peripheral is used with a private data structure, and the
+ *       key set through @ref nrf_ecb_set_key is not changed. An ECB operation started through
+ *       the ECB HAL must not be interrupted by a request.
+ */
+
+#ifndef APP_DRBG_H__
+#define APP_DRBG_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "app_drbg_config.h"
+
+/**@brief Generator statistics. */
+typedef struct
+{
+    uint32_t requests;          /**< Number of generate requests. */
+    uint32_t bytes;             /**< Number of random bytes produced. */
+    uint32_t reseeds;           /**< Number of reseeds from the entropy pool. */
+    uint32_t reseeds_missed;    /**< Number of times a reseed was due but the entropy pool was depleted. */
+} app_drbg_stats_t;
+
+/**@brief Function for initializing the generator.
+ *
+ * @details The RNG driver must be initialized before calling this function. The initial seed is
+ *          read from the RNG driver, so this function blocks until enough entropy is available.
+ *
+ * @retval NRF_SUCCESS              If the generator was seeded.
+ * @retval NRF_ERROR_INTERNAL       If the ECB peripheral failed.
+ * @return Any error returned by the RNG driver.
+ */
+ret_code_t app_drbg_init(void);
+
+/**@brief Function for getting random bytes.
+ *
+ * @param[out] p_buff   Destination buffer.
+ * @param[in]  length   Number of bytes to generate.
+ *
+ * @retval NRF_SUCCESS              If the buffer was filled with random bytes.
+ * @retval NRF_ERROR_INVALID_STATE  If the generator is not initialized.
+ * @retval NRF_ERROR_INTERNAL       If the ECB peripheral failed.
+ */
+ret_code_t app_drbg_rand(uint8_t * p_buff, uint32_t length);
+
+/**@brief Function for getting the generator statistics.
+ *
+ * @param[out] p_stats  Pointer to the structure to fill.
+ */
+void app_drbg_stats_get(app_drbg_stats_t * p_stats);
+
+#endif // APP_DRBG_H__
+
+/** @} */
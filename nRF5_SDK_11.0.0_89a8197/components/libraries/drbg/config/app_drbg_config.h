@@ -0,0 +1,37 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef APP_DRBG_CONFIG_H__
+#define APP_DRBG_CONFIG_H__
+
+ /**
+ * @file app_drbg_config.h
+ *
+ * @defgroup app_drbg_config Configuration options
+ * @ingroup app_drbg
+ * @{
+ * @brief   Configuration options for the random number generator.
+ */
+
+/**@brief   Configures the number of generate requests after which the generator is reseeded
+ *          from the hardware entropy pool.
+ */
+#define APP_DRBG_RESEED_INTERVAL    (16)
+
+/* A reseed takes 32 bytes (seedlen) from the entropy pool. If fewer are available when a reseed
+ * is due, they are kept, the reseed is postponed to the next request, and
+ * @ref app_drbg_stats_t::reseeds_missed is incremented.
+ */
+
+/** @} */
+
+#endif // APP_DRBG_CONFIG_H__
@@ -22,6 +22,9 @@
 #include "app_util.h"
 #include "nrf_log.h"
 #include "nrf_drv_rng.h"
+#ifdef APP_DRBG_ENABLED
+#include "app_drbg.h"
+#endif
 #include "ecc.h"
 
 #include "uECC.h"
@@ -31,7 +34,11 @@ static int ecc_rng(uint8_t *dest, unsigned size)
 {
     uint32_t errcode;
 
+#ifdef APP_DRBG_ENABLED
+    errcode = app_drbg_rand(dest, (uint32_t) size);
+#else
     errcode = nrf_drv_rng_block_rand(dest, (uint32_t) size);
+#endif
 
     return errcode == NRF_SUCCESS ? 1 : 0;
 }
@@ -0,0 +1,165 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "app_event_trace.h"
+#include <stdbool.h>
+#include <string.h>
+#include "nrf.h"
+#include "app_util.h"
+#include "fds.h"
+
+#define RING_MAGIC      (0x54524345)    /**< Marks a valid ring. */
+#define RING_MASK       (APP_EVENT_TRACE_SIZE - 1)
+
+STATIC_ASSERT((APP_EVENT_TRACE_SIZE & RING_MASK) == 0);
+
+// The ring must survive a reset, so it is placed in RAM that the startup code does not initialize.
+// This needs a matching scatter file or linker script, see the note in app_event_trace.h.
+#if defined ( __CC_ARM )
+static app_event_trace_ring_t m_ring __attribute__((section("NoInit"), zero_init));
+#elif defined ( __GNUC__ )
+__attribute__((section(".noinit"))) static app_event_trace_ring_t m_ring;
+#elif defined ( __ICCARM__ )
+__no_init static app_event_trace_ring_t m_ring;
+#endif
+
+static volatile bool m_recording;       /**< Entries are recorded. Cleared while the ring of the previous run is being saved. */
+static bool          m_save_pending;    /**< The ring holds the entries of the previous run. */
+
+
+static void ring_clear(uint32_t previous_count)
+{
+    m_ring.magic     = RING_MAGIC;
+    m_ring.magic_inv = ~RING_MAGIC;
+    m_ring.count     = 0;
+    m_recording      = true;
+
+    app_event_trace_record(APP_EVENT_TRACE_TYPE_BOOT, previous_count);
+}
+
+
+static void fds_evt_handler(fds_evt_t const * const p_evt)
+{
+    if (((p_evt->id == FDS_EVT_WRITE) || (p_evt->id == FDS_EVT_UPDATE)) &&
+        (p_evt->write.file_id    == APP_EVENT_TRACE_FILE_ID)               &&
+        (p_evt->write.record_key == APP_EVENT_TRACE_RECORD_KEY)            &&
+        m_save_pending)
+    {
+        // Resume recording also if the write failed, the old trace is lost in that case.
+        m_save_pending = false;
+        ring_clear(m_ring.count);
+    }
+}
+
+
+// Claims the next entry. The count is incremented atomically, so that entries recorded from
+// interrupts of different priorities never share a slot.
+static uint32_t count_claim(void)
+{
+    uint32_t count;
+
+#if (__CORTEX_M >= 0x03)
+    do
+    {
+        count = __LDREXW(&m_ring.count);
+    } while (__STREXW(count + 1, &m_ring.count) != 0);
+#else
+    // Masking interrupts for a few instructions is cheaper than a SoftDevice critical region.
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    count = m_ring.count++;
+    __set_PRIMASK(primask);
+#endif
+
+    return count;
+}
+
+
+ret_code_t app_event_trace_init(void)
+{
+    ret_code_t ret = fds_register(fds_evt_handler);
+
+    if (ret != FDS_SUCCESS)
+    {
+        return ret;
+    }
+
+    if ((m_ring.magic == RING_MAGIC) && (m_ring.magic_inv == ~RING_MAGIC) && (m_ring.count != 0))
+    {
+        m_save_pending = true;
+        m_recording    = false;
+    }
+    else
+    {
+        ring_clear(0);
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+ret_code_t app_event_trace_save(void)
+{
+    ret_code_t         ret;
+    fds_record_desc_t  desc;
+    fds_find_token_t   tok = {0};
+    fds_record_chunk_t chunk;
+    fds_record_t       record;
+
+    if (!m_save_pending)
+    {
+        return NRF_SUCCESS;
+    }
+
+    chunk.p_data       = &m_ring;
+    chunk.length_words = sizeof(m_ring) / sizeof(uint32_t);
+
+    record.file_id         = APP_EVENT_TRACE_FILE_ID;
+    record.key             = APP_EVENT_TRACE_RECORD_KEY;
+    record.data.p_chunks   = &chunk;
+    record.data.num_chunks = 1;
+
+    if (fds_record_find(APP_EVENT_TRACE_FILE_ID, APP_EVENT_TRACE_RECORD_KEY, &desc, &tok)
+        == FDS_SUCCESS)
+    {
+        ret = fds_record_update(&desc, &record);
+    }
+    else
+    {
+        ret = fds_record_write(&desc, &record);
+    }
+
+    if (ret != FDS_SUCCESS)
+    {
+        // No event follows a request that was not queued, so resume recording here.
+        m_save_pending = false;
+        ring_clear(m_ring.count);
+    }
+
+    return ret;
+}
+
+
+void app_event_trace_record(uint8_t type, uint32_t data)
+{
+    app_event_trace_entry_t * p_entry;
+
+    if (!m_recording)
+    {
+        return;
+    }
+
+    p_entry = &m_ring.entries[count_claim() & RING_MASK];
+
+    p_entry->type_timestamp = ((uint32_t)type << 24) | (APP_EVENT_TRACE_TIMESTAMP() & 0x00FFFFFF);
+    p_entry->data           = data;
+}
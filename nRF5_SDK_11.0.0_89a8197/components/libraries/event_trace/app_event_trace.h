@@ -0,0 +1,130 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup app_event_trace Event trace
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for keeping a history of recent events that survives a reset.
+ *
+ * @details The module records scheduler dispatches, BLE events, errors, and HardFaults in a ring
+ *          of @ref APP_EVENT_TRACE_SIZE entries, placed in RAM that is not initialized at startup.
+ *          Each entry holds a type, a 24-bit timestamp, and one word of data. Recording an entry
+ *          takes a few instructions, so the trace can be left on in production.
+ *
+ *          After a reset that retains RAM, such as a soft reset, a watchdog reset, or a reset
+ *          from a fault handler, @ref app_event_trace_init finds the ring of the previous run.
+ *          The ring is frozen until @ref app_event_trace_save has written it to flash with FDS,
+ *          and recording resumes when the write has completed.
+ *
+ *          When APP_EVENT_TRACE_ENABLED is defined in the project, the scheduler, the SoftDevice
+ *          handler, @ref app_error_handler and the HardFault handler record their events
+ *          automatically. The application can record its own events with
+ *          @ref app_event_trace_record, using types from @ref APP_EVENT_TRACE_TYPE_USER.
+ *
+ * @note    The ring only survives a reset if the linker leaves its section uninitialized. The
+ *          application linker scripts of the SDK do not do this, so the project must be changed:
+ *          - Keil: the ring is placed in the section "NoInit". Add an execution region with the
+ *            UNINIT attribute for it to the scatter file, outside the regions that hold the other
+ *            RW and ZI data, for example:
+ * @code
+ *  RW_NOINIT <address> UNINIT <size>
+ *  {
+ *    *(NoInit)
+ *  }
+ * @endcode
+ *            Without UNINIT, the zero_init section is cleared by the startup code like any other
+ *            ZI data.
+ *          - GCC: add a NOLOAD .noinit output section in RAM to the SECTIONS of the application
+ *            linker script, before nrf5x_common.ld is included. The DFU bootloader linker scripts
+ *            have a similar section.
+ * @code
+ *  .noinit(NOLOAD) :
+ *  {
+ *    *(.noinit)
+ *  } > RAM
+ * @endcode
+ *          - IAR: __no_init variables are not initialized by default.
+ */
+
+#ifndef APP_EVENT_TRACE_H__
+#define APP_EVENT_TRACE_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+#include "app_event_trace_config.h"
+
+/**@brief Entry types. */
+enum
+{
+    APP_EVENT_TRACE_TYPE_BOOT,          /**< Recording started. Data: number of entries in the previous run. */
+    APP_EVENT_TRACE_TYPE_SCHED,         /**< Scheduler dispatch. Data: address of the event handler. */
+    APP_EVENT_TRACE_TYPE_BLE_EVT,       /**< BLE event. Data: event ID in the lower 16 bits, connection handle in the upper 16 bits. */
+    APP_EVENT_TRACE_TYPE_ERROR,         /**< Error passed to @ref app_error_handler. Data: error code in the lower 16 bits, line number in the upper 16 bits. */
+    APP_EVENT_TRACE_TYPE_HARDFAULT,     /**< HardFault. Data: stacked program counter. */
+    APP_EVENT_TRACE_TYPE_USER = 0x80    /**< First type available to the application. */
+};
+
+/**@brief A trace entry. */
+typedef struct
+{
+    uint32_t type_timestamp;    /**< Entry type in the upper 8 bits, timestamp in the lower 24 bits. */
+    uint32_t data;              /**< Entry data. */
+} app_event_trace_entry_t;
+
+/**@brief Trace ring, as kept in RAM and saved to flash. */
+typedef struct
+{
+    uint32_t                magic;                          /**< Marks the ring as valid. */
+    uint32_t                magic_inv;                      /**< Inverse of @p magic. */
+    uint32_t                count;                          /**< Number of entries recorded since the ring was cleared. The oldest entry is at index count % @ref APP_EVENT_TRACE_SIZE once the ring has wrapped. */
+    app_event_trace_entry_t entries[APP_EVENT_TRACE_SIZE];  /**< Entries. */
+} app_event_trace_ring_t;
+
+/**@brief Function for initializing the module.
+ *
+ * @details Must be called before @ref fds_init. If the ring of the previous run is found in RAM,
+ *          recording is suspended until @ref app_event_trace_save has completed. Otherwise
+ *          recording starts immediately.
+ *
+ * @retval NRF_SUCCESS      The module was initialized.
+ * @return Errors from @ref fds_register.
+ */
+ret_code_t app_event_trace_init(void);
+
+/**@brief Function for saving the ring of the previous run to flash.
+ *
+ * @details Call this function after FDS has been initialized. The previous trace in flash is
+ *          replaced. Recording resumes when FDS reports the result of the write.
+ *
+ * @note    If the write cannot be queued, recording resumes at once and the trace of the
+ *          previous run is discarded.
+ *
+ * @retval NRF_SUCCESS              The write was queued, or there is nothing to save.
+ * @return Errors from @ref fds_record_write and @ref fds_record_update.
+ */
+ret_code_t app_event_trace_save(void);
+
+/**@brief Function for recording an entry.
+ *
+ * @details Can be called from any context, including HardFault handlers.
+ *
+ * @param[in] type  Entry type.
+ * @param[in] data  Entry data.
+ */
+void app_event_trace_record(uint8_t type, uint32_t data);
+
+#endif // APP_EVENT_TRACE_H__
+
+/** @} */
@@ -0,0 +1,46 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef APP_EVENT_TRACE_CONFIG_H__
+#define APP_EVENT_TRACE_CONFIG_H__
+
+ /**
+ * @file app_event_trace_config.h
+ *
+ * @defgroup app_event_trace_config Configuration options
+ * @ingroup app_event_trace
+ * @{
+ * @brief   Configuration options for the event trace.
+ */
+
+/**@brief   Configures the number of entries in the trace ring. Must be a power of two.
+ *
+ * Each entry takes 8 bytes of RAM, and the same amount of flash when the trace is saved.
+ */
+#define APP_EVENT_TRACE_SIZE            (64)
+
+/**@brief   Configures the FDS file ID of the saved trace. */
+#define APP_EVENT_TRACE_FILE_ID         (0xBFF0)
+
+/**@brief   Configures the FDS record key of the saved trace. */
+#define APP_EVENT_TRACE_RECORD_KEY      (0xBFF0)
+
+/**@brief   Configures the timestamp source.
+ *
+ * Only the lower 24 bits are kept. The default is the RTC1 counter, which runs when
+ * @ref app_timer is used.
+ */
+#define APP_EVENT_TRACE_TIMESTAMP()     (NRF_RTC1->COUNTER)
+
+/** @} */
+
+#endif // APP_EVENT_TRACE_CONFIG_H__
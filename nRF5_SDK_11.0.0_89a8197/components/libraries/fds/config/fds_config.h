@@ -58,6 +58,28 @@
     #define FDS_VIRTUAL_PAGE_SIZE   (1024)
 #endif
 
+/**@brief   The file ID used for storing the extents of large records.
+ *
+ * The application must not use this file ID for other records.
+ */
+#define FDS_LARGE_RECORD_FILE_ID        (0xBFFF)
+
+/**@brief   Configures the maximum number of extents that make up a large record.
+ *
+ * Each extent is stored as a separate record of up to one virtual page, so the largest record
+ * that can be stored is roughly @ref FDS_LARGE_RECORD_MAX_EXTENTS * @ref FDS_VIRTUAL_PAGE_SIZE
+ * words. It can never exceed the space available in the file system.
+ */
+#define FDS_LARGE_RECORD_MAX_EXTENTS    (8)
+
+/**@brief   Configures the priority of the flash operations of FDS in the fstorage queue.
+ *
+ * See @ref fs_config_t::op_priority. FDS writes small records and page tags, and completes
+ * garbage collection faster when they are not queued behind large stores or erases of other
+ * fstorage users.
+ */
+#define FDS_OP_PRIORITY                 (1)
+
 /** @} */
 
 #endif // FDS_CONFIG_H__
@@ -31,11 +31,12 @@ static void fs_event_handler(fs_evt_t const * const evt, fs_ret_t result);
 // Our fstorage configuration.
 FS_REGISTER_CFG(fs_config_t fs_config) =
 {
-    .callback  = fs_event_handler,
-    .num_pages = FDS_PHY_PAGES,
+    .callback    = fs_event_handler,
+    .num_pages   = FDS_PHY_PAGES,
     // We register with the highest priority in order to be assigned
     // the pages with the highest memory address (closest to the bootloader).
-    .priority  = 0xFF
+    .priority    = 0xFF,
+    .op_priority = FDS_OP_PRIORITY
 };
 
 // Used to flag a record as dirty, i.e. ready for garbage collection.
@@ -134,7 +135,7 @@ static void event_prepare(fds_op_t const * const p_op, fds_evt_t * const p_evt)
         case FDS_OP_DEL_FILE:
             p_evt->id             = FDS_EVT_DEL_FILE;
             p_evt->del.file_id    = p_op->del.file_id;
-            p_evt->del.record_key = FDS_RECORD_KEY_DIRTY;
+            p_evt->del.record_key = p_op->del.record_key;
             break;
 
         case FDS_OP_GC:
@@ -796,7 +797,8 @@ static ret_code_t record_find_and_delete(fds_op_t * const p_op)
 }
 
 
-// Finds a record within a file and flags it as dirty.
+// Finds a record within a file and flags it as dirty. If a record key is set in the operation,
+// only records with that key are deleted.
 static ret_code_t file_find_and_delete(fds_op_t * const p_op)
 {
     ret_code_t        ret;
@@ -806,7 +808,10 @@ static ret_code_t file_find_and_delete(fds_op_t * const p_op)
     static fds_find_token_t tok = {0};
 
     // Pass NULL to ignore the record key.
-    ret = record_find(&p_op->del.file_id, NULL, &desc, &tok);
+    uint16_t const * p_key = (p_op->del.record_key != FDS_RECORD_KEY_DIRTY) ?
+                             &p_op->del.record_key : NULL;
+
+    ret = record_find(&p_op->del.file_id, p_key, &desc, &tok);
 
     if (ret == FDS_SUCCESS)
     {
@@ -1891,9 +1896,10 @@ ret_code_t fds_file_delete(uint16_t file_id)
         return FDS_ERR_INVALID_ARG;
     }
 
-    op.op_code      = FDS_OP_DEL_FILE;
-    op.del.step     = FDS_OP_DEL_FILE_FLAG_DIRTY;
-    op.del.file_id  = file_id;
+    op.op_code        = FDS_OP_DEL_FILE;
+    op.del.step       = FDS_OP_DEL_FILE_FLAG_DIRTY;
+    op.del.file_id    = file_id;
+    op.del.record_key = FDS_RECORD_KEY_DIRTY;
 
     if (op_enqueue(&op, 0, NULL))
     {
@@ -2038,6 +2044,447 @@ ret_code_t fds_stat(fds_stat_t * const p_stat)
 }
 
 
+// Large records.
+//
+// The head record data is laid out as follows (in 4-byte words):
+//   [0] FDS_LARGE_RECORD_MAGIC
+//   [1] total length of the record data
+//   [2] extent length (low 16 bits) and extent record key (high 16 bits)
+//   [3] number of extents
+//   [4] record IDs of the extents, in order.
+//
+// Each extent is a record in the file FDS_LARGE_RECORD_FILE_ID. All extents of one large record
+// share a record key, so that they can be deleted in one operation. The extent data starts with
+// the file ID and record key of the head and the index of the extent, which are used to verify
+// reads and to find extents that do not belong to any large record.
+
+#define FDS_LARGE_RECORD_MAGIC          (0xF11E1A26)
+#define FDS_LARGE_HEAD_OFFSET_MAGIC     (0)
+#define FDS_LARGE_HEAD_OFFSET_LENGTH    (1)
+#define FDS_LARGE_HEAD_OFFSET_EXTENT    (2)
+#define FDS_LARGE_HEAD_OFFSET_COUNT     (3)
+#define FDS_LARGE_EXTENT_HEADER_SIZE    (2) // Size of the extent header, in 4-byte words.
+#define FDS_LARGE_EXTENT_MAX_WORDS      (FDS_PAGE_SIZE - FDS_PAGE_TAG_SIZE - FDS_HEADER_SIZE - \
+                                         FDS_LARGE_EXTENT_HEADER_SIZE - 1)
+#define FDS_RECORD_KEY_MAX              (0xBFFF)
+
+// The last extent record key handed out, so that large records written concurrently do not
+// share a key before any of their extents are in flash.
+static uint16_t m_large_key_last;
+
+
+static uint32_t large_owner_word(uint16_t file_id, uint16_t record_key)
+{
+    return (file_id | ((uint32_t)record_key << 16));
+}
+
+
+// Returns a record key not used by the extents currently stored in flash.
+static uint16_t large_extent_key_new(void)
+{
+    fds_record_desc_t desc;
+    fds_find_token_t  tok     = {0};
+    uint16_t const    file_id = FDS_LARGE_RECORD_FILE_ID;
+    uint16_t          key_max = m_large_key_last;
+    uint16_t          key;
+
+    while (record_find(&file_id, NULL, &desc, &tok) == FDS_SUCCESS)
+    {
+        key = ((fds_header_t const *)desc.p_record)->tl.record_key;
+        if (key > key_max)
+        {
+            key_max = key;
+        }
+    }
+
+    if (key_max < FDS_RECORD_KEY_MAX)
+    {
+        return (key_max + 1);
+    }
+
+    // All keys above the largest one are used up: find the first free key.
+    for (key = 1; key <= FDS_RECORD_KEY_MAX; key++)
+    {
+        memset(&tok, 0x00, sizeof(tok));
+        if (record_find(&file_id, &key, &desc, &tok) == FDS_ERR_NOT_FOUND)
+        {
+            return key;
+        }
+    }
+
+    return FDS_RECORD_KEY_DIRTY;
+}
+
+
+// Opens the head of a large record and checks its magic word.
+static ret_code_t large_head_open(fds_record_desc_t  * const p_desc,
+                                  uint32_t const    ** const pp_head,
+                                  uint16_t           * const p_head_words)
+{
+    ret_code_t         ret;
+    fds_flash_record_t rec;
+
+    ret = fds_record_open(p_desc, &rec);
+    if (ret != FDS_SUCCESS)
+    {
+        return ret;
+    }
+
+    *pp_head      = (uint32_t const *)rec.p_data;
+    *p_head_words = rec.p_header->tl.length_words;
+
+    if ((*p_head_words < FDS_LARGE_RECORD_HEAD_WORDS)                                    ||
+        ((*pp_head)[FDS_LARGE_HEAD_OFFSET_MAGIC] != FDS_LARGE_RECORD_MAGIC)              ||
+        (*p_head_words < FDS_LARGE_RECORD_HEAD_WORDS + (*pp_head)[FDS_LARGE_HEAD_OFFSET_COUNT]))
+    {
+        (void)fds_record_close(p_desc);
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_large_record_write_begin(fds_large_record_ctx_t * const p_ctx,
+                                        uint16_t                       file_id,
+                                        uint16_t                       record_key,
+                                        uint16_t                       extent_words)
+{
+    if (!flag_is_set(FDS_FLAG_INITIALIZED))
+    {
+        return FDS_ERR_NOT_INITIALIZED;
+    }
+
+    if (p_ctx == NULL)
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    if ((file_id    == FDS_FILE_ID_INVALID)      ||
+        (file_id    == FDS_LARGE_RECORD_FILE_ID) ||
+        (record_key == FDS_RECORD_KEY_DIRTY))
+    {
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    if ((extent_words == 0) || (extent_words > FDS_LARGE_EXTENT_MAX_WORDS))
+    {
+        return FDS_ERR_RECORD_TOO_LARGE;
+    }
+
+    memset(p_ctx, 0x00, sizeof(fds_large_record_ctx_t));
+
+    CRITICAL_SECTION_ENTER();
+    p_ctx->extent_key = large_extent_key_new();
+    m_large_key_last  = p_ctx->extent_key;
+    CRITICAL_SECTION_EXIT();
+
+    if (p_ctx->extent_key == FDS_RECORD_KEY_DIRTY)
+    {
+        return FDS_ERR_NO_SPACE_IN_FLASH;
+    }
+
+    p_ctx->file_id      = file_id;
+    p_ctx->record_key   = record_key;
+    p_ctx->extent_words = extent_words;
+
+    p_ctx->head[FDS_LARGE_HEAD_OFFSET_MAGIC]  = FDS_LARGE_RECORD_MAGIC;
+    p_ctx->head[FDS_LARGE_HEAD_OFFSET_EXTENT] = extent_words | ((uint32_t)p_ctx->extent_key << 16);
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_large_record_write_extent(fds_large_record_ctx_t * const p_ctx,
+                                         void             const * const p_data,
+                                         uint16_t                       length_words)
+{
+    ret_code_t         ret;
+    fds_record_desc_t  desc;
+    fds_record_chunk_t chunks[2];
+    fds_record_t       record;
+    uint32_t           index;
+
+    if ((p_ctx == NULL) || (p_data == NULL))
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    index = p_ctx->head[FDS_LARGE_HEAD_OFFSET_COUNT];
+
+    // Only the last extent may be shorter than the extent length.
+    if ((length_words == 0) ||
+        (p_ctx->head[FDS_LARGE_HEAD_OFFSET_LENGTH] != index * p_ctx->extent_words))
+    {
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    if ((length_words > p_ctx->extent_words) || (index >= FDS_LARGE_RECORD_MAX_EXTENTS))
+    {
+        return FDS_ERR_RECORD_TOO_LARGE;
+    }
+
+    p_ctx->extent_header[index][0] = large_owner_word(p_ctx->file_id, p_ctx->record_key);
+    p_ctx->extent_header[index][1] = index;
+
+    chunks[0].p_data       = p_ctx->extent_header[index];
+    chunks[0].length_words = FDS_LARGE_EXTENT_HEADER_SIZE;
+    chunks[1].p_data       = p_data;
+    chunks[1].length_words = length_words;
+
+    record.file_id         = FDS_LARGE_RECORD_FILE_ID;
+    record.key             = p_ctx->extent_key;
+    record.data.p_chunks   = chunks;
+    record.data.num_chunks = 2;
+
+    ret = fds_record_write(&desc, &record);
+    if (ret != FDS_SUCCESS)
+    {
+        return ret;
+    }
+
+    p_ctx->head[FDS_LARGE_RECORD_HEAD_WORDS + index] = desc.record_id;
+    p_ctx->head[FDS_LARGE_HEAD_OFFSET_COUNT]         = index + 1;
+    p_ctx->head[FDS_LARGE_HEAD_OFFSET_LENGTH]       += length_words;
+
+    return FDS_SUCCESS;
+}
+
+
+ret_code_t fds_large_record_write_end(fds_large_record_ctx_t * const p_ctx,
+                                      fds_record_desc_t      * const p_desc)
+{
+    fds_record_chunk_t chunk;
+    fds_record_t       record;
+
+    if (p_ctx == NULL)
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    if (p_ctx->head[FDS_LARGE_HEAD_OFFSET_COUNT] == 0)
+    {
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    chunk.p_data       = p_ctx->head;
+    chunk.length_words = FDS_LARGE_RECORD_HEAD_WORDS + p_ctx->head[FDS_LARGE_HEAD_OFFSET_COUNT];
+
+    record.file_id         = p_ctx->file_id;
+    record.key             = p_ctx->record_key;
+    record.data.p_chunks   = &chunk;
+    record.data.num_chunks = 1;
+
+    return fds_record_write(p_desc, &record);
+}
+
+
+ret_code_t fds_large_record_length_get(fds_record_desc_t * const p_desc,
+                                       uint32_t          * const p_length_words)
+{
+    ret_code_t       ret;
+    uint32_t const * p_head;
+    uint16_t         head_words;
+
+    if ((p_desc == NULL) || (p_length_words == NULL))
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    ret = large_head_open(p_desc, &p_head, &head_words);
+    if (ret != FDS_SUCCESS)
+    {
+        return ret;
+    }
+
+    *p_length_words = p_head[FDS_LARGE_HEAD_OFFSET_LENGTH];
+
+    return fds_record_close(p_desc);
+}
+
+
+ret_code_t fds_large_record_read(fds_record_desc_t * const p_desc,
+                                 uint32_t                  offset_words,
+                                 void              * const p_dest,
+                                 uint32_t                  length_words)
+{
+    ret_code_t       ret;
+    uint32_t const * p_head;
+    uint16_t         head_words;
+    uint16_t         extent_words;
+    uint32_t       * p_out = (uint32_t *)p_dest;
+
+    if ((p_desc == NULL) || (p_dest == NULL))
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    ret = large_head_open(p_desc, &p_head, &head_words);
+    if (ret != FDS_SUCCESS)
+    {
+        return ret;
+    }
+
+    extent_words = (uint16_t)p_head[FDS_LARGE_HEAD_OFFSET_EXTENT];
+
+    if ((offset_words > p_head[FDS_LARGE_HEAD_OFFSET_LENGTH]) ||
+        (length_words > p_head[FDS_LARGE_HEAD_OFFSET_LENGTH] - offset_words))
+    {
+        (void)fds_record_close(p_desc);
+        return FDS_ERR_INVALID_ARG;
+    }
+
+    while ((length_words > 0) && (ret == FDS_SUCCESS))
+    {
+        fds_record_desc_t  extent_desc = {0};
+        fds_flash_record_t extent;
+        uint32_t const     index       = offset_words / extent_words;
+        uint32_t const     skip        = offset_words % extent_words;
+        uint32_t           copy;
+
+        extent_desc.record_id = p_head[FDS_LARGE_RECORD_HEAD_WORDS + index];
+
+        ret = fds_record_open(&extent_desc, &extent);
+        if (ret != FDS_SUCCESS)
+        {
+            break;
+        }
+
+        uint32_t const * const p_extent = (uint32_t const *)extent.p_data;
+        uint16_t const         data_len = extent.p_header->tl.length_words -
+                                          FDS_LARGE_EXTENT_HEADER_SIZE;
+
+        if ((p_extent[1] != index) || (skip >= data_len))
+        {
+            ret = FDS_ERR_NOT_FOUND;
+        }
+        else
+        {
+            copy = (length_words < data_len - skip) ? length_words : (data_len - skip);
+            memcpy(p_out, &p_extent[FDS_LARGE_EXTENT_HEADER_SIZE + skip], copy * sizeof(uint32_t));
+
+            p_out        += copy;
+            offset_words += copy;
+            length_words -= copy;
+        }
+
+        (void)fds_record_close(&extent_desc);
+    }
+
+    (void)fds_record_close(p_desc);
+
+    return ret;
+}
+
+
+ret_code_t fds_large_record_delete(fds_record_desc_t * const p_desc)
+{
+    ret_code_t       ret;
+    fds_op_t         op;
+    uint32_t const * p_head;
+    uint16_t         head_words;
+
+    if (p_desc == NULL)
+    {
+        return FDS_ERR_NULL_ARG;
+    }
+
+    ret = large_head_open(p_desc, &p_head, &head_words);
+    if (ret != FDS_SUCCESS)
+    {
+        return ret;
+    }
+
+    op.op_code        = FDS_OP_DEL_FILE;
+    op.del.step       = FDS_OP_DEL_FILE_FLAG_DIRTY;
+    op.del.file_id    = FDS_LARGE_RECORD_FILE_ID;
+    op.del.record_key = (uint16_t)(p_head[FDS_LARGE_HEAD_OFFSET_EXTENT] >> 16);
+
+    (void)fds_record_close(p_desc);
+
+    // Delete the head first, so that the record disappears as a whole.
+    ret = fds_record_delete(p_desc);
+    if (ret != FDS_SUCCESS)
+    {
+        return ret;
+    }
+
+    if (!op_enqueue(&op, 0, NULL))
+    {
+        return FDS_ERR_NO_SPACE_IN_QUEUES;
+    }
+
+    queue_start();
+
+    return FDS_SUCCESS;
+}
+
+
+// Checks whether a large record head with the given extent key exists at the owner given in
+// an extent.
+static bool large_extent_has_owner(uint32_t owner, uint16_t extent_key)
+{
+    fds_record_desc_t desc;
+    fds_find_token_t  tok = {0};
+    bool              found = false;
+
+    while (!found &&
+           (fds_record_find((uint16_t)owner, (uint16_t)(owner >> 16), &desc, &tok) == FDS_SUCCESS))
+    {
+        uint32_t const * p_head;
+        uint16_t         head_words;
+
+        if (large_head_open(&desc, &p_head, &head_words) == FDS_SUCCESS)
+        {
+            found = ((uint16_t)(p_head[FDS_LARGE_HEAD_OFFSET_EXTENT] >> 16) == extent_key);
+            (void)fds_record_close(&desc);
+        }
+    }
+
+    return found;
+}
+
+
+ret_code_t fds_large_record_orphans_delete(void)
+{
+    fds_record_desc_t desc;
+    fds_find_token_t  tok     = {0};
+    uint16_t const    file_id = FDS_LARGE_RECORD_FILE_ID;
+    fds_op_t          op;
+
+    if (!flag_is_set(FDS_FLAG_INITIALIZED))
+    {
+        return FDS_ERR_NOT_INITIALIZED;
+    }
+
+    while (record_find(&file_id, NULL, &desc, &tok) == FDS_SUCCESS)
+    {
+        fds_header_t const * const p_header = (fds_header_t const *)desc.p_record;
+        uint32_t     const * const p_extent = desc.p_record + FDS_HEADER_SIZE;
+
+        if (large_extent_has_owner(p_extent[0], p_header->tl.record_key))
+        {
+            continue;
+        }
+
+        op.op_code        = FDS_OP_DEL_FILE;
+        op.del.step       = FDS_OP_DEL_FILE_FLAG_DIRTY;
+        op.del.file_id    = FDS_LARGE_RECORD_FILE_ID;
+        op.del.record_key = p_header->tl.record_key;
+
+        if (!op_enqueue(&op, 0, NULL))
+        {
+            return FDS_ERR_NO_SPACE_IN_QUEUES;
+        }
+
+        queue_start();
+        return FDS_SUCCESS;
+    }
+
+    return FDS_ERR_NOT_FOUND;
+}
+
+
 #if defined(FDS_CRC_ENABLED)
 
 ret_code_t fds_verify_crc_on_writes(bool enable)
@@ -29,6 +29,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "sdk_errors.h"
+#include "fds_config.h"
 
 
 /**@brief   Invalid file ID.
@@ -707,6 +708,174 @@ ret_code_t fds_record_id_from_desc(fds_record_desc_t const * const p_desc,
 ret_code_t fds_stat(fds_stat_t * const p_stat);
 
 
+/**@brief   Number of words at the start of a large record head used by FDS.
+ */
+#define FDS_LARGE_RECORD_HEAD_WORDS     (4)
+
+
+/**@brief   Context of a large record write.
+ *
+ * A large record is stored as a number of extents, each an ordinary record in the file
+ * @ref FDS_LARGE_RECORD_FILE_ID, and one head record with the file ID and record key given by the
+ * application. The head lists the extents, so the large record is only visible once the head has
+ * been written. Garbage collection moves extents like any other record.
+ *
+ * The context must be kept in memory until the last write has completed.
+ * Its fields must not be modified by the application.
+ */
+typedef struct
+{
+    uint16_t file_id;                                       //!< File ID of the head record.
+    uint16_t record_key;                                    //!< Record key of the head record.
+    uint16_t extent_key;                                    //!< Record key shared by the extents.
+    uint16_t extent_words;                                  //!< Length of every extent except the last one, in 4-byte words.
+    uint32_t extent_header[FDS_LARGE_RECORD_MAX_EXTENTS][2];//!< Owner (file ID and record key) and index of each extent, stored in front of its data.
+
+    /**@brief   Head record data: a magic word, the total length in words, the extent length and
+     *          key, the number of extents, and the record IDs of the extents.
+     */
+    uint32_t head[FDS_LARGE_RECORD_HEAD_WORDS + FDS_LARGE_RECORD_MAX_EXTENTS];
+} fds_large_record_ctx_t;
+
+
+/**@brief   Function for starting to write a large record.
+ *
+ * Large records are written one extent at a time using @ref fds_large_record_write_extent, so that
+ * only one extent needs to be kept in memory at a time. The record is completed with
+ * @ref fds_large_record_write_end.
+ *
+ * @param[out]  p_ctx           Context of the write.
+ * @param[in]   file_id         The file ID of the record.
+ * @param[in]   record_key      The record key.
+ * @param[in]   extent_words    Length of the extents, in 4-byte words. It must not exceed
+ *                              @ref FDS_VIRTUAL_PAGE_SIZE minus 8 words (the page tag, the record
+ *                              header and the extent header, and a record must be shorter than the
+ *                              space left after the page tag). Shorter extents are easier to place
+ *                              in flash that is partially used.
+ *
+ * @retval  FDS_SUCCESS                 If the write was started.
+ * @retval  FDS_ERR_NOT_INITIALIZED     If the module is not initialized.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_ctx is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If the file ID or the record key is invalid.
+ * @retval  FDS_ERR_RECORD_TOO_LARGE    If @p extent_words is zero or too large.
+ * @retval  FDS_ERR_NO_SPACE_IN_FLASH   If no extent record key is available.
+ */
+ret_code_t fds_large_record_write_begin(fds_large_record_ctx_t * const p_ctx,
+                                        uint16_t                       file_id,
+                                        uint16_t                       record_key,
+                                        uint16_t                       extent_words);
+
+
+/**@brief   Function for writing the next extent of a large record.
+ *
+ * All extents except the last one must be exactly as long as the extent length given to
+ * @ref fds_large_record_write_begin. The data must be aligned to a 4 byte boundary, and must be
+ * kept in memory until the @ref FDS_EVT_WRITE event for the extent has been received.
+ *
+ * @param[in]   p_ctx           Context of the write.
+ * @param[in]   p_data          Extent data.
+ * @param[in]   length_words    Length of the extent data, in 4-byte words.
+ *
+ * @retval  FDS_SUCCESS                 If the extent was queued for writing.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_ctx or @p p_data is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If the previous extent was shorter than the extent length,
+ *                                      or @p length_words is zero.
+ * @retval  FDS_ERR_RECORD_TOO_LARGE    If the extent is too long, or the record already has
+ *                                      @ref FDS_LARGE_RECORD_MAX_EXTENTS extents.
+ * @return  Other return values from @ref fds_record_write.
+ */
+ret_code_t fds_large_record_write_extent(fds_large_record_ctx_t * const p_ctx,
+                                         void             const * const p_data,
+                                         uint16_t                       length_words);
+
+
+/**@brief   Function for completing a large record by writing its head.
+ *
+ * Completion is reported through an @ref FDS_EVT_WRITE event for the head record.
+ *
+ * @param[in]   p_ctx           Context of the write.
+ * @param[out]  p_desc          The descriptor of the large record. Pass NULL if you do not need
+ *                              the descriptor.
+ *
+ * @retval  FDS_SUCCESS                 If the head was queued for writing.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_ctx is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If no extent has been written.
+ * @return  Other return values from @ref fds_record_write.
+ */
+ret_code_t fds_large_record_write_end(fds_large_record_ctx_t * const p_ctx,
+                                      fds_record_desc_t      * const p_desc);
+
+
+/**@brief   Function for retrieving the length of a large record.
+ *
+ * @param[in]   p_desc          The descriptor of the large record (its head record).
+ * @param[out]  p_length_words  The length of the record data, in 4-byte words.
+ *
+ * @retval  FDS_SUCCESS                 If the length was retrieved.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_desc or @p p_length_words is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If the record is not a large record.
+ * @return  Other return values from @ref fds_record_open.
+ */
+ret_code_t fds_large_record_length_get(fds_record_desc_t * const p_desc,
+                                       uint32_t          * const p_length_words);
+
+
+/**@brief   Function for reading part of a large record.
+ *
+ * The data is copied from flash, so that the large record does not need to be kept open.
+ *
+ * @param[in]   p_desc          The descriptor of the large record (its head record).
+ * @param[in]   offset_words    Offset of the first word to read.
+ * @param[out]  p_dest          Buffer for the data.
+ * @param[in]   length_words    Number of words to read.
+ *
+ * @retval  FDS_SUCCESS                 If the data was read.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_desc or @p p_dest is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If the record is not a large record, or the range
+ *                                      exceeds the record.
+ * @retval  FDS_ERR_NOT_FOUND           If an extent is missing.
+ * @return  Other return values from @ref fds_record_open.
+ */
+ret_code_t fds_large_record_read(fds_record_desc_t * const p_desc,
+                                 uint32_t                  offset_words,
+                                 void              * const p_dest,
+                                 uint32_t                  length_words);
+
+
+/**@brief   Function for deleting a large record.
+ *
+ * The head record is deleted first, followed by all extents. Completion is reported through an
+ * @ref FDS_EVT_DEL_RECORD event for the head and an @ref FDS_EVT_DEL_FILE event with file ID
+ * @ref FDS_LARGE_RECORD_FILE_ID for the extents.
+ *
+ * @param[in]   p_desc          The descriptor of the large record (its head record).
+ *
+ * @retval  FDS_SUCCESS                 If the operations were queued successfully.
+ * @retval  FDS_ERR_NULL_ARG            If @p p_desc is NULL.
+ * @retval  FDS_ERR_INVALID_ARG         If the record is not a large record.
+ * @retval  FDS_ERR_NO_SPACE_IN_QUEUES  If the operation queue is full. If the head was deleted,
+ *                                      the extents are left behind and can be removed using
+ *                                      @ref fds_large_record_orphans_delete.
+ * @return  Other return values from @ref fds_record_open.
+ */
+ret_code_t fds_large_record_delete(fds_record_desc_t * const p_desc);
+
+
+/**@brief   Function for deleting extents that do not belong to any large record.
+ *
+ * Extents are left behind when a write is never completed, for example because of a reset, or
+ * when a delete could only be partially queued. This function queues the deletion of the extents
+ * of one such record. Call it again after the @ref FDS_EVT_DEL_FILE event until it returns
+ * @ref FDS_ERR_NOT_FOUND. Do not call it while a large record is being written.
+ *
+ * @retval  FDS_SUCCESS                 If the deletion of orphaned extents was queued.
+ * @retval  FDS_ERR_NOT_FOUND           If there are no orphaned extents.
+ * @retval  FDS_ERR_NOT_INITIALIZED     If the module is not initialized.
+ * @retval  FDS_ERR_NO_SPACE_IN_QUEUES  If the operation queue is full.
+ */
+ret_code_t fds_large_record_orphans_delete(void);
+
+
 #if defined(FDS_CRC_ENABLED)
 
 /**@brief   Function for enabling and disabling CRC verification for write operations.
@@ -28,7 +28,7 @@
  *          increase the queue size if you frequently receive @ref FS_ERR_QUEUE_FULL errors when
  *          calling @ref fs_store or @ref fs_erase.
  */
-#define FS_QUEUE_SIZE       (4)
+#define FS_QUEUE_SIZE       (8)
 
 /**@brief   Configures how many times should fstorage attempt to execute an operation if
  *          the SoftDevice fails to schedule flash access due to high BLE activity.
@@ -53,6 +53,22 @@
     #define FS_MAX_WRITE_SIZE_WORDS     (1024)
 #endif
 
+
+/**@brief   Configures whether contiguous stores from the same user are merged.
+ * @details When enabled, a store operation and the following store operations queued by the same
+ *          user are written to flash in a single call to @ref sd_flash_write, if both their
+ *          sources and destinations are contiguous and the total length does not exceed
+ *          @ref FS_MAX_WRITE_SIZE_WORDS. One event is still sent for every call to @ref fs_store.
+ */
+#define FS_STORE_MERGE_ENABLED  (1)
+
+
+/**@brief   Configures the time source used for queue wait time statistics.
+ * @details Must expand to a free-running 32-bit counter. If not defined, wait times are counted
+ *          in flash operations executed by fstorage while the operation was queued.
+ */
+//#define FS_QUEUE_TIMESTAMP_GET()    (DWT->CYCCNT)
+
 /** @} */
 
 #endif // FS_CONFIG_H__
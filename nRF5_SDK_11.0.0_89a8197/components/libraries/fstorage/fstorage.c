@@ -19,11 +19,19 @@
 #include <stdbool.h>
 #include "nrf_error.h"
 #include "nrf_soc.h"
+#include "app_util_platform.h"
 
 
 static uint8_t       m_flags;       // fstorage status flags.
 static fs_op_queue_t m_queue;       // Queue of requested operations.
 static uint8_t       m_retry_count; // Number of times the last flash operation was retried.
+static uint32_t      m_seq;         // Sequence number of the last queued operation.
+static fs_stats_t    m_stats;       // Queue statistics.
+
+
+#ifndef FS_QUEUE_TIMESTAMP_GET
+    #define FS_QUEUE_TIMESTAMP_GET()    (m_stats.flash_ops)
+#endif
 
 
 // Sends events to the application.
@@ -69,57 +77,211 @@ static bool check_config(fs_config_t const * const config)
 }
 
 
-// Executes a store operation.
-static uint32_t store_execute(fs_op_t const * const p_op)
+// Returns true if the operation at index a should be executed before the one at index b.
+static bool op_precedes(uint32_t a, uint32_t b)
 {
-    uint16_t chunk_len;
+    uint8_t const prio_a = m_queue.op[a].p_config->op_priority;
+    uint8_t const prio_b = m_queue.op[b].p_config->op_priority;
+
+    if (prio_a != prio_b)
+    {
+        return (prio_a > prio_b);
+    }
+
+    // Compare sequence numbers, allowing for wrap-around.
+    return ((int32_t)(m_queue.op[a].seq - m_queue.op[b].seq) < 0);
+}
+
+
+// Selects the operation to be executed next.
+// Returns false, and leaves the current operation unchanged, if no operation is queued.
+static bool queue_select(void)
+{
+    uint32_t next = FS_QUEUE_SIZE;
+
+    for (uint32_t i = 0; i < FS_QUEUE_SIZE; i++)
+    {
+        if (m_queue.op[i].op_code == FS_OP_NONE)
+        {
+            continue;
+        }
+
+        if ((next == FS_QUEUE_SIZE) || op_precedes(i, next))
+        {
+            next = i;
+        }
+    }
 
+    if (next == FS_QUEUE_SIZE)
+    {
+        return false;
+    }
+
+    if ((next != m_queue.cur)                            &&
+        (m_queue.cur < FS_QUEUE_SIZE)                    &&
+        (m_queue.op[m_queue.cur].op_code != FS_OP_NONE)  &&
+        (m_queue.op[m_queue.cur].started))
+    {
+        // The operation being processed has not finished, but another one goes first.
+        m_stats.preempted++;
+    }
+
+    m_queue.cur = next;
+
+    return true;
+}
+
+
+// Returns the number of words of a store operation to be written by the next flash operation.
+static uint16_t store_chunk_len(fs_op_t const * const p_op)
+{
     if ((p_op->store.length_words - p_op->store.offset) < FS_MAX_WRITE_SIZE_WORDS)
     {
-        chunk_len = p_op->store.length_words - p_op->store.offset;
+        return (p_op->store.length_words - p_op->store.offset);
     }
-    else
+
+    return FS_MAX_WRITE_SIZE_WORDS;
+}
+
+
+// Adds an operation to the batch written by the next flash operation.
+static void batch_add(uint32_t idx, uint16_t words)
+{
+    fs_op_t * const p_op = &m_queue.op[idx];
+
+    if (!p_op->started)
     {
-        chunk_len = FS_MAX_WRITE_SIZE_WORDS;
+        uint32_t const wait = FS_QUEUE_TIMESTAMP_GET() - p_op->timestamp;
+
+        p_op->started      = true;
+        m_stats.wait_total += wait;
+        if (wait > m_stats.wait_max)
+        {
+            m_stats.wait_max = wait;
+        }
+    }
+
+    m_queue.batch[m_queue.batch_count]       = idx;
+    m_queue.batch_words[m_queue.batch_count] = words;
+    m_queue.batch_count++;
+}
+
+
+#if FS_STORE_MERGE_ENABLED
+// Finds the store queued by the same user right after the operation at index idx, and returns
+// its index if it continues the data of that operation both in RAM and in flash.
+// Returns FS_QUEUE_SIZE otherwise.
+static uint32_t store_successor_find(uint32_t idx)
+{
+    fs_op_t const * const p_op = &m_queue.op[idx];
+    uint32_t              next = FS_QUEUE_SIZE;
+
+    for (uint32_t i = 0; i < FS_QUEUE_SIZE; i++)
+    {
+        fs_op_t const * const p_candidate = &m_queue.op[i];
+
+        if ((p_candidate->op_code  == FS_OP_NONE)     ||
+            (p_candidate->p_config != p_op->p_config) ||
+            ((int32_t)(p_candidate->seq - p_op->seq) <= 0))
+        {
+            continue;
+        }
+
+        if ((next == FS_QUEUE_SIZE) || ((int32_t)(p_candidate->seq - m_queue.op[next].seq) < 0))
+        {
+            next = i;
+        }
+    }
+
+    if ((next != FS_QUEUE_SIZE)                                                                &&
+        (m_queue.op[next].op_code      == FS_OP_STORE)                                         &&
+        (m_queue.op[next].store.offset == 0)                                                   &&
+        (m_queue.op[next].store.p_dest == p_op->store.p_dest + p_op->store.length_words)       &&
+        (m_queue.op[next].store.p_src  == p_op->store.p_src  + p_op->store.length_words))
+    {
+        return next;
+    }
+
+    return FS_QUEUE_SIZE;
+}
+#endif
+
+
+// Executes a store operation, together with the stores that can be merged with it.
+static uint32_t store_execute(fs_op_t const * const p_op)
+{
+    uint16_t length = store_chunk_len(p_op);
+
+    batch_add(m_queue.cur, length);
+
+#if FS_STORE_MERGE_ENABLED
+    // Only merge if the current operation finishes with this flash operation.
+    if (p_op->store.offset + length == p_op->store.length_words)
+    {
+        uint32_t idx = m_queue.cur;
+
+        while ((idx = store_successor_find(idx)) != FS_QUEUE_SIZE)
+        {
+            uint16_t const next_len = m_queue.op[idx].store.length_words;
+
+            if (length + next_len > FS_MAX_WRITE_SIZE_WORDS)
+            {
+                break;
+            }
+
+            batch_add(idx, next_len);
+            length += next_len;
+            m_stats.merged++;
+        }
     }
+#endif
 
     return sd_flash_write((uint32_t*)p_op->store.p_dest + p_op->store.offset,
                           (uint32_t*)p_op->store.p_src  + p_op->store.offset,
-                          chunk_len);
+                          length);
 }
 
 
 // Executes an erase operation.
 static uint32_t erase_execute(fs_op_t const * const p_op)
 {
+    batch_add(m_queue.cur, 0);
+
     return sd_flash_page_erase(p_op->erase.page);
 }
 
 
-// Advances the queue, wrapping around if necessary.
+// Frees an element of the queue.
 // If no elements are left in the queue, clears the FS_FLAG_PROCESSING flag.
-static void queue_advance(void)
+static void queue_free(uint32_t idx)
 {
+    m_queue.op[idx].op_code = FS_OP_NONE;
+
     if (--m_queue.count == 0)
     {
         m_flags &= ~FS_FLAG_PROCESSING;
     }
-
-    if (++m_queue.rp == FS_QUEUE_SIZE)
-    {
-        m_queue.rp = 0;
-    }
 }
 
 
-// Processes the current element in the queue. If the queue is empty, does nothing.
+// Processes the next element in the queue. If the queue is empty, does nothing.
 static void queue_process(void)
 {
-    uint32_t         ret;
-    fs_op_t  * const p_op = &m_queue.op[m_queue.rp];
+    uint32_t  ret;
+    fs_op_t * p_op;
 
-    if (m_queue.count > 0)
+    while (m_queue.count > 0)
     {
+        // A failed flash operation is retried before any other operation is executed.
+        if ((m_retry_count == 0) && !queue_select())
+        {
+            m_flags &= ~FS_FLAG_PROCESSING;
+            break;
+        }
+
+        p_op                = &m_queue.op[m_queue.cur];
+        m_queue.batch_count = 0;
+
         switch (p_op->op_code)
         {
             case FS_OP_STORE:
@@ -144,13 +306,19 @@ static void queue_process(void)
         }
         else if (ret != NRF_SUCCESS)
         {
-            // An error has occurred.
+            // An error has occurred. Drop the operation and continue with the next one.
+            m_retry_count = 0;
             send_event(p_op, FS_ERR_INTERNAL);
+            queue_free(m_queue.cur);
+            continue;
         }
         else
         {
             // Operation is executing.
+            m_stats.flash_ops++;
         }
+
+        break;
     }
 }
 
@@ -168,94 +336,112 @@ static void queue_start(void)
 }
 
 
-// Flash operation success callback handler. Keeps track of the progress of an operation.
-// If it has finished, advances the queue and notifies the application.
-static void on_operation_success(fs_op_t * const p_op)
+// Flash operation success callback handler. Keeps track of the progress of the operations
+// written by the flash operation. Notifies the application of the ones that have finished,
+// in the order they were queued, and removes them from the queue.
+static void on_operation_success(void)
 {
     m_retry_count = 0;
 
-    switch (p_op->op_code)
+    for (uint32_t i = 0; i < m_queue.batch_count; i++)
     {
-        case FS_OP_STORE:
-        {
-            uint16_t chunk_len;
+        uint32_t  const idx  = m_queue.batch[i];
+        fs_op_t * const p_op = &m_queue.op[idx];
 
-            if ((p_op->store.length_words - p_op->store.offset) < FS_MAX_WRITE_SIZE_WORDS)
-            {
-                chunk_len = p_op->store.length_words - p_op->store.offset;
-            }
-            else
+        switch (p_op->op_code)
+        {
+            case FS_OP_STORE:
             {
-                chunk_len = FS_MAX_WRITE_SIZE_WORDS;
+                p_op->store.offset += m_queue.batch_words[i];
+
+                if (p_op->store.offset == p_op->store.length_words)
+                {
+                    // The operation has finished.
+                    send_event(p_op, FS_SUCCESS);
+                    queue_free(idx);
+                }
             }
+            break;
 
-            p_op->store.offset += chunk_len;
-
-            if (p_op->store.offset == p_op->store.length_words)
+            case FS_OP_ERASE:
             {
-                // The operation has finished.
-                send_event(p_op, FS_SUCCESS);
-                queue_advance();
+                p_op->erase.page++;
+                p_op->erase.pages_erased++;
+
+                if (p_op->erase.pages_erased == p_op->erase.pages_to_erase)
+                {
+                    send_event(p_op, FS_SUCCESS);
+                    queue_free(idx);
+                }
             }
-        }
-        break;
-
-        case FS_OP_ERASE:
-        {
-            p_op->erase.page++;
-            p_op->erase.pages_erased++;
+            break;
 
-            if (p_op->erase.pages_erased == p_op->erase.pages_to_erase)
-            {
-                send_event(p_op, FS_SUCCESS);
-                queue_advance();
-            }
+            default:
+                // Should not happen.
+                break;
         }
-        break;
-
-        default:
-            // Should not happen.
-            break;
     }
+
+    m_queue.batch_count = 0;
 }
 
 
 // Flash operation failure callback handler. If the maximum number of retries has
-// been reached, notifies the application and advances the queue.
-static void on_operation_failure(fs_op_t const * const p_op)
+// been reached, notifies the application and removes the operation from the queue.
+// Stores merged into the failed flash operation stay queued.
+static void on_operation_failure(void)
 {
     if (++m_retry_count > FS_OP_MAX_RETRIES)
     {
         m_retry_count = 0;
 
-        send_event(p_op, FS_ERR_OPERATION_TIMEOUT);
-        queue_advance();
+        send_event(&m_queue.op[m_queue.cur], FS_ERR_OPERATION_TIMEOUT);
+        queue_free(m_queue.cur);
     }
+
+    m_queue.batch_count = 0;
 }
 
 
-// Retrieves a pointer to the next free element in the queue.
-// Additionally, increases the number of elements stored in the queue.
-static bool queue_get_next_free(fs_op_t ** p_op)
+// Copies an operation into a free element of the queue.
+// The element is reserved and filled in a critical region, so that the queue, which is also
+// processed from the system event handler, never holds a counted element without an op-code.
+static bool queue_add(fs_op_t const * const p_op)
 {
-    uint32_t idx;
+    bool added = false;
+
+    CRITICAL_REGION_ENTER();
 
-    if (m_queue.count == FS_QUEUE_SIZE)
+    if (m_queue.count < FS_QUEUE_SIZE)
     {
-        return false;
-    }
+        uint32_t idx;
 
-    idx = ((m_queue.rp + m_queue.count) < FS_QUEUE_SIZE) ?
-           (m_queue.rp + m_queue.count) : 0;
+        for (idx = 0; idx < FS_QUEUE_SIZE; idx++)
+        {
+            if (m_queue.op[idx].op_code == FS_OP_NONE)
+            {
+                break;
+            }
+        }
 
-    m_queue.count++;
+        m_queue.op[idx]           = *p_op;
+        m_queue.op[idx].seq       = ++m_seq;
+        m_queue.op[idx].timestamp = FS_QUEUE_TIMESTAMP_GET();
 
-    // Zero the element so that unassigned fields will be zero.
-    memset(&m_queue.op[idx], 0x00, sizeof(fs_op_t));
+        m_queue.count++;
 
-    *p_op = &m_queue.op[idx];
+        m_stats.queued++;
+        if (m_queue.count > m_stats.queue_peak)
+        {
+            m_stats.queue_peak = m_queue.count;
+        }
 
-    return true;
+        added = true;
+    }
+
+    CRITICAL_REGION_EXIT();
+
+    return added;
 }
 
 
@@ -334,7 +520,7 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
                   uint32_t    const * const p_src,
                   uint16_t    const         length_words)
 {
-    fs_op_t * p_op;
+    fs_op_t op;
 
     if (!(m_flags & FS_FLAG_INITIALIZED))
     {
@@ -370,18 +556,20 @@ fs_ret_t fs_store(fs_config_t const * const p_config,
         return FS_ERR_INVALID_ARG;
     }
 
-    if (!queue_get_next_free(&p_op))
+    // Zero the operation so that unassigned fields will be zero.
+    memset(&op, 0x00, sizeof(fs_op_t));
+
+    op.p_config           = p_config;
+    op.op_code            = FS_OP_STORE;
+    op.store.p_src        = p_src;
+    op.store.p_dest       = p_dest;
+    op.store.length_words = length_words;
+
+    if (!queue_add(&op))
     {
         return FS_ERR_QUEUE_FULL;
     }
 
-    // Initialize the operation.
-    p_op->p_config           = p_config;
-    p_op->op_code            = FS_OP_STORE;
-    p_op->store.p_src        = p_src;
-    p_op->store.p_dest       = p_dest;
-    p_op->store.length_words = length_words;
-
     queue_start();
 
     return FS_SUCCESS;
@@ -392,7 +580,7 @@ fs_ret_t fs_erase(fs_config_t const * const p_config,
                   uint32_t    const * const p_page_addr,
                   uint16_t    const         num_pages)
 {
-    fs_op_t * p_op;
+    fs_op_t op;
 
     if (!(m_flags & FS_FLAG_INITIALIZED))
     {
@@ -427,17 +615,19 @@ fs_ret_t fs_erase(fs_config_t const * const p_config,
         return FS_ERR_INVALID_ARG;
     }
 
-    if (!queue_get_next_free(&p_op))
+    // Zero the operation so that unassigned fields will be zero.
+    memset(&op, 0x00, sizeof(fs_op_t));
+
+    op.p_config             = p_config;
+    op.op_code              = FS_OP_ERASE;
+    op.erase.page           = ((uint32_t)p_page_addr / FS_PAGE_SIZE);
+    op.erase.pages_to_erase = num_pages;
+
+    if (!queue_add(&op))
     {
         return FS_ERR_QUEUE_FULL;
     }
 
-    // Initialize the operation.
-    p_op->p_config             = p_config;
-    p_op->op_code              = FS_OP_ERASE;
-    p_op->erase.page           = ((uint32_t)p_page_addr / FS_PAGE_SIZE);
-    p_op->erase.pages_to_erase = num_pages;
-
     queue_start();
 
     return FS_SUCCESS;
@@ -457,21 +647,32 @@ fs_ret_t fs_queued_op_count_get(uint32_t * const p_op_count)
 }
 
 
+fs_ret_t fs_stats_get(fs_stats_t * const p_stats)
+{
+    if (p_stats == NULL)
+    {
+        return FS_ERR_NULL_ARG;
+    }
+
+    *p_stats = m_stats;
+
+    return FS_SUCCESS;
+}
+
+
 void fs_sys_event_handler(uint32_t sys_evt)
 {
-    fs_op_t * const p_op = &m_queue.op[m_queue.rp];
-    
     if (m_flags & FS_FLAG_PROCESSING)
     {
         // A flash operation was initiated by this module. Handle the result.
         switch (sys_evt)
         {
             case NRF_EVT_FLASH_OPERATION_SUCCESS:
-                on_operation_success(p_op);
+                on_operation_success();
                 break;
 
             case NRF_EVT_FLASH_OPERATION_ERROR:
-                on_operation_failure(p_op);
+                on_operation_failure();
                 break;
         }
     }
@@ -491,4 +692,3 @@ void fs_sys_event_handler(uint32_t sys_evt)
     // Resume processing the queue, if necessary.
     queue_process();
 }
-
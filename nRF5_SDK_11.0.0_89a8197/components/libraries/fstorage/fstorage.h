@@ -126,9 +126,29 @@ typedef struct
      *          reserved. Must be unique among configurations.
      */
     uint8_t  const   priority;
+
+    /**@brief   The priority of the flash operations of this application in the fstorage queue.
+     *          Operations of applications with a higher value are executed first, and may be
+     *          executed between the chunks of a large store or the pages of an erase of an
+     *          application with a lower value. Defaults to zero.
+     */
+    uint8_t  const   op_priority;
 } fs_config_t;
 
 
+/**@brief   fstorage queue statistics. */
+typedef struct
+{
+    uint32_t queued;        //!< Number of operations queued.
+    uint32_t flash_ops;     //!< Number of flash operations started.
+    uint32_t merged;        //!< Number of stores written together with a preceding store.
+    uint32_t preempted;     //!< Number of times an unfinished operation was interrupted by an operation with a higher priority.
+    uint32_t queue_peak;    //!< Largest number of operations queued at once.
+    uint32_t wait_total;    //!< Sum of the times operations waited in the queue before being started.
+    uint32_t wait_max;      //!< Longest time an operation waited in the queue before being started.
+} fs_stats_t;
+
+
 /**@brief   Macro for registering with an fstorage configuration.
  *          Applications which use fstorage must register with the module using this macro.
  *          Registering involves defining a variable which holds the configuration of fstorage
@@ -159,6 +179,8 @@ fs_ret_t fs_init(void);
  *          application upon completion. Both the source and the destination of the data must be
  *          word aligned. This function is asynchronous, completion is reported via an event sent
  *          the the callback function specified in the supplied configuration.
+ *          Operations are executed in order of @ref fs_config_t::op_priority, and in the order
+ *          they were queued among configurations with the same priority.
  *
  * @warning The data to be written to flash has to be kept in memory until the operation has
  *          terminated, i.e., an event is received.
@@ -220,6 +242,19 @@ fs_ret_t fs_erase(fs_config_t const * const p_config,
 fs_ret_t fs_queued_op_count_get(uint32_t * const p_op_count);
 
 
+/**@brief   Function for retrieving the queue statistics.
+ *
+ * @details Wait times are measured with @ref FS_QUEUE_TIMESTAMP_GET, or in flash operations if it
+ *          is not defined.
+ *
+ * @param[out]  p_stats     The statistics.
+ *
+ * @retval  FS_SUCCESS          If the statistics were retrieved successfully.
+ * @retval  FS_ERR_NULL_ARG     If @p p_stats is NULL.
+ */
+fs_ret_t fs_stats_get(fs_stats_t * const p_stats);
+
+
 /**@brief   Function for handling system events from the SoftDevice.
  *
  * @details If any of the modules used by the application rely on fstorage, the application should
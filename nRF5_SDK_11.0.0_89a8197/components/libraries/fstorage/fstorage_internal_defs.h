@@ -13,6 +13,7 @@
 #ifndef FSTORAGE_INTERNAL_DEFS_H__
 #define FSTORAGE_INTERNAL_DEFS_H__
 
+#include <stdbool.h>
 #include "nrf.h"
 
 
@@ -64,7 +65,10 @@ typedef enum
 typedef struct
 {
     fs_config_t  const * p_config;          // Application-specific fstorage configuration.
-    fs_op_code_t         op_code;           // ID of the operation.
+    fs_op_code_t         op_code;           // ID of the operation. FS_OP_NONE if the element is free.
+    uint32_t             seq;               // Sequence number, used to keep queuing order.
+    uint32_t             timestamp;         // Time at which the operation was queued.
+    bool                 started;           // The operation has been written to flash at least once.
     union
     {
         struct
@@ -96,11 +100,16 @@ typedef struct
 // This queue holds flash operations requested to the module.
 // The data to be written to flash must be kept in memory until the write operation
 // is completed, i.e., an event indicating completion is received.
+// Operations are executed in order of the priority of their user, and in queuing order
+// among users of the same priority.
 typedef struct
 {
-    fs_op_t  op[FS_QUEUE_SIZE];  // Queue elements.
-    uint32_t rp;                 // Index of the operation being processed.
-    uint32_t count;              // Number of elements in the queue.
+    fs_op_t  op[FS_QUEUE_SIZE];             // Queue elements.
+    uint32_t cur;                           // Index of the operation being processed.
+    uint32_t count;                         // Number of elements in the queue.
+    uint8_t  batch[FS_QUEUE_SIZE];          // Elements written by the flash operation in progress.
+    uint16_t batch_words[FS_QUEUE_SIZE];    // Number of words written for each of these elements.
+    uint32_t batch_count;                   // Number of elements written by the flash operation.
 } fs_op_queue_t;
 
 
@@ -16,6 +16,9 @@
 #ifdef SOFTDEVICE_PRESENT
 #include "nrf_soc.h"
 #endif
+#ifdef APP_EVENT_TRACE_ENABLED
+#include "app_event_trace.h"
+#endif
 
 #if defined(DEBUG_NRF)
 /**
@@ -43,5 +46,10 @@ void HardFault_c_handler( uint32_t *p_stack_address )
     __BKPT(0);
 #endif
 
+#ifdef APP_EVENT_TRACE_ENABLED
+    app_event_trace_record(APP_EVENT_TRACE_TYPE_HARDFAULT,
+                           (p_stack_address != NULL) ? ((HardFault_stack_t*)p_stack_address)->pc : 0);
+#endif
+
     HardFault_process((HardFault_stack_t*)p_stack_address);
 }
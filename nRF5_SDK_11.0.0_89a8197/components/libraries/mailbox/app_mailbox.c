@@ -10,6 +10,7 @@
  *
  */
 #include <stddef.h>
+#include <stdbool.h>
 #include <string.h>
 #include "app_mailbox.h"
 #include "nrf_error.h"
@@ -17,85 +18,268 @@
 #include "app_util.h"
 #include "nrf_assert.h"
 
-ret_code_t app_mailbox_create(const app_mailbox_t * queue_def)
+/* Layout of the packed mailbox state word. All fields are updated together with a single
+ * compare-and-swap, so producers and the consumer never observe a half-updated state. The
+ * generation counter protects the compare-and-swap against ABA after a full wrap of the queue.
+ */
+#define STATE_R_IDX_POS     0
+#define STATE_W_IDX_POS     8
+#define STATE_LEN_POS       16
+#define STATE_FIELD_MSK     0xFFUL
+#define STATE_RD_BUSY       (1UL << 24)                 /**< The oldest item is held by the consumer. */
+#define STATE_GEN_POS       25
+#define STATE_GEN_MSK       0x7FUL
+
+#define STATE_R_IDX(state)  ((uint8_t)(((state) >> STATE_R_IDX_POS) & STATE_FIELD_MSK))
+#define STATE_W_IDX(state)  ((uint8_t)(((state) >> STATE_W_IDX_POS) & STATE_FIELD_MSK))
+#define STATE_LEN(state)    ((uint8_t)(((state) >> STATE_LEN_POS)   & STATE_FIELD_MSK))
+
+/* Every slot starts with a header word: the item size in the lower half and the slot status in the
+ * upper half. The header is written with a single word store, so it is always consistent.
+ */
+#define SLOT_SIZE_MSK       0xFFFFUL
+#define SLOT_STATUS_POS     16
+#define SLOT_FREE           0UL                         /**< Slot is not in use. */
+#define SLOT_WRITING        1UL                         /**< Slot is reserved by a producer. */
+#define SLOT_READY          2UL                         /**< Slot is committed and can be consumed. */
+
+static __INLINE uint32_t state_make(uint32_t old_state,
+                                    uint8_t  r_idx,
+                                    uint8_t  w_idx,
+                                    uint8_t  len,
+                                    uint32_t flags)
 {
-    queue_def->p_cb->r_idx    = 0;
-    queue_def->p_cb->w_idx    = 0;
-    queue_def->p_cb->len      = 0;
-    queue_def->p_cb->mode     = APP_MAILBOX_MODE_NO_OVERFLOW;
+    uint32_t gen = ((old_state >> STATE_GEN_POS) + 1) & STATE_GEN_MSK;
 
-    return NRF_SUCCESS;
+    return ((uint32_t)r_idx << STATE_R_IDX_POS) |
+           ((uint32_t)w_idx << STATE_W_IDX_POS) |
+           ((uint32_t)len   << STATE_LEN_POS)   |
+           (flags & STATE_RD_BUSY)              |
+           (gen << STATE_GEN_POS);
 }
 
-static __INLINE void dequeue(app_mailbox_cb_t * p_cb, uint8_t queue_sz)
+/**@brief Function for atomically replacing a word if it was not changed meanwhile.
+ *
+ * @details Cortex-M3/M4 use exclusive access, which does not mask interrupts. Any interrupt
+ *          taken between LDREX and STREX clears the exclusive monitor and the update is retried.
+ *          Cortex-M0 has no exclusive access, so a critical region spanning only the compare and
+ *          the store is used instead.
+ */
+static __INLINE bool word_cas(volatile uint32_t * p_word, uint32_t expected, uint32_t desired)
 {
-    uint8_t  r_idx = p_cb->r_idx + 1;
-    p_cb->len--;
+#if (__CORTEX_M >= 0x03U)
+    if (__LDREXW(p_word) != expected)
+    {
+        __CLREX();
+        return false;
+    }
+    return (__STREXW(desired, p_word) == 0);
+#else
+    bool success = false;
 
-    //Handle index wrapping.
-    p_cb->r_idx = (r_idx == queue_sz) ? 0 : r_idx;
+    CRITICAL_REGION_ENTER();
+    if (*p_word == expected)
+    {
+        *p_word = desired;
+        success = true;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return success;
+#endif
+}
+
+static __INLINE bool state_cas(app_mailbox_cb_t * p_cb, uint32_t expected, uint32_t desired)
+{
+    return word_cas(&p_cb->state, expected, desired);
 }
 
-static __INLINE void enqueue(app_mailbox_cb_t * p_cb, uint8_t queue_sz)
+static __INLINE uint8_t idx_next(uint8_t idx, uint8_t queue_sz)
 {
-    uint8_t  w_idx = p_cb->w_idx + 1;
-    p_cb->len++;
+    idx++;
 
     //Handle index wrapping.
-    p_cb->w_idx = (w_idx == queue_sz) ? 0 : w_idx;
+    return (idx == queue_sz) ? 0 : idx;
 }
 
-ret_code_t app_mailbox_put(const app_mailbox_t * p_mailbox, void * p_item)
+static __INLINE volatile uint32_t * slot_get(const app_mailbox_t * p_mailbox, uint8_t idx)
 {
-    ASSERT(p_mailbox);
-    return app_mailbox_sized_put(p_mailbox, p_item, p_mailbox->item_sz);
+    // Each slot is one header word followed by the item rounded up to whole words.
+    return (volatile uint32_t *)p_mailbox->p_pool +
+           (idx * (CEIL_DIV(p_mailbox->item_sz, sizeof(uint32_t)) + 1));
 }
 
-ret_code_t app_mailbox_sized_put(const app_mailbox_t * p_mailbox, void * p_item, uint16_t size)
+static __INLINE uint32_t slot_status_get(volatile uint32_t * p_slot)
 {
-    ASSERT((uint32_t)p_item>0);
-    ASSERT(p_mailbox);
-    uint32_t           err_code  = NRF_ERROR_INTERNAL;
-    uint32_t *         p_dst     = p_mailbox->p_pool;
-    bool               do_put    = true;
-    uint8_t            queue_sz  = p_mailbox->queue_sz;
-    uint16_t           item_sz   = p_mailbox->item_sz;
-    app_mailbox_cb_t * p_cb      = p_mailbox->p_cb;
+    return (*p_slot >> SLOT_STATUS_POS);
+}
 
-    CRITICAL_REGION_ENTER();
+/**@brief Function for reserving the next write slot.
+ *
+ * @details When the oldest element is dropped in overflow mode, its slot is marked as being
+ *          written before the new write index is published. Other producers then cannot drop it
+ *          again, and the consumer does not read it while it is overwritten. If the state has
+ *          changed meanwhile, the slot is given back and the reservation is retried.
+ *
+ * @param[in]  p_mailbox  Pointer to the mailbox.
+ * @param[out] pp_slot    Pointer to the header of the reserved slot.
+ * @param[out] p_dropped  Set to true if the oldest element was dropped to make room.
+ */
+static ret_code_t slot_reserve(const app_mailbox_t  * p_mailbox,
+                               volatile uint32_t   ** pp_slot,
+                               bool                 * p_dropped)
+{
+    app_mailbox_cb_t  * p_cb     = p_mailbox->p_cb;
+    uint8_t             queue_sz = p_mailbox->queue_sz;
+    volatile uint32_t * p_slot;
+    uint32_t            old_state;
+    uint32_t            new_state;
+    uint32_t            ready_header   = 0;
+    uint32_t            writing_header = 0;
 
-    if (p_cb->len == queue_sz)
+    for (;;)
     {
-        if (p_cb->mode == APP_MAILBOX_MODE_NO_OVERFLOW)
+        old_state     = p_cb->state;
+        uint8_t r_idx = STATE_R_IDX(old_state);
+        uint8_t w_idx = STATE_W_IDX(old_state);
+        uint8_t len   = STATE_LEN(old_state);
+        p_slot        = slot_get(p_mailbox, w_idx);
+        *p_dropped    = false;
+
+        if (len == queue_sz)
         {
-            do_put = false;
+            // The queue is full, so the write slot holds the oldest element. It can only be
+            // dropped if it is neither being written nor read.
+            ready_header = *p_slot;
+
+            if ((p_cb->mode == APP_MAILBOX_MODE_NO_OVERFLOW)    ||
+                ((old_state & STATE_RD_BUSY) != 0)              ||
+                ((ready_header >> SLOT_STATUS_POS) != SLOT_READY))
+            {
+                return NRF_ERROR_NO_MEM;
+            }
+
+            writing_header = (SLOT_WRITING << SLOT_STATUS_POS) | (ready_header & SLOT_SIZE_MSK);
+            if (!word_cas(p_slot, ready_header, writing_header))
+            {
+                continue;
+            }
+
+            // Remove the oldest element; its slot is the one being reserved.
+            r_idx      = idx_next(r_idx, queue_sz);
+            *p_dropped = true;
         }
         else
         {
-            // Remove the oldest element.
-            dequeue(p_cb, queue_sz);
+            len++;
+        }
+
+        new_state = state_make(old_state, r_idx, idx_next(w_idx, queue_sz), len, old_state);
+        if (state_cas(p_cb, old_state, new_state))
+        {
+            break;
+        }
+
+        if (*p_dropped)
+        {
+            // The element was not dropped. Give its slot back, unless the consumer has read and
+            // released it meanwhile.
+            while ((*p_slot == writing_header) && !word_cas(p_slot, writing_header, ready_header))
+            {
+            }
         }
-        err_code = NRF_ERROR_NO_MEM;
     }
-    else
+
+    *pp_slot = p_slot;
+    *p_slot  = (SLOT_WRITING << SLOT_STATUS_POS);
+
+    return NRF_SUCCESS;
+}
+
+static __INLINE void slot_commit(volatile uint32_t * p_slot, uint16_t size)
+{
+    // Make sure the item contents are stored before the slot becomes visible to the consumer.
+    __DMB();
+    *p_slot = (SLOT_READY << SLOT_STATUS_POS) | size;
+}
+
+ret_code_t app_mailbox_create(const app_mailbox_t * queue_def)
+{
+    uint8_t i;
+
+    for (i = 0; i < queue_def->queue_sz; i++)
+    {
+        *slot_get(queue_def, i) = (SLOT_FREE << SLOT_STATUS_POS);
+    }
+
+    queue_def->p_cb->state = 0;
+    queue_def->p_cb->mode  = APP_MAILBOX_MODE_NO_OVERFLOW;
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_mailbox_put(const app_mailbox_t * p_mailbox, void * p_item)
+{
+    ASSERT(p_mailbox);
+    return app_mailbox_sized_put(p_mailbox, p_item, p_mailbox->item_sz);
+}
+
+ret_code_t app_mailbox_sized_put(const app_mailbox_t * p_mailbox, void * p_item, uint16_t size)
+{
+    ASSERT((uint32_t)p_item>0);
+    ASSERT(p_mailbox);
+    ASSERT(size <= p_mailbox->item_sz);
+    volatile uint32_t * p_slot;
+    bool                dropped;
+    ret_code_t          err_code;
+
+    err_code = slot_reserve(p_mailbox, &p_slot, &dropped);
+    if (err_code != NRF_SUCCESS)
     {
-        err_code = NRF_SUCCESS;
+        return err_code;
     }
 
-    if (do_put)
+    //Put data in mailbox.
+    memcpy((void *)(p_slot + 1), p_item, size);
+    slot_commit(p_slot, size);
+
+    return dropped ? NRF_ERROR_NO_MEM : NRF_SUCCESS;
+}
+
+ret_code_t app_mailbox_put_reserve(const app_mailbox_t * p_mailbox, void ** pp_item)
+{
+    ASSERT(p_mailbox);
+    ASSERT(pp_item);
+    volatile uint32_t * p_slot;
+    bool                dropped;
+    ret_code_t          err_code;
+
+    err_code = slot_reserve(p_mailbox, &p_slot, &dropped);
+    if (err_code != NRF_SUCCESS)
     {
-        p_dst = (uint32_t *)((uint32_t)p_dst + (p_cb->w_idx * (item_sz + sizeof(uint32_t))));
-        enqueue(p_cb, queue_sz);
+        return err_code;
+    }
 
-        //Put data in mailbox.
-        *p_dst = (uint32_t)size;
-        p_dst++;
-        memcpy(p_dst, p_item, size);
+    *pp_item = (void *)(p_slot + 1);
+
+    return dropped ? NRF_ERROR_NO_MEM : NRF_SUCCESS;
+}
+
+ret_code_t app_mailbox_put_commit(const app_mailbox_t * p_mailbox, void * p_item, uint16_t size)
+{
+    ASSERT(p_mailbox);
+    ASSERT(p_item != NULL);
+    volatile uint32_t * p_slot = ((volatile uint32_t *)p_item) - 1;
+
+    if (size > p_mailbox->item_sz)
+    {
+        return NRF_ERROR_INVALID_PARAM;
     }
 
-    CRITICAL_REGION_EXIT();
+    ASSERT(slot_status_get(p_slot) == SLOT_WRITING);
+    slot_commit(p_slot, size);
 
-    return err_code;
+    return NRF_SUCCESS;
 }
 
 ret_code_t app_mailbox_get(const app_mailbox_t * p_mailbox, void * p_item)
@@ -108,41 +292,100 @@ ret_code_t app_mailbox_sized_get(const app_mailbox_t * p_mailbox, void * p_item,
 {
     ASSERT(p_mailbox);
     ASSERT((uint32_t)p_item>0);
-    uint32_t *         p_src     = p_mailbox->p_pool;
-    ret_code_t         err_code  = NRF_SUCCESS;
-    uint16_t           item_sz   = p_mailbox->item_sz;
-    uint8_t            queue_sz  = p_mailbox->queue_sz;
-    app_mailbox_cb_t * p_cb      = p_mailbox->p_cb;
-
-    CRITICAL_REGION_ENTER();
+    void     * p_src;
+    ret_code_t err_code;
 
-    if (p_cb->len == 0)
+    err_code = app_mailbox_get_reserve(p_mailbox, &p_src, p_size);
+    if (err_code != NRF_SUCCESS)
     {
-        err_code = NRF_ERROR_NO_MEM;
+        return err_code;
     }
-    else
+
+    memcpy(p_item, p_src, *p_size);
+
+    return app_mailbox_get_release(p_mailbox, p_src);
+}
+
+ret_code_t app_mailbox_get_reserve(const app_mailbox_t * p_mailbox, void ** pp_item, uint16_t * p_size)
+{
+    ASSERT(p_mailbox);
+    ASSERT(pp_item);
+    ASSERT(p_size);
+    app_mailbox_cb_t  * p_cb = p_mailbox->p_cb;
+    volatile uint32_t * p_slot;
+    uint32_t            old_state;
+    uint32_t            new_state;
+
+    do
     {
-        p_src = (void *)((uint32_t)p_src + (p_cb->r_idx * (item_sz + sizeof(uint32_t))));
-        dequeue(p_cb, queue_sz);
-    }
+        old_state = p_cb->state;
 
-    if (err_code == NRF_SUCCESS)
+        if ((old_state & STATE_RD_BUSY) != 0)
+        {
+            return NRF_ERROR_BUSY;
+        }
+        if (STATE_LEN(old_state) == 0)
+        {
+            return NRF_ERROR_NO_MEM;
+        }
+
+        p_slot = slot_get(p_mailbox, STATE_R_IDX(old_state));
+        if (slot_status_get(p_slot) != SLOT_READY)
+        {
+            // The oldest element is reserved but not committed yet.
+            return NRF_ERROR_NO_MEM;
+        }
+
+        new_state = state_make(old_state,
+                               STATE_R_IDX(old_state),
+                               STATE_W_IDX(old_state),
+                               STATE_LEN(old_state),
+                               STATE_RD_BUSY);
+    } while (!state_cas(p_cb, old_state, new_state));
+
+    *p_size  = (uint16_t)(*p_slot & SLOT_SIZE_MSK);
+    *pp_item = (void *)(p_slot + 1);
+
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_mailbox_get_release(const app_mailbox_t * p_mailbox, void * p_item)
+{
+    ASSERT(p_mailbox);
+    app_mailbox_cb_t  * p_cb     = p_mailbox->p_cb;
+    uint8_t             queue_sz = p_mailbox->queue_sz;
+    volatile uint32_t * p_slot;
+    uint32_t            old_state;
+    uint32_t            new_state;
+
+    old_state = p_cb->state;
+    p_slot    = slot_get(p_mailbox, STATE_R_IDX(old_state));
+
+    if (((old_state & STATE_RD_BUSY) == 0) || ((void *)(p_slot + 1) != p_item))
     {
-        uint16_t size = (uint16_t)*p_src;
-        *p_size = size;
-        p_src++;
-        memcpy(p_item, p_src, size);
+        return NRF_ERROR_INVALID_STATE;
     }
 
-    CRITICAL_REGION_EXIT();
+    // Producers cannot reuse the slot before the length is decremented below.
+    *p_slot = (SLOT_FREE << SLOT_STATUS_POS);
 
-    return err_code;
+    do
+    {
+        old_state = p_cb->state;
+        new_state = state_make(old_state,
+                               idx_next(STATE_R_IDX(old_state), queue_sz),
+                               STATE_W_IDX(old_state),
+                               STATE_LEN(old_state) - 1,
+                               0);
+    } while (!state_cas(p_cb, old_state, new_state));
+
+    return NRF_SUCCESS;
 }
 
 uint32_t app_mailbox_length_get (const app_mailbox_t * p_mailbox)
 {
     ASSERT(p_mailbox);
-    return p_mailbox->p_cb->len;
+    return STATE_LEN(p_mailbox->p_cb->state);
 }
 
 void app_mailbox_mode_set(const app_mailbox_t * p_mailbox, app_mailbox_overflow_mode_t mode)
@@ -18,6 +18,17 @@
  *
  * @brief Mailbox for safely queuing items.
  *
+ * @details Items are copied in and out of the mailbox outside of any critical region. A slot is
+ *          first reserved, then filled, and finally committed, so only the index update is
+ *          protected. On Cortex-M4 the index update uses exclusive load/store (LDREX/STREX) and
+ *          does not mask interrupts at all. On Cortex-M0 it uses a short critical region.
+ *
+ *          Any number of producers (threads or interrupts) may put items concurrently. There must
+ *          be only one consumer at a time; a second concurrent consumer gets @ref NRF_ERROR_BUSY.
+ *
+ *          @ref app_mailbox_put_reserve, @ref app_mailbox_put_commit, @ref app_mailbox_get_reserve
+ *          and @ref app_mailbox_get_release give direct access to the mailbox memory, so items
+ *          can be produced and consumed without an intermediate copy.
  */
 
 #ifndef _APP_MAILBOX_H
@@ -94,7 +105,8 @@ ret_code_t app_mailbox_put (const app_mailbox_t * p_mailbox, void * p_item);
  * @param[in] size        Size of the item.
  *
  * @retval NRF_SUCCESS              If the item was enqueued.
- * @retval NRF_ERROR_NO_MEM         If the queue is full.
+ * @retval NRF_ERROR_NO_MEM         If the queue is full. In @ref APP_MAILBOX_MODE_OVERFLOW mode,
+ *                                  also if the item was enqueued by dropping the oldest element.
  */
 ret_code_t app_mailbox_sized_put (const app_mailbox_t * p_mailbox, void * p_item, uint16_t size);
 
@@ -118,9 +130,67 @@ ret_code_t app_mailbox_get (const app_mailbox_t * p_mailbox, void * p_item);
  *
  * @retval NRF_SUCCESS              If the item was retrieved successfully.
  * @retval NRF_ERROR_NO_MEM         If the queue is empty.
+ * @retval NRF_ERROR_BUSY           If an item is held through @ref app_mailbox_get_reserve.
  */
 ret_code_t app_mailbox_sized_get (const app_mailbox_t * p_mailbox, void * p_item, uint16_t * p_size);
 
+/**
+ * @brief Function for reserving a slot in the mailbox queue for zero-copy writing.
+ *
+ * The reserved slot is not visible to the consumer until @ref app_mailbox_put_commit is called.
+ * Items are delivered in reservation order, so a reserved slot must be committed promptly.
+ *
+ * @note In @ref APP_MAILBOX_MODE_OVERFLOW mode the oldest element is dropped to make room, unless
+ *       it is currently being written or read.
+ *
+ * @param[in]  p_mailbox   Pointer to the mailbox.
+ * @param[out] pp_item     Pointer to the reserved slot. At most item_sz bytes can be written.
+ *
+ * @retval NRF_SUCCESS              If a slot was reserved.
+ * @retval NRF_ERROR_NO_MEM         If the queue is full. In @ref APP_MAILBOX_MODE_OVERFLOW mode,
+ *                                  also if the oldest element was dropped to make room. The slot is
+ *                                  then reserved, @p pp_item is valid and the slot must be committed.
+ */
+ret_code_t app_mailbox_put_reserve(const app_mailbox_t * p_mailbox, void ** pp_item);
+
+/**
+ * @brief Function for committing a slot previously reserved with @ref app_mailbox_put_reserve.
+ *
+ * @param[in] p_mailbox   Pointer to the mailbox.
+ * @param[in] p_item      Pointer to the reserved slot.
+ * @param[in] size        Size of the item written to the slot.
+ *
+ * @retval NRF_SUCCESS              If the item was committed.
+ * @retval NRF_ERROR_INVALID_PARAM  If the size exceeds the item size of the mailbox.
+ */
+ret_code_t app_mailbox_put_commit(const app_mailbox_t * p_mailbox, void * p_item, uint16_t size);
+
+/**
+ * @brief Function for accessing the oldest item in the mailbox queue without copying it.
+ *
+ * The item stays in the queue until @ref app_mailbox_get_release is called.
+ *
+ * @param[in]  p_mailbox   Pointer to the mailbox.
+ * @param[out] pp_item     Pointer to the item in the mailbox memory.
+ * @param[out] p_size      Pointer to the item size.
+ *
+ * @retval NRF_SUCCESS              If an item is available.
+ * @retval NRF_ERROR_NO_MEM         If the queue is empty or the oldest item is not committed yet.
+ * @retval NRF_ERROR_BUSY           If another item is already held by a consumer.
+ */
+ret_code_t app_mailbox_get_reserve(const app_mailbox_t * p_mailbox, void ** pp_item, uint16_t * p_size);
+
+/**
+ * @brief Function for removing an item obtained with @ref app_mailbox_get_reserve from the queue.
+ *
+ * @param[in] p_mailbox   Pointer to the mailbox.
+ * @param[in] p_item      Pointer to the item returned by @ref app_mailbox_get_reserve.
+ *
+ * @retval NRF_SUCCESS              If the item was removed.
+ * @retval NRF_ERROR_INVALID_STATE  If the item is not held by the consumer.
+ */
+ret_code_t app_mailbox_get_release(const app_mailbox_t * p_mailbox, void * p_item);
+
 /**
  * @brief Function for getting the current length of the mailbox queue.
  *
@@ -29,9 +29,7 @@
      */
     typedef struct
     {
-        uint8_t                      r_idx;    /**< Read index for the mailbox queue. */
-        uint8_t                      w_idx;    /**< Write index for the mailbox queue. */
-        uint8_t                      len;      /**< Number of elements currently in the mailbox queue. */
+        volatile uint32_t            state;    /**< Packed read index, write (reservation) index, number of elements and flags. */
         app_mailbox_overflow_mode_t  mode;     /**< Mode of overflow handling. */
     } app_mailbox_cb_t;
 
@@ -0,0 +1,40 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef RTT_STREAM_CONFIG_H__
+#define RTT_STREAM_CONFIG_H__
+
+ /**
+ * @file rtt_stream_config.h
+ *
+ * @defgroup rtt_stream_config Configuration options
+ * @ingroup rtt_stream
+ * @{
+ * @brief   Configuration options for the RTT binary stream.
+ */
+
+/**@brief   Configures the RTT up-buffer used for the stream.
+ *
+ * Buffer 0 is the terminal used by @ref nrf_log. The index must be below
+ * SEGGER_RTT_MAX_NUM_UP_BUFFERS.
+ */
+#define RTT_STREAM_BUFFER_INDEX     (1)
+
+/**@brief   Configures the size of the stream buffer, in bytes. Must be a multiple of 4. */
+#define RTT_STREAM_BUFFER_SIZE      (4096)
+
+/**@brief   Configures the name of the RTT up-buffer, as shown by the host. */
+#define RTT_STREAM_BUFFER_NAME      "BinStream"
+
+/** @} */
+
+#endif // RTT_STREAM_CONFIG_H__
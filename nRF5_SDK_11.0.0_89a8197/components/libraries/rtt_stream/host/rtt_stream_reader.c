@@ -0,0 +1,268 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @brief Host tool for decoding an RTT binary stream from a RAM dump.
+ *
+ * @details The tool reads a binary image of the target RAM, for example saved with
+ *          "nrfjprog --readram dump.bin" or "savebin dump.bin 0x20000000 0x8000" in J-Link
+ *          Commander. It finds the _SEGGER_RTT control block in the image, and decodes the
+ *          frames of the up-buffer between RdOff and WrOff. Each frame is printed on one line,
+ *          with its payload in hexadecimal. Padding frames are skipped, and drop reports are
+ *          printed as such.
+ *
+ *          Build and run on Linux:
+ * @code
+ * gcc -std=c99 -O2 -o rtt_stream_reader rtt_stream_reader.c
+ * ./rtt_stream_reader dump.bin [ram_start [buffer_index]]
+ * @endcode
+ *
+ *          ram_start is the target address of the first byte of the image, 0x20000000 by
+ *          default. buffer_index is the RTT up-buffer used by the stream, RTT_STREAM_BUFFER_INDEX
+ *          (1) by default. The frame constants below must match rtt_stream.h.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FRAME_SYNC          (0xA5)                  /**< RTT_STREAM_FRAME_SYNC. */
+#define FRAME_HEADER_SIZE   (4)                     /**< RTT_STREAM_FRAME_HEADER_SIZE. */
+#define FRAME_TYPE_PAD      (0x00)                  /**< RTT_STREAM_FRAME_TYPE_PAD. */
+#define FRAME_TYPE_DROP     (0xFF)                  /**< RTT_STREAM_FRAME_TYPE_DROP. */
+
+#define RAM_START_DEFAULT   (0x20000000UL)          /**< Target address of the image, if not given. */
+#define BUFFER_INDEX_DEFAULT (1)                    /**< Up-buffer index, if not given. */
+
+#define CB_ID               "SEGGER RTT"            /**< Start of the control block. */
+#define CB_ID_SIZE          (16)                    /**< Size of the acID field. */
+#define CB_UP_OFFSET        (CB_ID_SIZE + 8)        /**< Offset of aUp in the control block. */
+#define RING_SIZE           (24)                    /**< Size of SEGGER_RTT_RING_BUFFER on the target. */
+#define RING_BUFFER         (4)                     /**< Offset of pBuffer. */
+#define RING_SIZE_OF_BUFFER (8)                     /**< Offset of SizeOfBuffer. */
+#define RING_WR_OFF         (12)                    /**< Offset of WrOff. */
+#define RING_RD_OFF         (16)                    /**< Offset of RdOff. */
+
+static uint8_t * m_image;                           /**< RAM image. */
+static size_t    m_image_size;                      /**< Size of the RAM image, in bytes. */
+static uint32_t  m_ram_start;                       /**< Target address of the image. */
+
+
+static uint32_t word_get(uint8_t const * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+/**@brief Function for translating a target address range to a pointer into the image.
+ *
+ * @return Pointer, or NULL if the range is not in the image.
+ */
+static uint8_t * target_ptr_get(uint32_t address, uint32_t size)
+{
+    if ((address < m_ram_start) ||
+        ((uint64_t)address - m_ram_start + size > m_image_size))
+    {
+        return NULL;
+    }
+    return m_image + (address - m_ram_start);
+}
+
+
+/**@brief Function for finding the RTT control block, which starts on a word boundary. */
+static uint8_t * control_block_find(void)
+{
+    for (size_t i = 0; i + CB_UP_OFFSET <= m_image_size; i += sizeof(uint32_t))
+    {
+        if (memcmp(&m_image[i], CB_ID, sizeof(CB_ID)) == 0)
+        {
+            return &m_image[i];
+        }
+    }
+    return NULL;
+}
+
+
+static int image_load(char const * p_path)
+{
+    FILE * p_file = fopen(p_path, "rb");
+    long   size;
+
+    if (p_file == NULL)
+    {
+        perror(p_path);
+        return -1;
+    }
+
+    if ((fseek(p_file, 0, SEEK_END) != 0) || ((size = ftell(p_file)) <= 0) ||
+        (fseek(p_file, 0, SEEK_SET) != 0))
+    {
+        fprintf(stderr, "%s: cannot read the file size\n", p_path);
+        fclose(p_file);
+        return -1;
+    }
+
+    m_image      = malloc((size_t)size);
+    m_image_size = (size_t)size;
+
+    if ((m_image == NULL) || (fread(m_image, 1, m_image_size, p_file) != m_image_size))
+    {
+        fprintf(stderr, "%s: cannot read the file\n", p_path);
+        fclose(p_file);
+        return -1;
+    }
+
+    fclose(p_file);
+    return 0;
+}
+
+
+/**@brief Function for decoding the frames between two offsets of the ring buffer.
+ *
+ * @details The target only writes whole frames at word aligned offsets, but the host may have
+ *          read part of a frame. If the read offset is not word aligned, decoding starts at the
+ *          next word that holds a valid frame header.
+ *
+ * @return 0 if all frames were valid, -1 if decoding stopped at an invalid frame.
+ */
+static int frames_decode(uint8_t const * p_buf, uint32_t size, uint32_t rd, uint32_t wr)
+{
+    uint32_t frames = 0;
+    uint32_t bytes  = 0;
+    int      synced = ((rd % sizeof(uint32_t)) == 0);
+
+    rd = (rd + 3) & ~3u;
+
+    while (rd != wr)
+    {
+        uint32_t header;
+        uint8_t  type;
+        uint32_t length;
+        uint32_t frame_size;
+
+        if (rd >= size)
+        {
+            rd = 0;
+            continue;
+        }
+
+        header     = word_get(&p_buf[rd]);
+        type       = (uint8_t)(header >> 8);
+        length     = header >> 16;
+        frame_size = FRAME_HEADER_SIZE + ((length + 3) & ~3u);
+
+        if (((header & 0xFF) != FRAME_SYNC) || (rd + frame_size > size))
+        {
+            if (!synced)
+            {
+                rd += sizeof(uint32_t);
+                continue;
+            }
+            fprintf(stderr, "invalid frame header 0x%08X at offset %u\n", header, rd);
+            return -1;
+        }
+
+        synced = 1;
+
+        if (type == FRAME_TYPE_DROP)
+        {
+            printf("drop: %u frames, %u bytes in total\n",
+                   word_get(&p_buf[rd + FRAME_HEADER_SIZE]),
+                   word_get(&p_buf[rd + FRAME_HEADER_SIZE + 4]));
+        }
+        else if (type != FRAME_TYPE_PAD)
+        {
+            printf("0x%02X %5u:", type, length);
+            for (uint32_t i = 0; i < length; i++)
+            {
+                printf(" %02X", p_buf[rd + FRAME_HEADER_SIZE + i]);
+            }
+            printf("\n");
+
+            frames++;
+            bytes += length;
+        }
+
+        rd += frame_size;
+        if (rd == size)
+        {
+            rd = 0;
+        }
+    }
+
+    fprintf(stderr, "%u frames, %u payload bytes\n", frames, bytes);
+    return 0;
+}
+
+
+int main(int argc, char ** argv)
+{
+    uint32_t        index = BUFFER_INDEX_DEFAULT;
+    uint8_t const * p_cb;
+    uint8_t const * p_ring;
+    uint8_t const * p_buf;
+    uint32_t        size;
+    uint32_t        wr;
+    uint32_t        rd;
+
+    if ((argc < 2) || (argc > 4))
+    {
+        fprintf(stderr, "usage: %s dump.bin [ram_start [buffer_index]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    m_ram_start = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : RAM_START_DEFAULT;
+    if (argc > 3)
+    {
+        index = (uint32_t)strtoul(argv[3], NULL, 0);
+    }
+
+    if (image_load(argv[1]) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    p_cb = control_block_find();
+    if (p_cb == NULL)
+    {
+        fprintf(stderr, "RTT control block not found\n");
+        return EXIT_FAILURE;
+    }
+
+    if (index >= word_get(&p_cb[CB_ID_SIZE]))
+    {
+        fprintf(stderr, "the control block has no up-buffer %u\n", index);
+        return EXIT_FAILURE;
+    }
+
+    p_ring = p_cb + CB_UP_OFFSET + index * RING_SIZE;
+    if (p_ring + RING_SIZE > m_image + m_image_size)
+    {
+        fprintf(stderr, "up-buffer %u is outside the image\n", index);
+        return EXIT_FAILURE;
+    }
+
+    size  = word_get(&p_ring[RING_SIZE_OF_BUFFER]);
+    wr    = word_get(&p_ring[RING_WR_OFF]);
+    rd    = word_get(&p_ring[RING_RD_OFF]);
+    p_buf = target_ptr_get(word_get(&p_ring[RING_BUFFER]), size);
+
+    if ((p_buf == NULL) || (wr >= size) || (rd >= size) || ((wr % sizeof(uint32_t)) != 0))
+    {
+        fprintf(stderr, "up-buffer %u is not an RTT stream in this image\n", index);
+        return EXIT_FAILURE;
+    }
+
+    return (frames_decode(p_buf, size, rd, wr) == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
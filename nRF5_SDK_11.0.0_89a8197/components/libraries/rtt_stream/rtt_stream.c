@@ -0,0 +1,232 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "rtt_stream.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "nrf_error.h"
+#include "app_util.h"
+#include "app_util_platform.h"
+#include "SEGGER_RTT.h"
+
+#define FRAME_SIZE(length)      (RTT_STREAM_FRAME_HEADER_SIZE + (((length) + 3u) & ~3u))  /**< Size of a frame in the ring buffer, in bytes. */
+#define DROP_FRAME_SIZE         FRAME_SIZE(2 * sizeof(uint32_t))                            /**< Size of a drop report frame, in bytes. */
+#define NO_SPACE                (RTT_STREAM_BUFFER_SIZE)                                    /**< Returned by space_get when a frame does not fit. */
+
+STATIC_ASSERT((RTT_STREAM_BUFFER_SIZE % sizeof(uint32_t)) == 0);
+STATIC_ASSERT(RTT_STREAM_BUFFER_INDEX < SEGGER_RTT_MAX_NUM_UP_BUFFERS);
+
+static uint32_t                 m_buffer[RTT_STREAM_BUFFER_SIZE / sizeof(uint32_t)];  /**< Ring buffer of the up-buffer. */
+static SEGGER_RTT_RING_BUFFER * mp_ring;            /**< Up-buffer descriptor in the RTT control block. */
+static rtt_stream_stats_t       m_stats;            /**< Stream statistics. */
+static uint32_t                 m_drops_reported;   /**< Number of dropped frames in the last drop report. */
+static bool                     m_reserved;         /**< A frame is reserved. */
+static uint32_t                 m_frame_offset;     /**< Offset of the reserved frame in the ring buffer. */
+static uint16_t                 m_frame_length;     /**< Payload length of the reserved frame. */
+
+
+static void header_write(uint32_t offset, uint8_t type, uint16_t length)
+{
+    m_buffer[offset / sizeof(uint32_t)] = RTT_STREAM_FRAME_SYNC |
+                                          ((uint32_t)type << 8) |
+                                          ((uint32_t)length << 16);
+}
+
+
+/**@brief Function for finding contiguous space in the ring buffer.
+ *
+ * @details If the space is only available at the start of the ring buffer, the rest of the ring
+ *          buffer is filled with a padding frame. The write offset is always a multiple of 4, but
+ *          the host may read any number of bytes, so the read offset may not be.
+ *
+ * @param[in]  size     Number of bytes needed, a multiple of 4.
+ *
+ * @return Offset of the space, or NO_SPACE.
+ */
+static uint32_t space_get(uint32_t size)
+{
+    uint32_t const wr = mp_ring->WrOff;
+    uint32_t const rd = mp_ring->RdOff;
+
+    // The write offset must not reach the read offset, since that would mean an empty buffer.
+    if (rd > wr)
+    {
+        return ((wr + size) < rd) ? wr : NO_SPACE;
+    }
+
+    if (((wr + size) < RTT_STREAM_BUFFER_SIZE) ||
+        (((wr + size) == RTT_STREAM_BUFFER_SIZE) && (rd != 0)))
+    {
+        return wr;
+    }
+
+    if (size < rd)
+    {
+        header_write(wr, RTT_STREAM_FRAME_TYPE_PAD,
+                     RTT_STREAM_BUFFER_SIZE - wr - RTT_STREAM_FRAME_HEADER_SIZE);
+        mp_ring->WrOff = 0;
+        return 0;
+    }
+
+    return NO_SPACE;
+}
+
+
+static void drop_record(uint16_t length)
+{
+    CRITICAL_REGION_ENTER();
+    m_stats.dropped_frames++;
+    m_stats.dropped_bytes += length;
+    CRITICAL_REGION_EXIT();
+}
+
+
+uint32_t rtt_stream_init(void)
+{
+    if (SEGGER_RTT_ConfigUpBuffer(RTT_STREAM_BUFFER_INDEX,
+                                  RTT_STREAM_BUFFER_NAME,
+                                  m_buffer,
+                                  RTT_STREAM_BUFFER_SIZE,
+                                  SEGGER_RTT_MODE_NO_BLOCK_SKIP) < 0)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    mp_ring = &_SEGGER_RTT.aUp[RTT_STREAM_BUFFER_INDEX];
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_drops_reported = 0;
+    m_reserved       = false;
+
+    return NRF_SUCCESS;
+}
+
+
+void * rtt_stream_reserve(uint8_t type, uint16_t length)
+{
+    bool     busy;
+    uint32_t dropped;
+    uint32_t size;
+    uint32_t offset;
+
+    if ((mp_ring == NULL)                         ||
+        (type < RTT_STREAM_FRAME_TYPE_USER_MIN)   ||
+        (type > RTT_STREAM_FRAME_TYPE_USER_MAX))
+    {
+        return NULL;
+    }
+
+    CRITICAL_REGION_ENTER();
+    busy       = m_reserved;
+    m_reserved = true;
+    CRITICAL_REGION_EXIT();
+
+    if (busy)
+    {
+        drop_record(length);
+        return NULL;
+    }
+
+    // Frames dropped since the last report are reported right before this frame.
+    dropped = m_stats.dropped_frames;
+    size    = FRAME_SIZE(length);
+    if (dropped != m_drops_reported)
+    {
+        size += DROP_FRAME_SIZE;
+    }
+
+    offset = space_get(size);
+    if (offset == NO_SPACE)
+    {
+        m_reserved = false;
+        drop_record(length);
+        return NULL;
+    }
+
+    if (dropped != m_drops_reported)
+    {
+        uint32_t * p_payload = &m_buffer[(offset + RTT_STREAM_FRAME_HEADER_SIZE) / sizeof(uint32_t)];
+
+        p_payload[0] = dropped;
+        p_payload[1] = m_stats.dropped_bytes;
+        header_write(offset, RTT_STREAM_FRAME_TYPE_DROP, 2 * sizeof(uint32_t));
+
+        offset          += DROP_FRAME_SIZE;
+        mp_ring->WrOff   = offset;
+        m_drops_reported = dropped;
+    }
+
+    m_frame_offset = offset;
+    m_frame_length = length;
+    header_write(offset, type, 0);
+
+    return &m_buffer[(offset + RTT_STREAM_FRAME_HEADER_SIZE) / sizeof(uint32_t)];
+}
+
+
+void rtt_stream_commit(uint16_t length)
+{
+    uint32_t offset;
+    uint32_t header;
+
+    if (!m_reserved)
+    {
+        return;
+    }
+
+    if (length > m_frame_length)
+    {
+        length = m_frame_length;
+    }
+
+    // Keep the type written by rtt_stream_reserve, and fill in the actual length.
+    header = m_buffer[m_frame_offset / sizeof(uint32_t)];
+    header_write(m_frame_offset, (uint8_t)(header >> 8), length);
+
+    offset = m_frame_offset + FRAME_SIZE(length);
+    if (offset == RTT_STREAM_BUFFER_SIZE)
+    {
+        offset = 0;
+    }
+
+    // The frame must be complete in memory before the host can see it.
+    __DMB();
+    mp_ring->WrOff = offset;
+
+    m_stats.frames++;
+    m_stats.bytes += length;
+    m_reserved     = false;
+}
+
+
+uint32_t rtt_stream_write(uint8_t type, void const * p_data, uint16_t length)
+{
+    void * p_payload = rtt_stream_reserve(type, length);
+
+    if (p_payload == NULL)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    memcpy(p_payload, p_data, length);
+    rtt_stream_commit(length);
+
+    return NRF_SUCCESS;
+}
+
+
+void rtt_stream_stats_get(rtt_stream_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_stats;
+    CRITICAL_REGION_EXIT();
+}
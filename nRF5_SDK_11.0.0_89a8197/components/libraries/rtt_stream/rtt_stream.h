@@ -0,0 +1,116 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/** @file
+ *
+ * @defgroup rtt_stream RTT binary stream
+ * @{
+ * @ingroup app_common
+ *
+ * @brief Module for streaming framed binary data to the host over a dedicated RTT channel.
+ *
+ * @details Data is written as frames directly into the ring buffer of the RTT up-buffer
+ *          @ref RTT_STREAM_BUFFER_INDEX. @ref rtt_stream_reserve returns a pointer into the ring
+ *          buffer, so that the caller can build the frame payload in place, and
+ *          @ref rtt_stream_commit makes the frame visible to the host. Frames are never split
+ *          across the end of the ring buffer.
+ *
+ *          When the host does not read the buffer fast enough, frames that do not fit are
+ *          dropped and counted. The next frame that fits is preceded by a
+ *          @ref RTT_STREAM_FRAME_TYPE_DROP frame, so that the host knows where data is missing.
+ *
+ *          Frame format, all fields little endian:
+ *
+ *          | Offset | Size   | Field                                                    |
+ *          |--------|--------|----------------------------------------------------------|
+ *          | 0      | 1      | @ref RTT_STREAM_FRAME_SYNC                               |
+ *          | 1      | 1      | Frame type                                               |
+ *          | 2      | 2      | Payload length in bytes                                  |
+ *          | 4      | length | Payload, followed by 0-3 padding bytes                   |
+ *
+ *          Frames start on a 4-byte boundary. A reader decodes a dumped buffer by starting at
+ *          RdOff of the up-buffer descriptor in the _SEGGER_RTT control block, and reading frames
+ *          until it reaches WrOff, wrapping to offset 0 at the end of the buffer.
+ *          @ref RTT_STREAM_FRAME_TYPE_PAD frames carry no data and must be skipped.
+ *          host/rtt_stream_reader.c is a command line tool that decodes the stream from a RAM dump.
+ *
+ * @note    One frame can be reserved at a time. A reservation attempted while another one is
+ *          open, for example from an interrupt handler, fails and is counted as dropped.
+ */
+
+#ifndef RTT_STREAM_H__
+#define RTT_STREAM_H__
+
+#include <stdint.h>
+#include "rtt_stream_config.h"
+
+#define RTT_STREAM_FRAME_SYNC           (0xA5)  /**< First byte of every frame. */
+#define RTT_STREAM_FRAME_HEADER_SIZE    (4)     /**< Size of the frame header, in bytes. */
+
+#define RTT_STREAM_FRAME_TYPE_PAD       (0x00)  /**< Filler up to the end of the ring buffer. */
+#define RTT_STREAM_FRAME_TYPE_DROP      (0xFF)  /**< Drop report. The payload is the total number of dropped frames and bytes, as two 32-bit words. */
+#define RTT_STREAM_FRAME_TYPE_USER_MIN  (0x01)  /**< First frame type available to the application. */
+#define RTT_STREAM_FRAME_TYPE_USER_MAX  (0xFE)  /**< Last frame type available to the application. */
+
+/**@brief Stream statistics. */
+typedef struct
+{
+    uint32_t frames;            /**< Number of frames committed, excluding padding and drop reports. */
+    uint32_t bytes;             /**< Number of payload bytes committed. */
+    uint32_t dropped_frames;    /**< Number of frames dropped. */
+    uint32_t dropped_bytes;     /**< Number of payload bytes dropped. */
+} rtt_stream_stats_t;
+
+/**@brief Function for initializing the module and configuring the RTT up-buffer.
+ *
+ * @retval NRF_SUCCESS              The up-buffer was configured.
+ * @retval NRF_ERROR_INVALID_PARAM  The RTT control block does not have the configured up-buffer.
+ */
+uint32_t rtt_stream_init(void);
+
+/**@brief Function for reserving space for a frame in the ring buffer.
+ *
+ * @param[in]  type     Frame type, from @ref RTT_STREAM_FRAME_TYPE_USER_MIN to
+ *                      @ref RTT_STREAM_FRAME_TYPE_USER_MAX.
+ * @param[in]  length   Maximum payload length, in bytes.
+ *
+ * @return Pointer to the 4-byte aligned payload area, or NULL if the frame was dropped because
+ *         there is not enough space, another reservation is open, or the parameters are invalid.
+ */
+void * rtt_stream_reserve(uint8_t type, uint16_t length);
+
+/**@brief Function for committing the reserved frame.
+ *
+ * @param[in]  length   Actual payload length, in bytes. Must not exceed the reserved length.
+ */
+void rtt_stream_commit(uint16_t length);
+
+/**@brief Function for writing a frame by copying the payload into the ring buffer.
+ *
+ * @param[in]  type     Frame type.
+ * @param[in]  p_data   Payload.
+ * @param[in]  length   Payload length, in bytes.
+ *
+ * @retval NRF_SUCCESS      The frame was written.
+ * @retval NRF_ERROR_NO_MEM The frame was dropped.
+ */
+uint32_t rtt_stream_write(uint8_t type, void const * p_data, uint16_t length);
+
+/**@brief Function for reading the stream statistics.
+ *
+ * @param[out] p_stats  Statistics.
+ */
+void rtt_stream_stats_get(rtt_stream_stats_t * p_stats);
+
+#endif // RTT_STREAM_H__
+
+/** @} */
@@ -18,6 +18,9 @@
 #include "nrf_assert.h"
 #include "app_util.h"
 #include "app_util_platform.h"
+#ifdef APP_EVENT_TRACE_ENABLED
+#include "app_event_trace.h"
+#endif
 
 /**@brief Structure for holding a scheduled event header. */
 typedef struct
@@ -222,6 +225,9 @@ void app_sched_execute(void)
     // Get next event (if any), and execute handler
     while ((app_sched_event_get(&p_event_data, &event_data_size, &event_handler) == NRF_SUCCESS))
     {
+#ifdef APP_EVENT_TRACE_ENABLED
+        app_event_trace_record(APP_EVENT_TRACE_TYPE_SCHED, (uint32_t)event_handler);
+#endif
         event_handler(p_event_data, event_data_size);
     }
 }
@@ -220,51 +220,88 @@ static __INLINE void rtc1_compare0_set(uint32_t value)
 }
 
 
-/**@brief Function for inserting a timer in the timer list.
+/**@brief Function for inserting a timer in a list sorted on absolute expiry ticks.
  *
- * @param[in]  timer_id   Id of timer to insert.
+ * @param[in]  p_list_head   List to insert the timer in.
+ * @param[in]  p_timer       Timer to insert. ticks_to_expire holds the number of ticks from
+ *                           m_ticks_latest to expiry.
+ *
+ * @return     New head of the list.
  */
-static void timer_list_insert(timer_node_t * p_timer)
+static timer_node_t * sorted_list_insert(timer_node_t * p_list_head, timer_node_t * p_timer)
 {
-    if (mp_timer_id_head == NULL)
+    timer_node_t * p_previous = NULL;
+    timer_node_t * p_current  = p_list_head;
+
+    while ((p_current != NULL) && (p_timer->ticks_to_expire >= p_current->ticks_to_expire))
     {
-        mp_timer_id_head = p_timer;
+        p_previous = p_current;
+        p_current  = p_current->next;
     }
-    else
+
+    p_timer->next = p_current;
+
+    if (p_previous == NULL)
     {
-        if (p_timer->ticks_to_expire <= mp_timer_id_head->ticks_to_expire)
+        return p_timer;
+    }
+
+    p_previous->next = p_timer;
+    return p_list_head;
+}
+
+
+/**@brief Function for merging timers into the timer list in a single pass.
+ *
+ * @details The timer list is walked once, however many timers are inserted. A new timer is
+ *          placed before running timers that expire at the same tick.
+ *
+ * @param[in]  p_sorted_head   List of timers sorted on absolute expiry ticks, as built by
+ *                             @ref sorted_list_insert.
+ */
+static void timer_list_merge(timer_node_t * p_sorted_head)
+{
+    timer_node_t * p_previous  = NULL;               // Node before p_current, NULL at the head.
+    timer_node_t * p_current   = mp_timer_id_head;
+    uint32_t       ticks_prev  = 0;                  // Absolute expiry ticks of p_previous.
+
+    while (p_sorted_head != NULL)
+    {
+        timer_node_t * p_timer = p_sorted_head;
+        uint32_t       ticks_to_expire;
+
+        p_sorted_head = p_timer->next;
+
+        // Skip timers expiring before the new one. On equal expiry, the new timer goes first.
+        while ((p_current != NULL) &&
+               (p_timer->ticks_to_expire > ticks_prev + p_current->ticks_to_expire))
         {
-            mp_timer_id_head->ticks_to_expire -= p_timer->ticks_to_expire;
-            
-            p_timer->next   = mp_timer_id_head;
-            mp_timer_id_head = p_timer;
+            ticks_prev += p_current->ticks_to_expire;
+            p_previous  = p_current;
+            p_current   = p_current->next;
         }
-        else
-        {
-            timer_node_t * p_previous;
-            timer_node_t * p_current;
-            uint32_t       ticks_to_expire;
 
-            ticks_to_expire   = p_timer->ticks_to_expire;
-            p_previous        = mp_timer_id_head;
-            p_current         = mp_timer_id_head;
-            
-            while ((p_current != NULL) && (ticks_to_expire > p_current->ticks_to_expire))
-            {
-                ticks_to_expire   -= p_current->ticks_to_expire;
-                p_previous         = p_current;
-                p_current          = p_current->next;
-            }
+        ticks_to_expire = p_timer->ticks_to_expire - ticks_prev;
 
-            if (p_current != NULL)
-            {
-                p_current->ticks_to_expire -= ticks_to_expire;
-            }
+        if (p_current != NULL)
+        {
+            p_current->ticks_to_expire -= ticks_to_expire;
+        }
+
+        p_timer->ticks_to_expire = ticks_to_expire;
+        p_timer->next            = p_current;
 
-            p_timer->ticks_to_expire = ticks_to_expire;
-            p_timer->next            = p_current;
-            p_previous->next         = p_timer;
+        if (p_previous == NULL)
+        {
+            mp_timer_id_head = p_timer;
+        }
+        else
+        {
+            p_previous->next = p_timer;
         }
+
+        ticks_prev += ticks_to_expire;
+        p_previous  = p_timer;
     }
 }
 
@@ -585,6 +622,7 @@ static void expired_timers_handler(uint32_t         ticks_elapsed,
 static bool list_insertions_handler(timer_node_t * p_restart_list_head)
 {
     timer_node_t * p_timer_id_old_head;
+    timer_node_t * p_sorted_head = NULL;
     uint8_t        user_id;
 
     // Remember the old head, so as to decide if new compare needs to be set.
@@ -661,13 +699,14 @@ static bool list_insertions_handler(timer_node_t * p_restart_list_head)
             p_timer->ticks_at_start       = 0;
             p_timer->ticks_first_interval = 0;
             p_timer->is_running           = true;
-            p_timer->next                 = NULL;
 
-            // Insert into list 
-            timer_list_insert(p_timer);
+            // Collect the timers, so that they can be merged into the list in one pass.
+            p_sorted_head = sorted_list_insert(p_sorted_head, p_timer);
         }
     }
-    
+
+    timer_list_merge(p_sorted_head);
+
     return (mp_timer_id_head != p_timer_id_old_head);
 }
 
@@ -1129,6 +1168,87 @@ uint32_t app_timer_stop_all(void)
 }
 
 
+uint32_t app_timer_batch(app_timer_batch_op_t const * p_ops, uint32_t count)
+{
+    timer_user_t * p_user;
+    uint32_t       ticks_at_start;
+    uint32_t       free;
+    uint8_t        last;
+    uint32_t       i;
+
+    // Check state and parameters
+    VERIFY_MODULE_INITIALIZED();
+
+    if (p_ops == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        timer_node_t * p_node = (timer_node_t *)p_ops[i].timer_id;
+
+        if ((p_node == NULL) || (p_node->p_timeout_handler == NULL))
+        {
+            return NRF_ERROR_INVALID_STATE;
+        }
+        if ((p_ops[i].timeout_ticks != 0) && (p_ops[i].timeout_ticks < APP_TIMER_MIN_TIMEOUT_TICKS))
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+    }
+
+    p_user = &mp_users[user_id_get()];
+
+    // One entry is always left unused, see user_op_alloc().
+    free = (p_user->first + p_user->user_op_queue_size - p_user->last - 1) %
+           p_user->user_op_queue_size;
+    if (count > free)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    ticks_at_start = rtc1_counter_get();
+    last           = p_user->last;
+
+    for (i = 0; i < count; i++)
+    {
+        timer_user_op_t * p_user_op = &p_user->p_user_op_queue[last];
+        timer_node_t    * p_node    = (timer_node_t *)p_ops[i].timer_id;
+
+        p_user_op->p_node = p_node;
+
+        if (p_ops[i].timeout_ticks == 0)
+        {
+            p_node->is_running = false;
+            p_user_op->op_type = TIMER_USER_OP_TYPE_STOP;
+        }
+        else
+        {
+            p_user_op->op_type                              = TIMER_USER_OP_TYPE_START;
+            p_user_op->params.start.ticks_at_start          = ticks_at_start;
+            p_user_op->params.start.ticks_first_interval    = p_ops[i].timeout_ticks;
+            p_user_op->params.start.ticks_periodic_interval =
+                (p_node->mode == APP_TIMER_MODE_REPEATED) ? p_ops[i].timeout_ticks : 0;
+            p_user_op->params.start.p_context               = p_ops[i].p_context;
+        }
+
+        last++;
+        if (last == p_user->user_op_queue_size)
+        {
+            last = 0;
+        }
+    }
+
+    // Make all operations visible to the timer list handler at once.
+    user_op_enque(p_user, last);
+
+    timer_list_handler_sched();
+
+    return NRF_SUCCESS;
+}
+
+
 uint32_t app_timer_cnt_get(uint32_t * p_ticks)
 {
     *p_ticks = rtc1_counter_get();
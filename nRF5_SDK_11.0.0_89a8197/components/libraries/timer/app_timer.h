@@ -252,6 +252,33 @@ uint32_t app_timer_stop(app_timer_id_t timer_id);
  */
 uint32_t app_timer_stop_all(void);
 
+/**@brief Timer operation, for use with @ref app_timer_batch. */
+typedef struct
+{
+    app_timer_id_t timer_id;        /**< Timer identifier. */
+    uint32_t       timeout_ticks;   /**< Number of ticks to the time-out event, for starting the timer. Zero for stopping the timer. */
+    void *         p_context;       /**< General purpose pointer passed to the time-out handler when the timer expires. */
+} app_timer_batch_op_t;
+
+/**@brief Function for starting and stopping several timers at once.
+ *
+ * @details All operations are queued together and the timer list is updated with a single
+ *          software interrupt, in which the started timers are merged into the timer list in one
+ *          pass. All started timers use the same start tick. Stop operations are executed before
+ *          start operations, as when calling @ref app_timer_stop and @ref app_timer_start.
+ *
+ * @param[in]  p_ops                     Timer operations.
+ * @param[in]  count                     Number of operations.
+ *
+ * @retval     NRF_SUCCESS               If all operations were queued.
+ * @retval     NRF_ERROR_INVALID_PARAM   If a parameter was invalid. No operation was queued.
+ * @retval     NRF_ERROR_INVALID_STATE   If the application timer module has not been initialized or a
+ *                                       timer has not been created. No operation was queued.
+ * @retval     NRF_ERROR_NO_MEM          If the timer operations queue does not have room for all
+ *                                       operations. No operation was queued.
+ */
+uint32_t app_timer_batch(app_timer_batch_op_t const * p_ops, uint32_t count);
+
 /**@brief Function for returning the current value of the RTC1 counter.
  *
  * @param[out] p_ticks   Current value of the RTC1 counter.
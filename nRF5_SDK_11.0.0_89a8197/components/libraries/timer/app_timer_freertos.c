@@ -228,3 +228,33 @@ uint32_t app_timer_stop(app_timer_id_t timer_id)
     pinfo->active = false;
     return NRF_SUCCESS;
 }
+
+
+uint32_t app_timer_batch(app_timer_batch_op_t const * p_ops, uint32_t count)
+{
+    uint32_t err_code;
+
+    if (p_ops == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    // The operations are passed on one at a time, so the batch is not atomic here.
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (p_ops[i].timeout_ticks == 0)
+        {
+            err_code = app_timer_stop(p_ops[i].timer_id);
+        }
+        else
+        {
+            err_code = app_timer_start(p_ops[i].timer_id, p_ops[i].timeout_ticks, p_ops[i].p_context);
+        }
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+    }
+
+    return NRF_SUCCESS;
+}
@@ -220,6 +220,36 @@ uint32_t app_timer_stop_all(void)
 }
 
 
+uint32_t app_timer_batch(app_timer_batch_op_t const * p_ops, uint32_t count)
+{
+    uint32_t err_code;
+
+    if (p_ops == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+
+    // The operations are passed on one at a time, so the batch is not atomic here.
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (p_ops[i].timeout_ticks == 0)
+        {
+            err_code = app_timer_stop(p_ops[i].timer_id);
+        }
+        else
+        {
+            err_code = app_timer_start(p_ops[i].timer_id, p_ops[i].timeout_ticks, p_ops[i].p_context);
+        }
+        if (err_code != NRF_SUCCESS)
+        {
+            return err_code;
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+
 extern uint32_t os_tick_val(void);
 uint32_t app_timer_cnt_get(uint32_t * p_ticks)
 {
@@ -120,6 +120,34 @@ uint32_t app_uart_put(uint8_t byte)
     }
 }
 
+uint32_t app_uart_write(uint8_t const * p_data, uint32_t * p_length)
+{
+    uint32_t err_code = NRF_SUCCESS;
+    uint32_t written  = 0;
+
+    ASSERT(p_length);
+
+    if (p_data == NULL)
+    {
+        *p_length = nrf_drv_uart_tx_in_progress() ? 0 : 1;
+        return NRF_SUCCESS;
+    }
+
+    // Without a FIFO, only one byte can be transmitted at a time.
+    while ((written < *p_length) && (err_code == NRF_SUCCESS))
+    {
+        err_code = app_uart_put(p_data[written]);
+        if (err_code == NRF_SUCCESS)
+        {
+            written++;
+        }
+    }
+
+    *p_length = written;
+
+    return (written > 0) ? NRF_SUCCESS : err_code;
+}
+
 uint32_t app_uart_flush(void)
 {
     return NRF_SUCCESS;
@@ -99,6 +99,11 @@ typedef struct
  */
 typedef void (* app_uart_event_handler_t) (app_uart_evt_t * p_app_uart_event);
 
+/**@brief Maximum number of bytes handed to the UART driver in one transfer when using a FIFO. */
+#ifndef APP_UART_TX_CHUNK_SIZE
+#define APP_UART_TX_CHUNK_SIZE  (16)
+#endif
+
 /**@brief Macro for safe initialization of the UART module in a single user instance when using
  *        a FIFO together with UART.
  *
@@ -206,6 +211,24 @@ uint32_t app_uart_get(uint8_t * p_byte);
  */
 uint32_t app_uart_put(uint8_t byte);
 
+/**@brief Function for putting several bytes on the UART.
+ *
+ * @details This call is non-blocking. As many bytes as there is room for are put on the TX buffer,
+ *          and the rest is left to the caller. When the FIFO is used, the bytes are transmitted
+ *          in chunks of up to @ref APP_UART_TX_CHUNK_SIZE bytes, using EasyDMA if enabled.
+ *
+ * @param[in]    p_data     Bytes to be transmitted on the UART. If NULL, @p p_length returns the
+ *                          number of bytes that can currently be put on the TX buffer.
+ * @param[inout] p_length   Number of bytes to put on the TX buffer. Overwritten with the number
+ *                          of bytes actually put on the TX buffer.
+ *
+ * @retval NRF_SUCCESS        If at least one byte was put on the TX buffer, or if @p p_data is
+ *                            NULL.
+ * @retval NRF_ERROR_NO_MEM   If no space is available in the TX buffer.
+ * @retval NRF_ERROR_INTERNAL If UART driver reported error.
+ */
+uint32_t app_uart_write(uint8_t const * p_data, uint32_t * p_length);
+
 /**@brief Function for flushing the RX and TX buffers (Only valid if FIFO is used).
  *        This function does nothing if FIFO is not used.
  *
@@ -26,12 +26,27 @@ static __INLINE uint32_t fifo_length(app_fifo_t * const fifo)
 
 
 static app_uart_event_handler_t   m_event_handler;            /**< Event handler function. */
-static uint8_t tx_buffer[1];
+static uint8_t tx_buffer[APP_UART_TX_CHUNK_SIZE];
+
+STATIC_ASSERT(APP_UART_TX_CHUNK_SIZE <= UINT8_MAX);
 static uint8_t rx_buffer[1];
 
 static app_fifo_t                  m_rx_fifo;                               /**< RX FIFO buffer for storing data received on the UART until the application fetches them using app_uart_get(). */
 static app_fifo_t                  m_tx_fifo;                               /**< TX FIFO buffer for storing data to be transmitted on the UART when TXD is ready. Data is put to the buffer on using app_uart_put(). */
 
+// Hands the next chunk of the TX FIFO to the driver.
+static uint32_t tx_chunk_start(void)
+{
+    uint32_t length = sizeof(tx_buffer);
+
+    if (app_fifo_read(&m_tx_fifo, tx_buffer, &length) == NRF_SUCCESS)
+    {
+        return nrf_drv_uart_tx(tx_buffer, length);
+    }
+
+    return NRF_SUCCESS;
+}
+
 static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
 {
     app_uart_evt_t app_uart_event;
@@ -70,11 +85,8 @@ static void uart_event_handler(nrf_drv_uart_event_t * p_event, void* p_context)
     }
     else if (p_event->type == NRF_DRV_UART_EVT_TX_DONE)
     {
-        // Get next byte from FIFO.
-        if (app_fifo_get(&m_tx_fifo, tx_buffer) == NRF_SUCCESS)
-        {
-            (void)nrf_drv_uart_tx(tx_buffer, 1);
-        }
+        // Get next bytes from FIFO.
+        (void)tx_chunk_start();
         if (FIFO_LENGTH(m_tx_fifo) == 0)
         {
             // Last byte from FIFO transmitted, notify the application.
@@ -174,16 +186,33 @@ uint32_t app_uart_put(uint8_t byte)
             // just added a byte to FIFO, but if some bigger delay occurred
             // (some heavy interrupt handler routine has been executed) since
             // that time, FIFO might be empty already.
-            if (app_fifo_get(&m_tx_fifo, tx_buffer) == NRF_SUCCESS)
-            {
-                err_code = nrf_drv_uart_tx(tx_buffer, 1);
-            }
+            err_code = tx_chunk_start();
         }
     }
 
     return err_code;
 }
 
+uint32_t app_uart_write(uint8_t const * p_data, uint32_t * p_length)
+{
+    uint32_t err_code;
+
+    ASSERT(p_length);
+
+    err_code = app_fifo_write(&m_tx_fifo, p_data, p_length);
+    if ((err_code == NRF_SUCCESS) && (p_data != NULL))
+    {
+        // Start a new transmission if the UART is idle, see app_uart_put.
+        if (!nrf_drv_uart_tx_in_progress())
+        {
+            err_code = tx_chunk_start();
+        }
+    }
+
+    return (err_code == NRF_SUCCESS) ? NRF_SUCCESS :
+           (err_code == NRF_ERROR_NO_MEM) ? NRF_ERROR_NO_MEM : NRF_ERROR_INTERNAL;
+}
+
 uint32_t app_uart_close(void)
 {
     nrf_drv_uart_uninit();
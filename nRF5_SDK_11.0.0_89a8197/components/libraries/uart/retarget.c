@@ -19,6 +19,16 @@
 #include "nordic_common.h"
 #include "nrf_error.h"
 
+/**@brief Configures the behavior when the UART TX buffer is full.
+ *
+ * When 0, output that does not fit in the TX buffer is dropped, and the caller never waits.
+ * When 1, the caller waits until all output has been put in the TX buffer. Do not use blocking
+ * output from interrupt handlers with a priority equal to or higher than the UART interrupt.
+ */
+#ifndef RETARGET_BLOCK_WHEN_FULL
+#define RETARGET_BLOCK_WHEN_FULL    (0)
+#endif
+
 #if !defined(__ICCARM__)
 struct __FILE 
 {
@@ -30,6 +40,26 @@ FILE __stdout;
 FILE __stdin;
 
 
+// Hands a whole string to the UART TX buffer, instead of one byte at a time.
+static void output_write(uint8_t const * p_data, uint32_t length)
+{
+    while (length > 0)
+    {
+        uint32_t written = length;
+
+        if (app_uart_write(p_data, &written) == NRF_SUCCESS)
+        {
+            p_data += written;
+            length -= written;
+        }
+        else if (!RETARGET_BLOCK_WHEN_FULL)
+        {
+            break;
+        }
+    }
+}
+
+
 #if defined(__CC_ARM) ||  defined(__ICCARM__)
 int fgetc(FILE * p_file)
 {
@@ -42,11 +72,17 @@ int fgetc(FILE * p_file)
 }
 
 
+// The C library calls fputc for every character. The character is put in the UART TX buffer
+// right away, so that output without a trailing newline is not held back, and so that fputc
+// keeps no state shared between callers in different contexts.
 int fputc(int ch, FILE * p_file)
 {
+    uint8_t const c = (uint8_t)ch;
+
     UNUSED_PARAMETER(p_file);
 
-    UNUSED_VARIABLE(app_uart_put((uint8_t)ch));
+    output_write(&c, 1);
+
     return ch;
 }
 
@@ -55,14 +91,9 @@ int fputc(int ch, FILE * p_file)
 
 int _write(int file, const char * p_char, int len)
 {
-    int i;
-
     UNUSED_PARAMETER(file);
 
-    for (i = 0; i < len; i++)
-    {
-        UNUSED_VARIABLE(app_uart_put(*p_char++));
-    }
+    output_write((uint8_t const *)p_char, len);
 
     return len;
 }
@@ -84,14 +115,9 @@ int _read(int file, char * p_char, int len)
 
 __ATTRIBUTES size_t __write(int file, const unsigned char * p_char, size_t len)
 {
-    int i;
-
     UNUSED_PARAMETER(file);
 
-    for (i = 0; i < len; i++)
-    {
-        UNUSED_VARIABLE(app_uart_put(*p_char++));
-    }
+    output_write(p_char, len);
 
     return len;
 }
@@ -25,6 +25,9 @@
 #include "nordic_common.h"
 #include "sdk_errors.h"
 #include "nrf_log.h"
+#ifdef APP_EVENT_TRACE_ENABLED
+#include "app_event_trace.h"
+#endif
 
 #ifdef DEBUG
 #include "bsp.h"
@@ -51,6 +54,9 @@ void app_error_handler(ret_code_t error_code, uint32_t line_num, const uint8_t *
         .p_file_name = p_file_name,
         .err_code    = error_code,
     };
+#ifdef APP_EVENT_TRACE_ENABLED
+    app_event_trace_record(APP_EVENT_TRACE_TYPE_ERROR, (error_code & 0xFFFF) | (line_num << 16));
+#endif
     app_error_fault_handler(NRF_FAULT_ID_SDK_ERROR, 0, (uint32_t)(&error_info));
 
     UNUSED_VARIABLE(error_info);
@@ -65,6 +71,9 @@ void app_error_handler_bare(ret_code_t error_code)
         .p_file_name = NULL,
         .err_code    = error_code,
     };
+#ifdef APP_EVENT_TRACE_ENABLED
+    app_event_trace_record(APP_EVENT_TRACE_TYPE_ERROR, error_code & 0xFFFF);
+#endif
     app_error_fault_handler(NRF_FAULT_ID_SDK_ERROR, 0, (uint32_t)(&error_info));
 
     UNUSED_VARIABLE(error_info);
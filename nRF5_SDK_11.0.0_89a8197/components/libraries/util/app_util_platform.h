@@ -89,6 +89,26 @@ typedef enum
 void app_util_critical_region_enter (uint8_t *p_nested);
 void app_util_critical_region_exit (uint8_t nested);
 
+#ifdef CS_PROFILER_ENABLED
+#include "cs_profiler.h"
+
+/* When the critical section profiler is enabled, every critical region gets its own call site
+ * record, and the time between entry and exit is recorded.
+ */
+#define CRITICAL_REGION_ENTER()                                                             \
+    {                                                                                       \
+        uint8_t __CR_NESTED = 0;                                                            \
+        static cs_profiler_site_t __CR_SITE = CS_PROFILER_SITE_INIT;                        \
+        app_util_critical_region_enter(&__CR_NESTED);                                       \
+        cs_profiler_cr_enter(&__CR_SITE);
+
+#define CRITICAL_REGION_EXIT()                                                              \
+        cs_profiler_cr_exit(&__CR_SITE);                                                    \
+        app_util_critical_region_exit(__CR_NESTED);                                         \
+    }
+
+#else // CS_PROFILER_ENABLED
+
 /**@brief Macro for entering a critical region.
  *
  * @note Due to implementation details, there must exist one and only one call to
@@ -118,6 +138,8 @@ void app_util_critical_region_exit (uint8_t nested);
 #define CRITICAL_REGION_EXIT() app_util_critical_region_exit(0)
 #endif 
 
+#endif // CS_PROFILER_ENABLED
+
 /* Workaround for Keil 4 */
 #ifndef IPSR_ISR_Msk
 #define IPSR_ISR_Msk                       (0x1FFUL /*<< IPSR_ISR_Pos*/)                  /*!< IPSR: ISR Mask */
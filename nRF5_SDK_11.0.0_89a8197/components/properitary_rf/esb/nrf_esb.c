@@ -509,6 +509,12 @@ static void start_tx_transaction()
 
 
 void RADIO_IRQHandler()
+{
+    nrf_esb_radio_irq_handler();
+}
+
+
+void nrf_esb_radio_irq_handler(void)
 {
     if (NRF_RADIO->EVENTS_READY && (NRF_RADIO->INTENSET & RADIO_INTENSET_READY_Msk))
     {
@@ -896,6 +902,28 @@ bool nrf_esb_is_idle(void)
 }
 
 
+uint32_t nrf_esb_radio_restore(void)
+{
+    VERIFY_TRUE(m_esb_initialized, NRF_ERROR_INVALID_STATE);
+    VERIFY_TRUE(m_nrf_esb_mainstate == NRF_ESB_STATE_IDLE, NRF_ERROR_BUSY);
+
+    update_radio_parameters();
+    update_radio_addresses(NRF_ESB_ADDR_UPDATE_MASK_BASE0 |
+                           NRF_ESB_ADDR_UPDATE_MASK_BASE1 |
+                           NRF_ESB_ADDR_UPDATE_MASK_PREFIX);
+    sys_timer_init();
+    ppi_init();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_tx_fifo_count_get(void)
+{
+    return m_tx_fifo.count;
+}
+
+
 void ESB_EVT_IRQHandler(void)
 {
     ret_code_t      err_code;
@@ -70,13 +70,17 @@ STATIC_ASSERT(NRF_ESB_MAX_PAYLOAD_LENGTH <= 252);
 #define     NRF_ESB_PID_MAX                     3                   /**< Maximum value for PID. */
 #define     NRF_ESB_CRC_RESET_VALUE             0xFFFF              /**< CRC reset value*/
 
+// SWI0 is used by app_timer, and SWI1 by Gazell and the radio notification module. Define
+// ESB_EVT_IRQ and ESB_EVT_IRQHandler in the project to use another software interrupt.
+#ifndef ESB_EVT_IRQ
 #ifdef NRF51
-#define ESB_EVT_IRQ        SWI0_IRQn                                /**< ESB Event IRQ number when running on a nRF51 device. */
-#define ESB_EVT_IRQHandler SWI0_IRQHandler                          /**< The handler for ESB_EVT_IRQ when running on a nRF51 device. */
+#define ESB_EVT_IRQ        SWI3_IRQn                                /**< ESB Event IRQ number when running on a nRF51 device. */
+#define ESB_EVT_IRQHandler SWI3_IRQHandler                          /**< The handler for ESB_EVT_IRQ when running on a nRF51 device. */
 #elif defined (NRF52)
-#define ESB_EVT_IRQ        SWI0_EGU0_IRQn                           /**< ESB Event IRQ number when running on a nRF52 device. */
-#define ESB_EVT_IRQHandler SWI0_EGU0_IRQHandler                     /**< The handler for ESB_EVT_IRQ when running on a nRF52 device. */
+#define ESB_EVT_IRQ        SWI3_EGU3_IRQn                           /**< ESB Event IRQ number when running on a nRF52 device. */
+#define ESB_EVT_IRQHandler SWI3_EGU3_IRQHandler                     /**< The handler for ESB_EVT_IRQ when running on a nRF52 device. */
 #endif /* NRF51 */
+#endif /* ESB_EVT_IRQ */
 
 #define     NRF_ESB_SYS_TIMER                   NRF_TIMER2          /**< System timer used by nrf_esb */
 #define     NRF_ESB_SYS_TIMER_IRQ_Handler       TIMER2_IRQHandler   /**< Timer IRQ handler used by nrf_esb */
@@ -326,6 +330,35 @@ uint32_t nrf_esb_disable(void);
 bool nrf_esb_is_idle(void);
 
 
+/**@brief Function to re-apply the radio configuration.
+ *
+ * @details Use this function when the RADIO peripheral has been used by another protocol since
+ *          the module was initialized, for example at the start of a SoftDevice radio timeslot.
+ *          Unlike @ref nrf_esb_init, the TX and RX FIFOs are kept.
+ *
+ * @retval  NRF_SUCCESS                     Radio configuration restored.
+ * @retval  NRF_ERROR_INVALID_STATE         Module is not initialized.
+ * @retval  NRF_ERROR_BUSY                  Module is not idle.
+ */
+uint32_t nrf_esb_radio_restore(void);
+
+
+/**@brief Function for handling RADIO interrupts.
+ *
+ * @details This function is called by the RADIO interrupt handler of the module. When the
+ *          RADIO interrupt is owned by someone else, for example by the SoftDevice during a radio
+ *          timeslot, the owner must call this function for every RADIO interrupt.
+ */
+void nrf_esb_radio_irq_handler(void);
+
+
+/**@brief Function to get the number of payloads in the TX FIFO.
+ *
+ * @return  Number of queued TX payloads.
+ */
+uint32_t nrf_esb_tx_fifo_count_get(void);
+
+
 /**@brief Function to write TX or ack payload.
  *
  * Function for writing a payload to be added to the queue. When the module is in PTX mode, the
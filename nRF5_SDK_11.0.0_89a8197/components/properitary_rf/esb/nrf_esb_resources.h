@@ -18,7 +18,7 @@
 #ifndef ESB_ALTERNATIVE_RESOURCES
 	#define ESB_PPI_CHANNELS_USED    0x00000007uL /**< PPI channels utilized by ESB (not available to th spplication). */
 	#define ESB_TIMERS_USED          0x00000004uL /**< Timers used by ESB. */
-	#define ESB_SWI_USED             0x00000001uL /**< Software interrupts used by ESB */
+	#define ESB_SWI_USED             0x00000008uL /**< Software interrupts used by ESB */
 #else
 	#define ESB_PPI_CHANNELS_USED    0x00000700uL /**< PPI channels utilized by ESB (not available to th spplication). */
 	#define ESB_TIMERS_USED          0x00000001uL /**< Timers used by ESB. */
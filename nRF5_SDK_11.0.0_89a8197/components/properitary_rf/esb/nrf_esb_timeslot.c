@@ -0,0 +1,480 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "nrf_esb_timeslot.h"
+#include <string.h>
+#include "nrf.h"
+#include "nrf_soc.h"
+#include "nrf_error.h"
+#include "app_util_platform.h"
+#include "sdk_common.h"
+#include "sdk_macros.h"
+
+#define SLOT_TIMER              NRF_TIMER0          /**< Timer started by the SoftDevice at the start of every timeslot, running at 1 MHz. */
+#define SLOT_TIMER_CC_MARGIN    0                   /**< Compare channel marking the start of the end margin. */
+
+// Module state
+static nrf_esb_config_t                         m_esb_config;
+static nrf_esb_timeslot_config_t                m_config;
+static nrf_esb_address_t                        m_address = NRF_ESB_ADDR_DEFAULT;
+static nrf_esb_event_handler_t                  m_app_event_handler;
+static nrf_esb_timeslot_stats_t                 m_stats;
+
+static volatile bool                            m_session_open;
+static volatile bool                            m_uninit_pending;
+static volatile bool                            m_esb_ready;            /**< ESB has been initialized in a timeslot. */
+
+// Current timeslot
+static volatile bool                            m_in_slot;
+static volatile bool                            m_closing;              /**< No new transactions are started in the current timeslot. */
+static volatile bool                            m_slot_traffic;         /**< ESB was active in the current timeslot. */
+static uint32_t                                 m_slot_end_us;          /**< End of the current timeslot relative to its start, including extensions. */
+static uint8_t                                  m_extend_count;
+
+static uint32_t                                 m_slot_length_us;       /**< Length of the next timeslot request. */
+
+static nrf_radio_request_t                      m_request;
+static nrf_radio_signal_callback_return_param_t m_signal_ret;
+
+
+/**@brief Function for checking that the ESB event interrupt priority is available to the
+ *        application. nrf_esb only applies the two lowest bits of the priority.
+ */
+static bool event_irq_priority_is_valid(uint8_t priority)
+{
+    if (priority > 0x03)
+    {
+        return false;
+    }
+
+    return (priority == APP_IRQ_PRIORITY_HIGH) || (priority == APP_IRQ_PRIORITY_MID) ||
+           (priority == APP_IRQ_PRIORITY_LOW)  || (priority == APP_IRQ_PRIORITY_LOWEST);
+}
+
+
+static void request_earliest(void)
+{
+    m_request.request_type                  = NRF_RADIO_REQ_TYPE_EARLIEST;
+    m_request.params.earliest.hfclk         = NRF_RADIO_HFCLK_CFG_XTAL_GUARANTEED;
+    m_request.params.earliest.priority      = NRF_RADIO_PRIORITY_NORMAL;
+    m_request.params.earliest.length_us     = m_slot_length_us;
+    m_request.params.earliest.timeout_us    = NRF_RADIO_EARLIEST_TIMEOUT_MAX_US;
+
+    (void)sd_radio_request(&m_request);
+}
+
+
+/**@brief Function for adapting the length of the next timeslot to the traffic in the last one.
+ *
+ * @param[in] pending   ESB traffic was still pending when the timeslot ended.
+ */
+static void slot_length_update(bool pending)
+{
+    if (pending || m_extend_count > 0)
+    {
+        m_slot_length_us = MIN(m_slot_length_us * 2, m_config.slot_length_max_us);
+    }
+    else if (!m_slot_traffic)
+    {
+        m_slot_length_us = MAX(m_slot_length_us / 2, m_config.slot_length_min_us);
+    }
+}
+
+
+static void slot_end(void)
+{
+    SLOT_TIMER->INTENCLR = TIMER_INTENCLR_COMPARE0_Msk;
+
+    m_in_slot = false;
+    m_stats.radio_time_us += m_slot_end_us;
+
+    if (m_uninit_pending)
+    {
+        m_signal_ret.callback_action = NRF_RADIO_SIGNAL_CALLBACK_ACTION_END;
+        return;
+    }
+
+    m_request.request_type                  = NRF_RADIO_REQ_TYPE_NORMAL;
+    m_request.params.normal.hfclk           = NRF_RADIO_HFCLK_CFG_XTAL_GUARANTEED;
+    m_request.params.normal.priority        = NRF_RADIO_PRIORITY_NORMAL;
+    m_request.params.normal.distance_us     = m_config.slot_distance_us;
+    m_request.params.normal.length_us       = m_slot_length_us;
+
+    m_signal_ret.callback_action            = NRF_RADIO_SIGNAL_CALLBACK_ACTION_REQUEST_AND_END;
+    m_signal_ret.params.request.p_next      = &m_request;
+}
+
+
+/**@brief Function for starting the next PTX transaction if there is time left in the timeslot.
+ *
+ * @details Payloads are sent one at a time (manual TX mode), so that no transaction is started
+ *          inside the end margin.
+ */
+static void tx_kick(void)
+{
+    if (m_esb_config.mode != NRF_ESB_MODE_PTX || m_closing)
+    {
+        return;
+    }
+
+    if (nrf_esb_is_idle() && nrf_esb_tx_fifo_count_get() > 0)
+    {
+        if (nrf_esb_start_tx() == NRF_SUCCESS)
+        {
+            m_slot_traffic = true;
+        }
+    }
+}
+
+
+static void slot_close(bool pending)
+{
+    m_closing = true;
+    slot_length_update(pending);
+
+    if (m_esb_config.mode == NRF_ESB_MODE_PRX)
+    {
+        (void)nrf_esb_stop_rx();
+    }
+
+    // An ongoing PTX transaction completes within the end margin; the timeslot is then ended
+    // from the RADIO signal.
+    if (nrf_esb_is_idle())
+    {
+        slot_end();
+    }
+}
+
+
+static void esb_first_init(void)
+{
+    uint32_t err_code;
+
+    err_code = nrf_esb_init(&m_esb_config);
+    if (err_code != NRF_SUCCESS)
+    {
+        return;
+    }
+
+    (void)nrf_esb_set_address_length(m_address.addr_length);
+    (void)nrf_esb_set_base_address_0(m_address.base_addr_p0);
+    (void)nrf_esb_set_base_address_1(m_address.base_addr_p1);
+    (void)nrf_esb_set_prefixes(m_address.pipe_prefixes, m_address.num_pipes);
+    (void)nrf_esb_enable_pipes(m_address.rx_pipes_enabled);
+    (void)nrf_esb_set_rf_channel(m_address.rf_channel);
+
+    m_esb_ready = true;
+}
+
+
+static void slot_start(void)
+{
+    bool radio_ready;
+
+    m_in_slot       = true;
+    m_closing       = false;
+    m_slot_traffic  = false;
+    m_extend_count  = 0;
+    m_slot_end_us   = m_slot_length_us;
+    m_stats.slots++;
+
+    SLOT_TIMER->EVENTS_COMPARE[SLOT_TIMER_CC_MARGIN] = 0;
+    SLOT_TIMER->CC[SLOT_TIMER_CC_MARGIN]             = m_slot_end_us - m_config.end_margin_us;
+    SLOT_TIMER->INTENSET                             = TIMER_INTENSET_COMPARE0_Msk;
+    NVIC_EnableIRQ(TIMER0_IRQn);
+
+    if (!m_esb_ready)
+    {
+        esb_first_init();
+        radio_ready = m_esb_ready;
+    }
+    else
+    {
+        // The SoftDevice leaves the radio in an unknown state; do not run ESB on it unless the
+        // whole configuration was written back.
+        radio_ready = (nrf_esb_radio_restore() == NRF_SUCCESS);
+    }
+
+    if (!radio_ready || m_uninit_pending)
+    {
+        m_closing = true;
+        slot_end();
+        return;
+    }
+
+    if (m_esb_config.mode == NRF_ESB_MODE_PRX)
+    {
+        (void)nrf_esb_start_rx();
+        m_slot_traffic = (nrf_esb_tx_fifo_count_get() > 0);
+    }
+    else
+    {
+        tx_kick();
+    }
+}
+
+
+static void on_margin_reached(void)
+{
+    bool pending;
+
+    SLOT_TIMER->EVENTS_COMPARE[SLOT_TIMER_CC_MARGIN] = 0;
+
+    if (m_closing)
+    {
+        return;
+    }
+
+    if (m_esb_config.mode == NRF_ESB_MODE_PTX)
+    {
+        pending = !nrf_esb_is_idle() || (nrf_esb_tx_fifo_count_get() > 0);
+    }
+    else
+    {
+        pending = m_slot_traffic;
+    }
+
+    if (pending && m_extend_count < m_config.extend_count_max && !m_uninit_pending)
+    {
+        m_signal_ret.callback_action         = NRF_RADIO_SIGNAL_CALLBACK_ACTION_EXTEND;
+        m_signal_ret.params.extend.length_us = m_config.extend_length_us;
+        return;
+    }
+
+    slot_close(pending);
+}
+
+
+static nrf_radio_signal_callback_return_param_t * radio_signal_callback(uint8_t signal_type)
+{
+    m_signal_ret.callback_action = NRF_RADIO_SIGNAL_CALLBACK_ACTION_NONE;
+
+    switch (signal_type)
+    {
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_START:
+            slot_start();
+            break;
+
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_RADIO:
+            nrf_esb_radio_irq_handler();
+            if (!m_in_slot)
+            {
+                break;
+            }
+            if (!m_closing)
+            {
+                tx_kick();
+            }
+            else if (nrf_esb_is_idle())
+            {
+                slot_end();
+            }
+            break;
+
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_TIMER0:
+            on_margin_reached();
+            break;
+
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_EXTEND_SUCCEEDED:
+            m_extend_count++;
+            m_stats.extensions++;
+            m_slot_end_us += m_config.extend_length_us;
+            SLOT_TIMER->CC[SLOT_TIMER_CC_MARGIN] = m_slot_end_us - m_config.end_margin_us;
+            break;
+
+        case NRF_RADIO_CALLBACK_SIGNAL_TYPE_EXTEND_FAILED:
+            m_stats.extensions_failed++;
+            slot_close(true);
+            break;
+
+        default:
+            break;
+    }
+
+    return &m_signal_ret;
+}
+
+
+static void esb_event_handler(nrf_esb_evt_t const * p_event)
+{
+    switch (p_event->evt_id)
+    {
+        case NRF_ESB_EVENT_TX_SUCCESS:
+            m_stats.tx_success++;
+            break;
+
+        case NRF_ESB_EVENT_TX_FAILED:
+            m_stats.tx_failed++;
+            break;
+
+        case NRF_ESB_EVENT_RX_RECEIVED:
+            m_stats.rx_received++;
+            m_slot_traffic = true;
+            break;
+    }
+
+    if (m_app_event_handler != NULL)
+    {
+        m_app_event_handler(p_event);
+    }
+}
+
+
+uint32_t nrf_esb_timeslot_init(nrf_esb_config_t const          * p_esb_config,
+                               nrf_esb_timeslot_config_t const * p_config)
+{
+    uint32_t err_code;
+
+    VERIFY_PARAM_NOT_NULL(p_esb_config);
+    VERIFY_PARAM_NOT_NULL(p_config);
+    VERIFY_FALSE(m_session_open, NRF_ERROR_INVALID_STATE);
+
+    VERIFY_TRUE(event_irq_priority_is_valid(p_esb_config->event_irq_priority), NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_config->slot_length_min_us >= NRF_RADIO_LENGTH_MIN_US, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_config->slot_length_max_us <= NRF_RADIO_LENGTH_MAX_US, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_config->slot_length_min_us <= p_config->slot_length_max_us, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_config->slot_length_max_us < p_config->slot_distance_us, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_config->end_margin_us < p_config->slot_length_min_us, NRF_ERROR_INVALID_PARAM);
+    VERIFY_TRUE(p_config->extend_count_max == 0 ||
+                p_config->extend_length_us >= NRF_RADIO_MINIMUM_TIMESLOT_LENGTH_EXTENSION_TIME_US,
+                NRF_ERROR_INVALID_PARAM);
+
+    m_esb_config                    = *p_esb_config;
+    m_app_event_handler             = p_esb_config->event_handler;
+    m_esb_config.event_handler      = esb_event_handler;
+    m_esb_config.tx_mode            = NRF_ESB_TXMODE_MANUAL;
+    m_esb_config.radio_irq_priority = 0;
+
+    m_config = *p_config;
+    if (p_config->p_address != NULL)
+    {
+        m_address = *p_config->p_address;
+    }
+
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_slot_length_us = m_config.slot_length_min_us;
+    m_uninit_pending = false;
+
+    err_code = sd_radio_session_open(radio_signal_callback);
+    VERIFY_SUCCESS(err_code);
+
+    m_session_open = true;
+    request_earliest();
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_timeslot_uninit(void)
+{
+    VERIFY_TRUE(m_session_open, NRF_ERROR_INVALID_STATE);
+
+    m_uninit_pending = true;
+
+    if (!m_in_slot)
+    {
+        return sd_radio_session_close();
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+uint32_t nrf_esb_timeslot_write_payload(nrf_esb_payload_t const * p_payload)
+{
+    uint32_t err_code;
+
+    VERIFY_TRUE(m_esb_ready, NRF_ERROR_INVALID_STATE);
+
+    err_code = nrf_esb_write_payload(p_payload);
+    VERIFY_SUCCESS(err_code);
+
+    // Let the signal handler start the transaction, so that it cannot race with the end of the
+    // timeslot. The RADIO interrupt is only forwarded to this module inside a timeslot. The
+    // signal handler runs at priority 0, above any application critical region, so interrupts
+    // are disabled for the few instructions between checking the timeslot and pending the
+    // interrupt. This keeps the timeslot from ending in between.
+    if (m_esb_config.mode == NRF_ESB_MODE_PTX)
+    {
+        uint32_t primask = __get_PRIMASK();
+
+        __disable_irq();
+        if (m_in_slot && !m_closing)
+        {
+            NVIC_SetPendingIRQ(RADIO_IRQn);
+        }
+        if (primask == 0)
+        {
+            __enable_irq();
+        }
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+void nrf_esb_timeslot_on_sys_evt(uint32_t sys_evt)
+{
+    if (!m_session_open)
+    {
+        return;
+    }
+
+    switch (sys_evt)
+    {
+        case NRF_EVT_RADIO_BLOCKED:
+            m_stats.blocked++;
+            if (!m_uninit_pending)
+            {
+                request_earliest();
+            }
+            break;
+
+        case NRF_EVT_RADIO_CANCELED:
+            m_stats.canceled++;
+            if (!m_uninit_pending)
+            {
+                request_earliest();
+            }
+            break;
+
+        case NRF_EVT_RADIO_SIGNAL_CALLBACK_INVALID_RETURN:
+            m_in_slot = false;
+            if (!m_uninit_pending)
+            {
+                request_earliest();
+            }
+            break;
+
+        case NRF_EVT_RADIO_SESSION_IDLE:
+            if (m_uninit_pending)
+            {
+                (void)sd_radio_session_close();
+            }
+            break;
+
+        case NRF_EVT_RADIO_SESSION_CLOSED:
+            m_session_open   = false;
+            m_uninit_pending = false;
+            m_in_slot        = false;
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+void nrf_esb_timeslot_stats_get(nrf_esb_timeslot_stats_t * p_stats)
+{
+    *p_stats = m_stats;
+}
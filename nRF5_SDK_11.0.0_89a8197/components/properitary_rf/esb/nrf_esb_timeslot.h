@@ -0,0 +1,152 @@
+/* Copyright (c) 2016 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef NRF_ESB_TIMESLOT_H__
+#define NRF_ESB_TIMESLOT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf_esb.h"
+
+/** @defgroup nrf_esb_timeslot Enhanced ShockBurst in radio timeslots
+ * @{
+ * @ingroup nrf_esb
+ *
+ * @brief Runs Enhanced ShockBurst concurrently with a BLE SoftDevice.
+ *
+ * @details The module opens a SoftDevice radio timeslot session and only lets ESB use the
+ *          RADIO inside granted timeslots. At the start of every timeslot the ESB radio
+ *          configuration is restored, and the RADIO interrupts forwarded by the SoftDevice are
+ *          passed to @ref nrf_esb_radio_irq_handler. Close to the end of a timeslot, the module
+ *          extends the timeslot if ESB traffic is pending, or ends it and requests the next one.
+ *
+ *          The timeslot length adapts to the traffic: it grows towards
+ *          @ref nrf_esb_timeslot_config_t::slot_length_max_us when timeslots are used up or
+ *          extended, and shrinks towards @ref nrf_esb_timeslot_config_t::slot_length_min_us when
+ *          they are idle. This keeps the radio time taken from BLE proportional to the ESB load.
+ *
+ *          In PTX mode, payloads are sent one at a time and the next transaction is only
+ *          started if it can complete before the end of the timeslot. Payloads that do not fit
+ *          stay in the TX FIFO until the next timeslot. In PRX mode the radio listens for the
+ *          whole timeslot.
+ *
+ * @note    ESB is initialized in the first timeslot, because the RADIO cannot be accessed
+ *          outside a timeslot. Use @ref nrf_esb_timeslot_write_payload for queueing payloads;
+ *          it returns NRF_ERROR_INVALID_STATE until the first timeslot has started.
+ *
+ * @note    Gazell is distributed as a precompiled library that owns the RADIO and its timers,
+ *          and cannot be run inside radio timeslots.
+ *
+ * @note    The application must forward SoftDevice SoC events to @ref nrf_esb_timeslot_on_sys_evt.
+ */
+
+/**@brief Timeslot arbiter configuration. */
+typedef struct
+{
+    uint32_t                    slot_length_min_us;     /**< Shortest timeslot requested, in microseconds. Also used for the first timeslot. */
+    uint32_t                    slot_length_max_us;     /**< Longest timeslot requested, in microseconds. */
+    uint32_t                    slot_distance_us;       /**< Distance between the start of two consecutive timeslots, in microseconds. */
+    uint32_t                    extend_length_us;       /**< Length of each timeslot extension, in microseconds. */
+    uint8_t                     extend_count_max;       /**< Maximum number of extensions per timeslot. */
+    uint32_t                    end_margin_us;          /**< Time reserved at the end of a timeslot for completing an ongoing ESB transaction, in microseconds. Must cover the worst-case transaction including retransmits. */
+    nrf_esb_address_t const   * p_address;              /**< ESB address configuration applied in the first timeslot. NULL to use @ref NRF_ESB_ADDR_DEFAULT. */
+} nrf_esb_timeslot_config_t;
+
+
+/**@brief Default timeslot arbiter configuration. */
+#define NRF_ESB_TIMESLOT_DEFAULT_CONFIG {.slot_length_min_us    = 2000,     \
+                                         .slot_length_max_us    = 10000,    \
+                                         .slot_distance_us      = 20000,    \
+                                         .extend_length_us      = 2000,     \
+                                         .extend_count_max      = 4,        \
+                                         .end_margin_us         = 1500,     \
+                                         .p_address             = NULL      \
+}
+
+
+/**@brief Timeslot arbiter statistics. */
+typedef struct
+{
+    uint32_t slots;                 /**< Number of timeslots granted. */
+    uint32_t radio_time_us;         /**< Total radio time granted to ESB, in microseconds, including extensions. */
+    uint32_t extensions;            /**< Number of successful timeslot extensions. */
+    uint32_t extensions_failed;     /**< Number of failed timeslot extensions. */
+    uint32_t blocked;               /**< Number of timeslot requests blocked by the SoftDevice. */
+    uint32_t canceled;              /**< Number of timeslots canceled by the SoftDevice. */
+    uint32_t tx_success;            /**< Number of ESB payloads sent successfully. */
+    uint32_t tx_failed;             /**< Number of ESB payloads that failed. */
+    uint32_t rx_received;           /**< Number of ESB receive events. */
+} nrf_esb_timeslot_stats_t;
+
+
+/**@brief Function for initializing the module and opening the radio timeslot session.
+ *
+ * @details The ESB configuration is copied and used for initializing ESB in the first timeslot.
+ *          The transmission mode is forced to @ref NRF_ESB_TXMODE_MANUAL and the RADIO interrupt
+ *          priority to 0, as required by the timeslot API. The event handler of @p p_esb_config
+ *          is called for every ESB event. The event interrupt priority must be one of the
+ *          application priorities (1 or 3 on nRF51, 2 or 3 on nRF52); @ref NRF_ESB_DEFAULT_CONFIG
+ *          uses 2, which the SoftDevice reserves on nRF51.
+ *
+ * @param[in]  p_esb_config     ESB configuration.
+ * @param[in]  p_config         Timeslot arbiter configuration.
+ *
+ * @retval  NRF_SUCCESS                 Session opened and first timeslot requested.
+ * @retval  NRF_ERROR_NULL              A parameter was NULL.
+ * @retval  NRF_ERROR_INVALID_PARAM     Invalid timeslot lengths, or event interrupt priority
+ *                                      reserved by the SoftDevice.
+ * @retval  NRF_ERROR_INVALID_STATE     Session already open.
+ * @return  Other errors from the SoftDevice radio timeslot API.
+ */
+uint32_t nrf_esb_timeslot_init(nrf_esb_config_t const          * p_esb_config,
+                               nrf_esb_timeslot_config_t const * p_config);
+
+
+/**@brief Function for closing the radio timeslot session.
+ *
+ * @details ESB stops using the RADIO at the end of the current timeslot. Queued payloads are kept.
+ *
+ * @retval  NRF_SUCCESS                 Session close requested.
+ * @retval  NRF_ERROR_INVALID_STATE     Session not open.
+ */
+uint32_t nrf_esb_timeslot_uninit(void);
+
+
+/**@brief Function for queueing a TX payload, or an ack payload in PRX mode.
+ *
+ * @details When called inside a timeslot in PTX mode while ESB is idle, the transmission is
+ *          started immediately. Otherwise it is sent in the next timeslot.
+ *
+ * @param[in]  p_payload        Payload to queue.
+ *
+ * @retval  NRF_ERROR_INVALID_STATE     ESB has not been initialized by the first timeslot yet.
+ * @return  Other return values from @ref nrf_esb_write_payload.
+ */
+uint32_t nrf_esb_timeslot_write_payload(nrf_esb_payload_t const * p_payload);
+
+
+/**@brief Function for handling SoftDevice SoC events.
+ *
+ * @param[in]  sys_evt          SoC event (see @ref NRF_SOC_EVTS).
+ */
+void nrf_esb_timeslot_on_sys_evt(uint32_t sys_evt);
+
+
+/**@brief Function for reading the arbiter statistics.
+ *
+ * @param[out] p_stats          Statistics.
+ */
+void nrf_esb_timeslot_stats_get(nrf_esb_timeslot_stats_t * p_stats);
+
+/** @} */
+
+#endif // NRF_ESB_TIMESLOT_H__
@@ -24,6 +24,9 @@
 #include "nrf_gzp.h"
 #include "nrf_gzll.h"
 #include "nrf_ecb.h"
+#ifdef APP_DRBG_ENABLED
+#include "app_drbg.h"
+#endif
 #include <string.h>
 
 
@@ -273,6 +276,14 @@ void gzp_random_numbers_generate(uint8_t * dst, uint8_t n)
 {
     uint8_t i;
 
+#ifdef APP_DRBG_ENABLED
+    // Use the CSPRNG if it is initialized, otherwise fall back to reading the RNG directly.
+    if (app_drbg_rand(dst, n) == NRF_SUCCESS)
+    {
+        return;
+    }
+#endif
+
     NRF_RNG->EVENTS_VALRDY=0;
     NRF_RNG->TASKS_START = 1;
     for(i = 0; i < n; i++) 
@@ -64,6 +64,13 @@
 /** Max transfer unit for SPI MASTER and SPI SLAVE. */
 #define SER_PHY_SPI_MTU_SIZE            255
 
+/** Full-duplex mode of the SPI 5W PHY. Must be the same on both sides. When set to 1, one header
+ *  exchange carries the packet lengths of both directions, and the payload frames that follow
+ *  carry the packets of both directions at the same time. */
+#ifndef SER_PHY_SPI_5W_DUPLEX
+#define SER_PHY_SPI_5W_DUPLEX           0
+#endif
+
 /** UART transmission parameters */
 #define SER_PHY_UART_FLOW_CTRL          APP_UART_FLOW_CONTROL_ENABLED
 #define SER_PHY_UART_PARITY             true
@@ -79,6 +79,9 @@ _static uint8_t * mp_rx_buffer = NULL;
 _static uint16_t  m_rx_buf_len = 0;
 _static uint8_t   m_recv_buffer[SER_PHY_SPI_5W_MTU_SIZE];
 _static uint8_t   m_len_buffer[SER_PHY_HEADER_SIZE + 1] = { 0 }; //len is asymmetric for 5W, there is a 1 byte guard when receiving
+#if SER_PHY_SPI_5W_DUPLEX
+_static uint8_t   m_header_tx_buffer[SER_PHY_HEADER_SIZE + 1] = { 0 }; //padded to the length of the received header
+#endif
 
 _static uint16_t m_tx_packet_length             = 0;
 _static uint16_t m_accumulated_tx_packet_length = 0;
@@ -302,6 +305,175 @@ static __INLINE uint32_t frame_get()
     return err_code;
 }
 
+#if SER_PHY_SPI_5W_DUPLEX
+/* Exchanges the headers. The length of the pending TX packet is sent, the length of the packet
+ * pending in the slave is received behind the guard byte. */
+static uint32_t duplex_header_exchange(void)
+{
+    m_tx_packet_length = (mp_tx_buffer != NULL) ? m_tx_buf_len : 0;
+    (void)uint16_encode(m_tx_packet_length, m_header_tx_buffer);
+
+    return spi_master_send_recv(SER_PHY_SPI_MASTER,
+                                m_header_tx_buffer,
+                                SER_PHY_HEADER_SIZE + 1,
+                                m_len_buffer,
+                                SER_PHY_HEADER_SIZE + 1);
+}
+
+/* Exchanges the next payload frame, carrying the next fragments of both packets. */
+static uint32_t duplex_frame_exchange(void)
+{
+    m_current_tx_packet_length = compute_current_packet_length(m_tx_packet_length,
+                                                               m_accumulated_tx_packet_length);
+    m_current_rx_packet_length = compute_current_packet_length(m_rx_packet_length,
+                                                               m_accumulated_rx_packet_length);
+
+    if (m_current_rx_packet_length == SER_PHY_SPI_5W_MTU_SIZE)
+    {
+        m_current_rx_packet_length--; //guard byte takes one byte of the frame when receiving
+    }
+
+    return spi_master_send_recv(SER_PHY_SPI_MASTER,
+                                (m_current_tx_packet_length != 0) ?
+                                &mp_tx_buffer[m_accumulated_tx_packet_length] : NULL,
+                                m_current_tx_packet_length,
+                                (m_current_rx_packet_length != 0) ? m_recv_buffer : NULL,
+                                (m_current_rx_packet_length != 0) ?
+                                m_current_rx_packet_length + 1 : 0);
+}
+
+/* Starts the next exchange if either side has a packet pending. */
+static uint32_t duplex_next(void)
+{
+    uint32_t err_code = NRF_SUCCESS;
+
+    if ((mp_tx_buffer != NULL) || m_slave_request_flag)
+    {
+        m_spi_master_state = SER_PHY_STATE_TX_HEADER;
+        err_code           = duplex_header_exchange();
+    }
+    else
+    {
+        m_spi_master_state = SER_PHY_STATE_IDLE;
+    }
+    return err_code;
+}
+
+/**
+ * \brief Master driver main state machine, full-duplex mode
+ * Executed only in the context of PendSV_Handler()
+ * Every exchange starts with a header exchange carrying the packet lengths of both sides,
+ * followed by payload frames that carry both packets until they are complete.
+*/
+static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
+{
+    uint32_t err_code = NRF_SUCCESS;
+
+    switch (m_spi_master_state)
+    {
+        case SER_PHY_STATE_IDLE:
+
+            if ((evt_src == SER_PHY_EVT_GPIO_REQ) || (evt_src == SER_PHY_EVT_TX_API_CALL))
+            {
+                err_code = duplex_next();
+            }
+            break;
+
+        case SER_PHY_STATE_TX_HEADER:
+
+            if (evt_src == SER_PHY_EVT_SPI_TRANSFER_DONE)
+            {
+                m_rx_packet_length             = uint16_decode(&(m_len_buffer[1])); //skip guard when receiving
+                m_accumulated_tx_packet_length = 0;
+                m_accumulated_rx_packet_length = 0;
+
+                if (m_rx_packet_length != 0)
+                {
+                    m_spi_master_state = SER_PHY_STATE_MEMORY_REQUEST;
+                    m_rx_buf_len       = m_rx_packet_length;
+                    callback_mem_request();
+                }
+                else if (m_tx_packet_length != 0)
+                {
+                    m_spi_master_state = SER_PHY_STATE_TX_PAYLOAD;
+                    err_code           = duplex_frame_exchange();
+                }
+                else
+                {
+                    //the slave request was withdrawn or already served
+                    err_code = duplex_next();
+                }
+            }
+            break;
+
+        case SER_PHY_STATE_MEMORY_REQUEST:
+
+            if (evt_src == SER_PHY_EVT_RX_API_CALL)
+            {
+                m_spi_master_state = SER_PHY_STATE_TX_PAYLOAD;
+                err_code           = duplex_frame_exchange();
+            }
+            break;
+
+        case SER_PHY_STATE_TX_PAYLOAD:
+
+            if (evt_src == SER_PHY_EVT_SPI_TRANSFER_DONE)
+            {
+                if (m_current_rx_packet_length != 0)
+                {
+                    if (mp_rx_buffer)
+                    {
+                        copy_buff(&(mp_rx_buffer[m_accumulated_rx_packet_length]),
+                                  &(m_recv_buffer[1]),
+                                  m_current_rx_packet_length); //skip guard byte when receiving
+                    }
+                    m_accumulated_rx_packet_length += m_current_rx_packet_length;
+                }
+                m_accumulated_tx_packet_length += m_current_tx_packet_length;
+
+                if ((m_accumulated_tx_packet_length < m_tx_packet_length) ||
+                    (m_accumulated_rx_packet_length < m_rx_packet_length))
+                {
+                    err_code = duplex_frame_exchange();
+                }
+                else
+                {
+                    if (m_tx_packet_length != 0)
+                    {
+                        //Release TX buffer
+                        buffer_release(&mp_tx_buffer, &m_tx_buf_len);
+                        callback_packet_sent();
+                    }
+
+                    if (m_rx_packet_length != 0)
+                    {
+                        if (mp_rx_buffer == NULL)
+                        {
+                            callback_packet_dropped();
+                        }
+                        else
+                        {
+                            callback_packet_received();
+                        }
+                        //Release RX buffer
+                        buffer_release(&mp_rx_buffer, &m_rx_buf_len);
+                    }
+
+                    err_code = duplex_next();
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (err_code != NRF_SUCCESS)
+    {
+        (void)err_code;
+    }
+}
+#else
 /**
  * \brief Master driver main state machine
  * Executed only in the context of PendSV_Handler()
@@ -587,6 +759,7 @@ static void ser_phy_switch_state(ser_phy_event_source_t evt_src)
         (void)err_code;
     }
 }
+#endif
 
 /* SPI master event handler */
 static void ser_phy_spi_master_event_handler(spi_master_evt_t spi_master_evt)
@@ -80,6 +80,10 @@ _static uint16_t m_accumulated_tx_packet_length;
 _static uint16_t m_tx_packet_length;
 _static uint16_t m_current_tx_frame_length;
 
+#if SER_PHY_SPI_5W_DUPLEX
+_static uint16_t m_tx_announced_length; //TX packet length sent in the armed header, 0 if none
+#endif
+
 _static uint8_t m_header_rx_buffer[SER_PHY_HEADER_SIZE + 1]; //+1 for '0' guard in SPI_5W
 _static uint8_t m_header_tx_buffer[SER_PHY_HEADER_SIZE + 1]; //+1 for '0' guard in SPI_5W
 
@@ -175,6 +179,80 @@ static uint16_t compute_current_frame_length(const uint16_t packet_length,
     return current_packet_length;
 }
 
+#if SER_PHY_SPI_5W_DUPLEX
+/* Arms the header exchange. The master sends the length of its packet, the slave sends a guard
+ * byte followed by the length of its pending packet. */
+static uint32_t header_exchange_set(void)
+{
+    uint32_t err_code;
+
+    m_tx_announced_length = (m_p_tx_buffer != NULL) ? m_tx_packet_length : 0;
+
+    m_header_tx_buffer[0] = (uint8_t) 0; //this is guard byte
+    (void)uint16_encode(m_tx_announced_length, &(m_header_tx_buffer[1]));
+    err_code = nrf_drv_spis_buffers_set(&m_spis,
+                                        m_header_tx_buffer,
+                                        SER_PHY_HEADER_SIZE + 1,
+                                        m_header_rx_buffer,
+                                        SER_PHY_HEADER_SIZE + 1);
+    return err_code;
+}
+
+/* Arms the next payload frame. The frame carries the next fragments of both packets: up to MTU
+ * bytes from the master and, behind the guard byte, up to MTU - 1 bytes from the slave. */
+static uint32_t frame_exchange_set(void)
+{
+    uint32_t        err_code;
+    uint16_t        frame_length;
+    uint8_t const * p_tx;
+    uint16_t        tx_length;
+    uint8_t       * p_rx;
+    uint16_t        rx_length;
+
+    m_current_rx_frame_length = compute_current_frame_length(m_rx_packet_length,
+                                                             m_accumulated_rx_packet_length);
+    m_current_tx_frame_length = compute_current_frame_length(m_tx_announced_length,
+                                                             m_accumulated_tx_packet_length);
+
+    if (m_current_tx_frame_length == SER_PHY_SPI_5W_MTU_SIZE)
+    {
+        m_current_tx_frame_length -= 1; //extra space for guard byte must be taken into account for MTU
+    }
+
+    frame_length = m_current_rx_frame_length;
+
+    if (m_current_tx_frame_length != 0)
+    {
+        frame_length = MAX(frame_length, m_current_tx_frame_length + 1);
+
+        m_tx_frame_buffer[0] = 0; //guard byte
+        copy_buff(&(m_tx_frame_buffer[1]),
+                  &(m_p_tx_buffer[m_accumulated_tx_packet_length]),
+                  m_current_tx_frame_length);
+        p_tx      = m_tx_frame_buffer;
+        tx_length = m_current_tx_frame_length + 1;
+    }
+    else
+    {
+        p_tx      = m_zero_buff;
+        tx_length = frame_length;
+    }
+
+    if ((m_current_rx_frame_length != 0) && !m_trash_payload_flag)
+    {
+        p_rx      = &(m_p_rx_buffer[m_accumulated_rx_packet_length]);
+        rx_length = m_current_rx_frame_length;
+    }
+    else
+    {
+        p_rx      = m_rx_frame_buffer;
+        rx_length = (m_current_rx_frame_length != 0) ? m_current_rx_frame_length : frame_length;
+    }
+
+    err_code = nrf_drv_spis_buffers_set(&m_spis, p_tx, tx_length, p_rx, rx_length);
+    return err_code;
+}
+#else
 static uint32_t header_get()
 {
     uint32_t err_code;
@@ -251,6 +329,7 @@ static uint32_t frame_send()
 
     return err_code;
 }
+#endif
 
 static void set_ready_line(void)
 {
@@ -278,6 +357,130 @@ static void clear_request_line(void)
     return;
 }
 
+#if SER_PHY_SPI_5W_DUPLEX
+/**
+ * \brief Slave driver main state machine, full-duplex mode
+ * The master starts every exchange with a header exchange carrying the packet lengths of both
+ * sides, followed by payload frames that carry both packets until they are complete.
+*/
+static void spi_slave_event_handle(nrf_drv_spis_event_t event)
+{
+    uint32_t err_code = NRF_SUCCESS;
+
+    switch (m_trans_state)
+    {
+        case SPI_RAW_STATE_SETUP_HEADER:
+            m_trans_state = SPI_RAW_STATE_RX_HEADER;
+            err_code      = header_exchange_set();
+            break;
+
+        case SPI_RAW_STATE_RX_HEADER:
+
+            if (event.evt_type == NRF_DRV_SPIS_BUFFERS_SET_DONE)
+            {
+                DEBUG_EVT_SPI_SLAVE_RAW_BUFFERS_SET(0);
+                set_ready_line();
+            }
+
+            if (event.evt_type == NRF_DRV_SPIS_XFER_DONE)
+            {
+                DEBUG_EVT_SPI_SLAVE_RAW_RX_XFER_DONE(event.rx_amount);
+                spi_slave_raw_assert(event.rx_amount == SER_PHY_HEADER_SIZE + 1);
+                m_rx_packet_length             = uint16_decode(m_header_rx_buffer);
+                m_accumulated_rx_packet_length = 0;
+                m_accumulated_tx_packet_length = 0;
+
+                if (m_tx_announced_length != 0)
+                {
+                    //the master has got the length, the packet goes with the payload frames
+                    clear_request_line();
+                }
+
+                if (m_rx_packet_length != 0)
+                {
+                    m_trans_state          = SPI_RAW_STATE_MEM_REQUESTED;
+                    m_buffer_reqested_flag = true;
+                    callback_memory_request(m_rx_packet_length);
+                }
+                else if (m_tx_announced_length != 0)
+                {
+                    m_trash_payload_flag = false;
+                    m_trans_state        = SPI_RAW_STATE_RX_PAYLOAD;
+                    err_code             = frame_exchange_set();
+                }
+                else
+                {
+                    //nothing in either direction - announce a packet queued since the last header
+                    err_code = header_exchange_set();
+                }
+            }
+            break;
+
+        case SPI_RAW_STATE_MEM_REQUESTED:
+
+            if (event.evt_type == NRF_DRV_SPIS_EVT_TYPE_MAX) //This is API dummy event
+            {
+                m_buffer_reqested_flag = false;
+                m_trans_state          = SPI_RAW_STATE_RX_PAYLOAD;
+                err_code               = frame_exchange_set();
+            }
+            break;
+
+        case SPI_RAW_STATE_RX_PAYLOAD:
+
+            if (event.evt_type == NRF_DRV_SPIS_BUFFERS_SET_DONE)
+            {
+                DEBUG_EVT_SPI_SLAVE_RAW_BUFFERS_SET(0);
+                set_ready_line();
+            }
+
+            if (event.evt_type == NRF_DRV_SPIS_XFER_DONE)
+            {
+                DEBUG_EVT_SPI_SLAVE_RAW_RX_XFER_DONE(event.rx_amount);
+                m_accumulated_rx_packet_length += m_current_rx_frame_length;
+                m_accumulated_tx_packet_length += m_current_tx_frame_length;
+
+                if ((m_accumulated_rx_packet_length < m_rx_packet_length) ||
+                    (m_accumulated_tx_packet_length < m_tx_announced_length))
+                {
+                    err_code = frame_exchange_set();
+                }
+                else
+                {
+                    m_trans_state = SPI_RAW_STATE_RX_HEADER;
+
+                    if (m_rx_packet_length != 0)
+                    {
+                        if (!m_trash_payload_flag)
+                        {
+                            callback_packet_received(m_p_rx_buffer, m_accumulated_rx_packet_length);
+                        }
+                        else
+                        {
+                            callback_packet_dropped();
+                        }
+                    }
+
+                    if (m_tx_announced_length != 0)
+                    {
+                        //clear pointer before callback
+                        m_p_tx_buffer = NULL;
+                        callback_packet_transmitted();
+                    }
+
+                    //arm after the callbacks, so that a packet queued by them is announced
+                    err_code = header_exchange_set();
+                }
+            }
+            break;
+
+        default:
+            err_code = NRF_ERROR_INVALID_STATE;
+            break;
+    }
+    APP_ERROR_CHECK(err_code);
+}
+#else
 /**
  * \brief Slave driver main state machine
  * For UML graph, please refer to SDK documentation
@@ -437,6 +640,7 @@ static void spi_slave_event_handle(nrf_drv_spis_event_t event)
     }
     APP_ERROR_CHECK(err_code);
 }
+#endif
 
 #ifndef _SPI_5W_
 static void spi_slave_gpiote_init(void)
@@ -23,6 +23,9 @@
 #include "nrf_log.h"
 #include "sdk_common.h"
 #include "nrf_drv_config.h"
+#ifdef APP_EVENT_TRACE_ENABLED
+#include "app_event_trace.h"
+#endif
 #if CLOCK_ENABLED
 #include "nrf_drv_clock.h"
 #endif
@@ -180,6 +183,12 @@ void intern_softdevice_events_execute(void)
             else
             {
                 // Call application's BLE stack event handler.
+#ifdef APP_EVENT_TRACE_ENABLED
+                // All event structures start with the connection handle.
+                app_event_trace_record(APP_EVENT_TRACE_TYPE_BLE_EVT,
+                    ((ble_evt_t *)mp_ble_evt_buffer)->header.evt_id |
+                    ((uint32_t)((ble_evt_t *)mp_ble_evt_buffer)->evt.gap_evt.conn_handle << 16));
+#endif
                 m_ble_evt_handler((ble_evt_t *)mp_ble_evt_buffer);
             }
         }
@@ -51,6 +51,113 @@
  */
 #define MAX_ITERATIONS_NEEDED_FOR_NEXT_BYTE 21
 
+#define UART_RX_FIFO_SIZE   8   /**< Size of the UART receive FIFO, must be a power of 2. */
+#define UART_TX_FIFO_SIZE   16  /**< Size of the UART transmit FIFO, must be a power of 2. */
+
+static uint8_t           m_rx_fifo[UART_RX_FIFO_SIZE];  /**< Bytes received on the UART, not yet processed. */
+static volatile uint32_t m_rx_in;                       /**< Number of bytes written to the receive FIFO. */
+static uint32_t          m_rx_out;                      /**< Number of bytes read from the receive FIFO. */
+static uint8_t           m_tx_fifo[UART_TX_FIFO_SIZE];  /**< Bytes to be sent on the UART. */
+static uint32_t          m_tx_in;                       /**< Number of bytes written to the transmit FIFO. */
+static volatile uint32_t m_tx_out;                      /**< Number of bytes read from the transmit FIFO. */
+static volatile bool     m_tx_busy;                     /**< True when the UART is transmitting a byte. */
+
+
+/**@brief Function for handling the UART interrupt.
+ *
+ * @details Received bytes are put in the receive FIFO, and the transmit FIFO is emptied one byte
+ *          per TXDRDY event. Bytes received while the receive FIFO is full are dropped.
+ */
+void UART0_IRQHandler(void)
+{
+    if (NRF_UART0->EVENTS_RXDRDY != 0)
+    {
+        uint8_t rx_byte;
+
+        NRF_UART0->EVENTS_RXDRDY = 0;
+        rx_byte                  = (uint8_t)NRF_UART0->RXD;
+
+        if ((m_rx_in - m_rx_out) < UART_RX_FIFO_SIZE)
+        {
+            m_rx_fifo[m_rx_in & (UART_RX_FIFO_SIZE - 1)] = rx_byte;
+            m_rx_in++;
+        }
+    }
+
+    if (NRF_UART0->EVENTS_TXDRDY != 0)
+    {
+        NRF_UART0->EVENTS_TXDRDY = 0;
+
+        if (m_tx_out != m_tx_in)
+        {
+            NRF_UART0->TXD = m_tx_fifo[m_tx_out & (UART_TX_FIFO_SIZE - 1)];
+            m_tx_out++;
+        }
+        else
+        {
+            m_tx_busy = false;
+        }
+    }
+
+    if (NRF_UART0->EVENTS_ERROR != 0)
+    {
+        NRF_UART0->EVENTS_ERROR = 0;
+        NRF_UART0->ERRORSRC     = NRF_UART0->ERRORSRC;
+    }
+}
+
+
+/**@brief Function for reading a byte from the UART receive FIFO.
+ *
+ * @param[out]  p_byte  Byte read.
+ *
+ * @return      true if a byte was read, false if the FIFO is empty.
+ */
+static bool uart_get(uint8_t * p_byte)
+{
+    if (m_rx_out == m_rx_in)
+    {
+        return false;
+    }
+    *p_byte = m_rx_fifo[m_rx_out & (UART_RX_FIFO_SIZE - 1)];
+    m_rx_out++;
+    return true;
+}
+
+
+/**@brief Function for sending a DTM event on the UART, without waiting for the transmission.
+ *
+ * @details The caller must check that the transmit FIFO has room for the event.
+ *
+ * @param[in]   event   DTM event to send, MSB first.
+ */
+static void uart_event_put(dtm_event_t event)
+{
+    m_tx_fifo[m_tx_in & (UART_TX_FIFO_SIZE - 1)]       = (event >> 8) & 0xFF;
+    m_tx_fifo[(m_tx_in + 1) & (UART_TX_FIFO_SIZE - 1)] = event & 0xFF;
+
+    NVIC_DisableIRQ(UART0_IRQn);
+    m_tx_in += 2;
+
+    if (!m_tx_busy)
+    {
+        // Start the transmission, the rest of the FIFO is sent from the interrupt handler.
+        m_tx_busy      = true;
+        NRF_UART0->TXD = m_tx_fifo[m_tx_out & (UART_TX_FIFO_SIZE - 1)];
+        m_tx_out++;
+    }
+    NVIC_EnableIRQ(UART0_IRQn);
+}
+
+
+/**@brief Function for checking if the UART transmit FIFO has room for one DTM event.
+ */
+static bool uart_event_room(void)
+{
+    return (UART_TX_FIFO_SIZE - (m_tx_in - m_tx_out)) >= 2;
+}
+
+
 /**@brief Function for UART initialization.
  */
 static void uart_init(void)
@@ -70,7 +177,11 @@ static void uart_init(void)
 
     // Activate UART.
     NRF_UART0->ENABLE        = UART_ENABLE_ENABLE_Enabled;
-    NRF_UART0->INTENSET      = 0;
+    NRF_UART0->INTENSET      = UART_INTENSET_RXDRDY_Msk |
+                               UART_INTENSET_TXDRDY_Msk |
+                               UART_INTENSET_ERROR_Msk;
+    NVIC_ClearPendingIRQ(UART0_IRQn);
+    NVIC_EnableIRQ(UART0_IRQn);
     NRF_UART0->TASKS_STARTTX = 1;
     NRF_UART0->TASKS_STARTRX = 1;
 }
@@ -107,6 +218,7 @@ static uint32_t dtm_cmd_put(uint16_t command)
  * @details This function serves as an adaptation layer between a 2-wire UART interface and the
  *          dtmlib. After initialization, DTM commands submitted through the UART are forwarded to
  *          dtmlib and events (i.e. results from the command) is reported back through the UART.
+ *          The UART is interrupt driven, so the MCU sleeps in dtm_wait() between timer cycles.
  */
 int main(void)
 {
@@ -130,71 +242,49 @@ int main(void)
     for (;;)
     {
         // Will return every timeout, 625 us.
-        current_time = dtm_wait();  
-
-        if (NRF_UART0->EVENTS_RXDRDY == 0)
-        {
-            // Nothing read from the UART.
-            continue;
-        }
-        NRF_UART0->EVENTS_RXDRDY = 0;
-        rx_byte                  = (uint8_t)NRF_UART0->RXD;
+        current_time = dtm_wait();
 
-        if (!is_msb_read)
+        while (uart_get(&rx_byte))
         {
-            // This is first byte of two-byte command.
-            is_msb_read       = true;
-            dtm_cmd_from_uart = ((dtm_cmd_t)rx_byte) << 8;
-            msb_time          = current_time;
-
-            // Go back and wait for 2nd byte of command word.
-            continue;
-        }
-
-        // This is the second byte read; combine it with the first and process command
-        if (current_time > (msb_time + MAX_ITERATIONS_NEEDED_FOR_NEXT_BYTE))
-        {
-            // More than ~5mS after msb: Drop old byte, take the new byte as MSB.
-            // The variable is_msb_read will remains true.
-            // Go back and wait for 2nd byte of the command word.
-            dtm_cmd_from_uart = ((dtm_cmd_t)rx_byte) << 8;
-            msb_time          = current_time;
-            continue;
-        }
-
-        // 2-byte UART command received.
-        is_msb_read        = false;
-        dtm_cmd_from_uart |= (dtm_cmd_t)rx_byte;
+            if (!is_msb_read)
+            {
+                // This is first byte of two-byte command.
+                is_msb_read       = true;
+                dtm_cmd_from_uart = ((dtm_cmd_t)rx_byte) << 8;
+                msb_time          = current_time;
 
-        if (dtm_cmd_put(dtm_cmd_from_uart) != DTM_SUCCESS)
-        {
-            // Extended error handling may be put here. 
-            // Default behavior is to return the event on the UART (see below);
-            // the event report will reflect any lack of success.
-        }
+                // Go back and wait for 2nd byte of command word.
+                continue;
+            }
 
-        // Retrieve result of the operation. This implementation will busy-loop
-        // for the duration of the byte transmissions on the UART.
-        if (dtm_event_get(&result))
-        {
-            // Report command status on the UART.
-            // Transmit MSB of the result.
-            NRF_UART0->TXD = (result >> 8) & 0xFF;
-            // Wait until MSB is sent.
-            while (NRF_UART0->EVENTS_TXDRDY != 1)
+            // This is the second byte read; combine it with the first and process command
+            if (current_time > (msb_time + MAX_ITERATIONS_NEEDED_FOR_NEXT_BYTE))
             {
-                // Do nothing.
+                // More than ~5mS after msb: Drop old byte, take the new byte as MSB.
+                // The variable is_msb_read will remains true.
+                // Go back and wait for 2nd byte of the command word.
+                dtm_cmd_from_uart = ((dtm_cmd_t)rx_byte) << 8;
+                msb_time          = current_time;
+                continue;
             }
-            NRF_UART0->EVENTS_TXDRDY = 0;
 
-            // Transmit LSB of the result.
-            NRF_UART0->TXD = result & 0xFF;
-            // Wait until LSB is sent.
-            while (NRF_UART0->EVENTS_TXDRDY != 1)
+            // 2-byte UART command received.
+            is_msb_read        = false;
+            dtm_cmd_from_uart |= (dtm_cmd_t)rx_byte;
+
+            if (dtm_cmd_put(dtm_cmd_from_uart) != DTM_SUCCESS)
             {
-                // Do nothing.
+                // Extended error handling may be put here.
+                // Default behavior is to return the event on the UART (see below);
+                // the event report will reflect any lack of success.
             }
-            NRF_UART0->EVENTS_TXDRDY = 0;
+        }
+
+        // Report command results, and the result table of a completed sweep, without waiting
+        // for the transmission.
+        while (uart_event_room() && dtm_event_get(&result))
+        {
+            uart_event_put(result);
         }
     }
 }
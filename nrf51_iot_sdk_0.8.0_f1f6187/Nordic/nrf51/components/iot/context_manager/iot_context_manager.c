@@ -15,6 +15,7 @@
 #include "sdk_config.h"
 #include "iot_common.h"
 #include "app_trace.h"
+#include "app_util_platform.h"
 #include "iot_context_manager.h"
 
 /**
@@ -45,6 +46,10 @@
 #define CID_VALUE_MAX                15
 #define PREFIX_LENGTH_VALUE_MAX      128
 
+#define CONTEXT_INDEX_NONE           0xFF                                                           /**< No entry in the context table. */
+
+STATIC_ASSERT(IOT_CONTEXT_MANAGER_MAX_CONTEXTS < CONTEXT_INDEX_NONE);
+
 /**
  * @defgroup api_param_check API Parameters check macros.
  *
@@ -119,12 +124,30 @@
 #define CM_MUTEX_UNLOCK() SDK_MUTEX_UNLOCK(m_iot_context_manager_mutex)                             /**< Unlock module using mutex */
 /** @} */
 
-/**@brief Context table, managing by IPv6 stack. */
+/**@brief Context table, managing by IPv6 stack.
+ *
+ * @details Besides the contexts, the table holds lookup structures rebuilt on every change of the
+ *          contexts: a map from context identifier to entry, and the valid entries ordered on
+ *          decreasing prefix length, so that the first prefix match is the longest one.
+ *          The result of the last lookup by address is cached. Only the leading bytes covered by
+ *          the longest prefix in the table take part in the match, so the cache is keyed on those.
+ *          Lookups are done both for compression, from the main context, and for decompression,
+ *          from the BLE event context, so the cache is only accessed in a critical region. Every
+ *          change of the contexts increments the generation, and a lookup only stores its result
+ *          in the cache if the generation has not changed since the lookup started.
+ */
 typedef struct
 {
     iot_interface_t * p_interface;                                                                  /**< IoT interface pointer. */
     uint8_t           context_count;                                                                /**< Number of valid contexts in the table. */
     iot_context_t     contexts[IOT_CONTEXT_MANAGER_MAX_CONTEXTS];                                   /**< Array of valid contexts. */
+    uint8_t           cid_index[CID_VALUE_MAX + 1];                                                 /**< Entry of each context identifier, CONTEXT_INDEX_NONE if not in use. */
+    uint8_t           prefix_order[IOT_CONTEXT_MANAGER_MAX_CONTEXTS];                               /**< Entries of valid contexts, on decreasing prefix length. */
+    uint8_t           prefix_bytes;                                                                 /**< Number of address bytes covered by the longest prefix in the table. */
+    uint32_t          generation;                                                                   /**< Incremented on every change of the contexts. */
+    bool              cache_valid;                                                                  /**< Indicates if the lookup cache holds a result. */
+    uint8_t           cache_index;                                                                  /**< Entry found by the cached lookup, CONTEXT_INDEX_NONE if none matched. */
+    uint8_t           cache_key[IPV6_ADDR_SIZE];                                                    /**< Leading address bytes of the cached lookup. */
 }iot_context_table_t;
 
 
@@ -143,6 +166,55 @@ static void context_init(iot_context_t * p_context)
 }
 
 
+/**@brief Rebuilds lookup structures of context table after a change of its contexts. */
+static void context_table_index(uint32_t table_id)
+{
+    iot_context_table_t * p_table = &m_context_table[table_id];
+    uint32_t              index;
+    uint32_t              count      = 0;
+    uint32_t              prefix_max = 0;
+
+    memset(p_table->cid_index, CONTEXT_INDEX_NONE, sizeof(p_table->cid_index));
+
+    for (index = 0; index < IOT_CONTEXT_MANAGER_MAX_CONTEXTS; index++)
+    {
+        const iot_context_t * p_context = &p_table->contexts[index];
+        uint32_t              position  = count;
+
+        if (p_context->context_id > CID_VALUE_MAX)
+        {
+            continue;
+        }
+
+        p_table->cid_index[p_context->context_id] = index;
+
+        // Insertion sort, entries with equal prefix length keep table order.
+        while ((position > 0) &&
+               (p_table->contexts[p_table->prefix_order[position - 1]].prefix_len < p_context->prefix_len))
+        {
+            p_table->prefix_order[position] = p_table->prefix_order[position - 1];
+            position--;
+        }
+
+        p_table->prefix_order[position] = index;
+        count++;
+
+        if (p_context->prefix_len > prefix_max)
+        {
+            prefix_max = p_context->prefix_len;
+        }
+    }
+
+    p_table->context_count = count;
+    p_table->prefix_bytes  = (prefix_max + 7) >> 3;
+
+    CRITICAL_REGION_ENTER();
+    p_table->generation++;
+    p_table->cache_valid   = false;
+    CRITICAL_REGION_EXIT();
+}
+
+
 /**@brief Initializes context table. */
 static void context_table_init(uint32_t table_id)
 {
@@ -151,9 +223,11 @@ static void context_table_init(uint32_t table_id)
     for(index = 0; index < IOT_CONTEXT_MANAGER_MAX_CONTEXTS; index++)
     {
         context_init(&m_context_table[table_id].contexts[index]);
-        m_context_table[table_id].context_count = 0;
-        m_context_table[table_id].p_interface   = NULL;
     }
+
+    m_context_table[table_id].p_interface = NULL;
+
+    context_table_index(table_id);
 }
 
 
@@ -179,50 +253,77 @@ static uint32_t context_find_by_cid(uint32_t         table_id,
                                     uint8_t          context_id,
                                     iot_context_t ** pp_context)
 {
-    uint32_t index;
+    uint32_t index = CONTEXT_INDEX_NONE;
 
-    for (index = 0; index < IOT_CONTEXT_MANAGER_MAX_CONTEXTS; index++)
+    if (context_id <= CID_VALUE_MAX)
     {
-        if(m_context_table[table_id].contexts[index].context_id == context_id)
-        {
-              *pp_context = &m_context_table[table_id].contexts[index];
-              return NRF_SUCCESS;
-        }
+        index = m_context_table[table_id].cid_index[context_id];
     }
 
-    return (NRF_ERROR_NOT_FOUND | IOT_CONTEXT_MANAGER_ERR_BASE);
+    if (index == CONTEXT_INDEX_NONE)
+    {
+        return (NRF_ERROR_NOT_FOUND | IOT_CONTEXT_MANAGER_ERR_BASE);
+    }
+
+    *pp_context = &m_context_table[table_id].contexts[index];
+
+    return NRF_SUCCESS;
 }
 
 
-/**@brief Looks up context table for specific IPv6 address. */
+/**@brief Looks up context table for the longest prefix matching specific IPv6 address. */
 static uint32_t context_find_by_prefix(uint32_t               table_id, 
                                        const ipv6_addr_t    * p_prefix, 
                                        iot_context_t       ** pp_context)
 {
-    uint32_t index;
-    uint32_t context_left;
-    
-    context_left = m_context_table[table_id].context_count;
-
-    for (index = 0; index < IOT_CONTEXT_MANAGER_MAX_CONTEXTS && context_left; index++)
+    iot_context_table_t * p_table = &m_context_table[table_id];
+    uint32_t              index;
+    uint32_t              order;
+    uint32_t              generation;
+    bool                  cache_hit;
+
+    CRITICAL_REGION_ENTER();
+    cache_hit  = p_table->cache_valid &&
+                 (memcmp(p_table->cache_key, p_prefix->u8, p_table->prefix_bytes) == 0);
+    index      = p_table->cache_index;
+    generation = p_table->generation;
+    CRITICAL_REGION_EXIT();
+
+    if (!cache_hit)
     {
-        if(m_context_table[table_id].contexts[index].context_id != IPV6_CONTEXT_IDENTIFIER_NONE)
+        index = CONTEXT_INDEX_NONE;
+
+        for (order = 0; order < p_table->context_count; order++)
+        {
+            const iot_context_t * p_context = &p_table->contexts[p_table->prefix_order[order]];
+
+            // Check if address have matched in CID table.
+            if (IPV6_ADDRESS_PREFIX_CMP(p_context->prefix.u8, p_prefix->u8, p_context->prefix_len))
+            {
+                index = p_table->prefix_order[order];
+                break;
+            }
+        }
+
+        // A result found in a table that was changed during the scan must not be cached.
+        CRITICAL_REGION_ENTER();
+        if (p_table->generation == generation)
         {
-              // Check if address have matched in CID table.
-              if (IPV6_ADDRESS_PREFIX_CMP(m_context_table[table_id].contexts[index].prefix.u8,
-                                          p_prefix->u8,
-                                          m_context_table[table_id].contexts[index].prefix_len))
-              {
-                  *pp_context = &m_context_table[table_id].contexts[index];
-                  return NRF_SUCCESS;
-              } 
-          
-            // Decrease left context in table, to avoid too many checking.
-            context_left--;
+            memcpy(p_table->cache_key, p_prefix->u8, p_table->prefix_bytes);
+            p_table->cache_index = index;
+            p_table->cache_valid = true;
         }
+        CRITICAL_REGION_EXIT();
     }
-    
-    return (NRF_ERROR_NOT_FOUND | IOT_CONTEXT_MANAGER_ERR_BASE);
+
+    if (index == CONTEXT_INDEX_NONE)
+    {
+        return (NRF_ERROR_NOT_FOUND | IOT_CONTEXT_MANAGER_ERR_BASE);
+    }
+
+    *pp_context = &p_table->contexts[index];
+
+    return NRF_SUCCESS;
 }
 
 
@@ -369,12 +470,6 @@ uint32_t iot_context_manager_update(const iot_interface_t * p_interface,
           if(retval != NRF_SUCCESS)
           {
               err_code = context_find_free(table_id, &p_internal_context);
-
-              // Increase context count.
-              if(err_code == NRF_SUCCESS)
-              {
-                  m_context_table[table_id].context_count++;
-              }
           }
 
           if(err_code == NRF_SUCCESS)
@@ -384,6 +479,8 @@ uint32_t iot_context_manager_update(const iot_interface_t * p_interface,
                p_internal_context->prefix_len       = p_context->prefix_len;
                p_internal_context->compression_flag = p_context->compression_flag;
                memcpy(p_internal_context->prefix.u8, p_context->prefix.u8, IPV6_ADDR_SIZE);
+
+               context_table_index(table_id);
            }
            else
            {
@@ -422,13 +519,10 @@ uint32_t iot_context_manager_remove(const iot_interface_t * p_interface,
 
     if (table_id != IOT_CONTEXT_MANAGER_MAX_TABLES)
     {
-        if(p_context->context_id != IPV6_CONTEXT_IDENTIFIER_NONE)
-        {
-            m_context_table[table_id].context_count--;
-        }
-        
         // Reinit context entry.
-        context_init(p_context);         
+        context_init(p_context);
+
+        context_table_index(table_id);
     }
     else
     {
@@ -90,6 +90,8 @@ uint32_t iot_context_manager_remove(const iot_interface_t * p_interface, iot_con
 
 
 /**@brief Function for searching the proper entry in the context table by IPv6 address.
+ *
+ * If several contexts match the address, the one with the longest prefix is returned.
  *
  * @param[in] p_interface  Pointer to the IoT interface.
  * @param[in] p_addr       Pointer to IPv6 address to be compared with records in the context table.
@@ -145,6 +145,42 @@
 #define ND_OPT_PIO_A_MASK               0x40
 #define ND_OPT_PIO_A_POS               6
 
+#ifndef ICMP6_ENABLE_ND_ENGINE
+#define ICMP6_ENABLE_ND_ENGINE                 0                                                    /**< Set to 1 to enable the host Neighbour Discovery engine, see @ref icmp6_nd_start. */
+#endif
+
+#ifndef ICMP6_ND_RTR_SOLICITATION_INTERVAL
+#define ICMP6_ND_RTR_SOLICITATION_INTERVAL     10                                                   /**< Initial interval between Router Solicitations, in seconds (RFC 6775). */
+#endif
+
+#ifndef ICMP6_ND_MAX_RTR_SOLICITATIONS
+#define ICMP6_ND_MAX_RTR_SOLICITATIONS         3                                                    /**< Router Solicitations sent at the initial interval before backing off. */
+#endif
+
+#ifndef ICMP6_ND_MAX_RTR_SOLICITATION_INTERVAL
+#define ICMP6_ND_MAX_RTR_SOLICITATION_INTERVAL 60                                                   /**< Longest interval between Router Solicitations, in seconds (RFC 6775). */
+#endif
+
+#ifndef ICMP6_ND_RETRANS_TIMER
+#define ICMP6_ND_RETRANS_TIMER                 1                                                    /**< Initial retransmission interval of address registrations, in seconds. */
+#endif
+
+#ifndef ICMP6_ND_MAX_UNICAST_SOLICIT
+#define ICMP6_ND_MAX_UNICAST_SOLICIT           3                                                    /**< Address registrations sent before the router is solicited again. */
+#endif
+
+#ifndef ICMP6_ND_ARO_LIFETIME
+#define ICMP6_ND_ARO_LIFETIME                  60                                                   /**< Registration lifetime requested in ARO, in units of 60 seconds. */
+#endif
+
+#ifndef ICMP6_ND_REFRESH_MARGIN
+#define ICMP6_ND_REFRESH_MARGIN                30                                                   /**< Time before expiry at which lifetimes are refreshed, in seconds. */
+#endif
+
+#ifndef ICMP6_ND_MAX_ADDRESSES
+#define ICMP6_ND_MAX_ADDRESSES                 IPV6_MAX_ADDRESS_PER_INTERFACE                       /**< Addresses per interface registered by the Neighbour Discovery engine. */
+#endif
+
 #define ND_HOP_LIMIT                   255                                                          /**< Value of Hop Limit used in Neighbour Discovery procedure. */
 
 #define ICMP6_OFFSET                   IPV6_IP_HEADER_SIZE + ICMP6_HEADER_SIZE                      /**< Offset of ICMPv6 packet type. */
@@ -228,6 +264,531 @@ static uint16_t                 m_sequence_number      = 0;
 static icmp6_receive_callback_t m_event_handler        = NULL;                                      /**< Application event handler. */
 SDK_MUTEX_DEFINE(m_icmp6_mutex)                                                                     /**< Mutex variable. Currently unused, this declaration does not occupy any space in RAM. */
 
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+
+#define ND_RA_ROUTER_LIFETIME_OFFSET   2                                                            /**< Offset of Router Lifetime field in Router Advertisement message. */
+#define ND_NA_TARGET_OFFSET            4                                                            /**< Offset of Target Address field in Neighbour Advertisement message. */
+
+#define ND_ARO_STATUS_SUCCESS          0                                                            /**< ARO status indicating successful registration. */
+#define ND_ARO_STATUS_NCE_FULL         2                                                            /**< ARO status indicating that the router has no space left for the registration. */
+
+#define ND_LIFETIME_MAX                0x1FFFFF                                                     /**< Longest lifetime tracked, in seconds. Longer lifetimes are refreshed after this time. Keeps timestamps in range of signed comparison. */
+#define ND_SEC_TO_MS(SEC)              ((SEC) * 1000)                                               /**< Converts seconds to milliseconds of wall clock. */
+#define ND_MAX_CONTEXTS                16                                                           /**< Number of 6LoWPAN context identifiers. */
+
+#define ND_ADDR_USED                   0x01                                                         /**< Address entry is in use. */
+#define ND_ADDR_REGISTERED             0x02                                                         /**< Address is registered with the router. */
+#define ND_ADDR_DEPRECATED             0x04                                                         /**< Preferred lifetime of the address has expired. */
+
+#define ND_ABRO_NEW                    0                                                            /**< No ABRO, or ABRO with a newer version. Contexts are applied. */
+#define ND_ABRO_SAME                   1                                                            /**< ABRO with the version already applied. Known contexts are only refreshed. */
+#define ND_ABRO_OLD                    2                                                            /**< ABRO with an older version. Contexts are ignored. */
+
+/**@brief Authoritative Border Router Option header format. */
+typedef struct
+{
+    uint8_t     type;                                                                               /**< Option type. */
+    uint8_t     length;                                                                             /**< Length, units of 8 octets. */
+    uint16_t    version_low;                                                                        /**< Version Low. */
+    uint16_t    version_high;                                                                       /**< Version High. */
+    uint16_t    valid_lifetime;                                                                     /**< Valid Lifetime. */
+    ipv6_addr_t address;                                                                            /**< 6LBR address. */
+} nd_option_6abro_t;
+
+/**@brief Neighbour Discovery states of an interface. */
+typedef enum
+{
+    ND_STATE_IDLE,                                                                                  /**< Engine not started on the interface. */
+    ND_STATE_SOLICIT,                                                                               /**< Router Solicitations are sent until a Router Advertisement is received. */
+    ND_STATE_READY                                                                                  /**< Router known, refreshed before its lifetime expires. */
+} nd_state_t;
+
+/**@brief Address tracked by the Neighbour Discovery engine. */
+typedef struct
+{
+    ipv6_addr_t addr;                                                                               /**< Address formed from a Prefix Information Option. */
+    uint32_t    valid_expiry;                                                                       /**< Time when the valid lifetime expires. */
+    uint32_t    preferred_expiry;                                                                   /**< Time when the preferred lifetime expires. */
+    uint32_t    aro_time;                                                                           /**< Time of the next Neighbour Solicitation with ARO. */
+    uint8_t     flags;                                                                              /**< ND_ADDR_* flags. */
+    uint8_t     retries;                                                                            /**< Number of unanswered registrations. */
+} nd_addr_t;
+
+/**@brief Neighbour Discovery state of an interface. */
+typedef struct
+{
+    const iot_interface_t * p_interface;                                                            /**< Interface, NULL if the entry is unused. */
+    nd_state_t              state;                                                                  /**< Current state. */
+    ipv6_addr_t             router_addr;                                                            /**< Link-local address of the router. */
+    uint32_t                router_expiry;                                                          /**< Time when the router lifetime expires. */
+    uint32_t                rs_time;                                                                /**< Time of the next Router Solicitation. */
+    uint32_t                rs_interval;                                                            /**< Current Router Solicitation interval, in milliseconds. */
+    uint8_t                 rs_count;                                                               /**< Number of unanswered Router Solicitations. */
+    bool                    router_valid;                                                           /**< Indicates if router_addr and router_expiry are valid. */
+    bool                    abro_valid;                                                             /**< Indicates if abro_version is valid. */
+    uint32_t                abro_version;                                                           /**< Version of the last applied ABRO. */
+    uint16_t                context_mask;                                                           /**< Contexts applied from 6CO, one bit per CID. */
+    uint32_t                context_expiry[ND_MAX_CONTEXTS];                                        /**< Time when the valid lifetime of each context expires. */
+    nd_addr_t               addr[ICMP6_ND_MAX_ADDRESSES];                                           /**< Addresses registered with the router. */
+} nd_interface_t;
+
+static nd_interface_t m_nd_interfaces[IPV6_MAX_INTERFACE];                                          /**< Neighbour Discovery state of interfaces. */
+static uint32_t       m_nd_now = 0;                                                                 /**< Wall clock value of the last call to icmp6_timeout_process. */
+
+
+/**@brief Function for checking if a point in time has been reached.
+ *
+ * @param[in]   time  Checked time, in wall clock milliseconds.
+ *
+ * @return      true if the time is now or in the past.
+ */
+static __INLINE bool nd_time_reached(uint32_t time)
+{
+    return ((int32_t)(m_nd_now - time) >= 0);
+}
+
+
+/**@brief Function for returning the earlier of two points in time.
+ *
+ * @param[in]   time1  First time, in wall clock milliseconds.
+ * @param[in]   time2  Second time, in wall clock milliseconds.
+ *
+ * @return      The earlier time.
+ */
+static __INLINE uint32_t nd_time_min(uint32_t time1, uint32_t time2)
+{
+    return ((int32_t)(time1 - time2) < 0) ? time1 : time2;
+}
+
+
+/**@brief Function for converting a lifetime to the time it has to be refreshed at.
+ *
+ * @details The refresh is scheduled ICMP6_ND_REFRESH_MARGIN seconds before the expiry, or at
+ *          seven eighths of short lifetimes.
+ *
+ * @param[in]   lifetime  Lifetime in seconds.
+ *
+ * @return      Refresh time, in wall clock milliseconds.
+ */
+static uint32_t nd_refresh_time(uint32_t lifetime)
+{
+    uint32_t margin;
+
+    lifetime = MIN(lifetime, ND_LIFETIME_MAX);
+    margin   = MIN(lifetime >> 3, ICMP6_ND_REFRESH_MARGIN);
+
+    return (m_nd_now + ND_SEC_TO_MS(lifetime - margin));
+}
+
+
+/**@brief Function for converting a lifetime to its expiry time.
+ *
+ * @param[in]   lifetime  Lifetime in seconds.
+ *
+ * @return      Expiry time, in wall clock milliseconds.
+ */
+static __INLINE uint32_t nd_expiry_time(uint32_t lifetime)
+{
+    return (m_nd_now + ND_SEC_TO_MS(MIN(lifetime, ND_LIFETIME_MAX)));
+}
+
+
+/**@brief Function for finding the Neighbour Discovery state of an interface.
+ *
+ * @param[in]   p_interface  Interface, or NULL to find a free entry.
+ *
+ * @return      Pointer to the state, NULL if not found.
+ */
+static nd_interface_t * nd_interface_find(const iot_interface_t * p_interface)
+{
+    uint32_t index;
+
+    for (index = 0; index < IPV6_MAX_INTERFACE; index++)
+    {
+        if (m_nd_interfaces[index].p_interface == p_interface)
+        {
+            return &m_nd_interfaces[index];
+        }
+    }
+
+    return NULL;
+}
+
+
+/**@brief Function for finding a tracked address.
+ *
+ * @param[in]   p_nd    Neighbour Discovery state of the interface.
+ * @param[in]   p_addr  Address, or NULL to find a free entry.
+ *
+ * @return      Pointer to the address entry, NULL if not found.
+ */
+static nd_addr_t * nd_addr_find(nd_interface_t * p_nd, const ipv6_addr_t * p_addr)
+{
+    uint32_t index;
+
+    for (index = 0; index < ICMP6_ND_MAX_ADDRESSES; index++)
+    {
+        if (p_addr == NULL)
+        {
+            if ((p_nd->addr[index].flags & ND_ADDR_USED) == 0)
+            {
+                return &p_nd->addr[index];
+            }
+        }
+        else if ((p_nd->addr[index].flags & ND_ADDR_USED) &&
+                 (0 == IPV6_ADDRESS_CMP(&p_nd->addr[index].addr, p_addr)))
+        {
+            return &p_nd->addr[index];
+        }
+    }
+
+    return NULL;
+}
+
+
+/**@brief Function for starting the solicitation of a router.
+ *
+ * @details The first Router Solicitation is sent at the next timeout processing.
+ *
+ * @param[in]   p_nd  Neighbour Discovery state of the interface.
+ *
+ * @return      None.
+ */
+static void nd_solicit_start(nd_interface_t * p_nd)
+{
+    p_nd->state       = ND_STATE_SOLICIT;
+    p_nd->rs_time     = m_nd_now;
+    p_nd->rs_interval = ND_SEC_TO_MS(ICMP6_ND_RTR_SOLICITATION_INTERVAL);
+    p_nd->rs_count    = 0;
+}
+
+
+/**@brief Function for sending a Router Solicitation and scheduling its retransmission.
+ *
+ * @details While the router lifetime has not expired, the solicitation is sent to the router
+ *          only. Retransmissions are sent ICMP6_ND_MAX_RTR_SOLICITATIONS times at the initial
+ *          interval, then with exponential backoff up to ICMP6_ND_MAX_RTR_SOLICITATION_INTERVAL.
+ *
+ * @param[in]   p_nd  Neighbour Discovery state of the interface.
+ *
+ * @return      None.
+ */
+static void nd_rs_send(nd_interface_t * p_nd)
+{
+    uint32_t    err_code;
+    ipv6_addr_t src_addr;
+    ipv6_addr_t dest_addr;
+
+    IPV6_CREATE_LINK_LOCAL_FROM_EUI64(&src_addr, p_nd->p_interface->local_addr.identifier);
+
+    if (p_nd->router_valid && !nd_time_reached(p_nd->router_expiry))
+    {
+        dest_addr = p_nd->router_addr;
+    }
+    else
+    {
+        // All-routers multicast address.
+        IPV6_ADDRESS_INITIALIZE(&dest_addr);
+        dest_addr.u8[0]  = 0xFF;
+        dest_addr.u8[1]  = 0x02;
+        dest_addr.u8[15] = 0x02;
+    }
+
+    err_code = icmp6_rs_send(p_nd->p_interface, &src_addr, &dest_addr);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        ICMP6_ERR("[ICMP6]: Cannot send Router Solicitation, error 0x%08lX!\r\n", err_code);
+    }
+
+    p_nd->rs_time = m_nd_now + p_nd->rs_interval;
+
+    if (p_nd->rs_count < ICMP6_ND_MAX_RTR_SOLICITATIONS)
+    {
+        p_nd->rs_count++;
+    }
+    else
+    {
+        p_nd->rs_interval = MIN(p_nd->rs_interval << 1,
+                                ND_SEC_TO_MS(ICMP6_ND_MAX_RTR_SOLICITATION_INTERVAL));
+    }
+}
+
+
+/**@brief Function for sending a Neighbour Solicitation with ARO, registering an address.
+ *
+ * @details Unanswered registrations are retransmitted with exponential backoff. After
+ *          ICMP6_ND_MAX_UNICAST_SOLICIT attempts, the router is solicited again.
+ *
+ * @param[in]   p_nd    Neighbour Discovery state of the interface.
+ * @param[in]   p_addr  Address to register.
+ *
+ * @return      None.
+ */
+static void nd_aro_send(nd_interface_t * p_nd, nd_addr_t * p_addr)
+{
+    uint32_t         err_code;
+    icmp6_ns_param_t ns_param;
+
+    if (p_addr->retries >= ICMP6_ND_MAX_UNICAST_SOLICIT)
+    {
+        ICMP6_ERR("[ICMP6]: Router does not answer address registration!\r\n");
+
+        p_addr->retries  = 0;
+        p_addr->aro_time = m_nd_now + ND_SEC_TO_MS(ICMP6_ND_MAX_RTR_SOLICITATION_INTERVAL);
+        p_nd->router_valid = false;
+
+        nd_solicit_start(p_nd);
+        return;
+    }
+
+    ns_param.target_addr  = p_addr->addr;
+    ns_param.add_aro      = true;
+    ns_param.aro_lifetime = ICMP6_ND_ARO_LIFETIME;
+
+    err_code = icmp6_ns_send(p_nd->p_interface, &p_addr->addr, &p_nd->router_addr, &ns_param);
+
+    if (err_code != NRF_SUCCESS)
+    {
+        ICMP6_ERR("[ICMP6]: Cannot send address registration, error 0x%08lX!\r\n", err_code);
+    }
+
+    p_addr->aro_time = m_nd_now + (ND_SEC_TO_MS(ICMP6_ND_RETRANS_TIMER) << p_addr->retries);
+    p_addr->retries++;
+}
+
+
+/**@brief Function for removing a tracked address from the interface.
+ *
+ * @param[in]   p_nd    Neighbour Discovery state of the interface.
+ * @param[in]   p_addr  Address entry.
+ *
+ * @return      None.
+ */
+static void nd_addr_remove(nd_interface_t * p_nd, nd_addr_t * p_addr)
+{
+    UNUSED_VARIABLE(ipv6_address_remove(p_nd->p_interface, &p_addr->addr));
+
+    p_addr->flags = 0;
+}
+
+
+/**@brief Function for updating the lifetimes of an address formed from a Prefix Information Option.
+ *
+ * @details New addresses are registered with the router at the next timeout processing.
+ *
+ * @param[in]   p_nd                Neighbour Discovery state of the interface.
+ * @param[in]   p_addr              Address.
+ * @param[in]   valid_lifetime      Valid lifetime in seconds.
+ * @param[in]   preferred_lifetime  Preferred lifetime in seconds.
+ *
+ * @return      None.
+ */
+static void nd_pio_update(nd_interface_t    * p_nd,
+                          const ipv6_addr_t * p_addr,
+                          uint32_t            valid_lifetime,
+                          uint32_t            preferred_lifetime)
+{
+    nd_addr_t * p_entry = nd_addr_find(p_nd, p_addr);
+
+    if (p_entry == NULL)
+    {
+        p_entry = nd_addr_find(p_nd, NULL);
+
+        if (p_entry == NULL)
+        {
+            ICMP6_ERR("[ICMP6]: No space for tracking the address!\r\n");
+            return;
+        }
+
+        p_entry->addr     = *p_addr;
+        p_entry->flags    = ND_ADDR_USED;
+        p_entry->retries  = 0;
+        p_entry->aro_time = m_nd_now;
+    }
+
+    p_entry->valid_expiry     = nd_expiry_time(valid_lifetime);
+    p_entry->preferred_expiry = nd_expiry_time(preferred_lifetime);
+
+    // Address state was set by the caller according to the preferred lifetime.
+    if (preferred_lifetime == 0)
+    {
+        p_entry->flags |= ND_ADDR_DEPRECATED;
+    }
+    else
+    {
+        p_entry->flags &= ~ND_ADDR_DEPRECATED;
+    }
+}
+
+
+/**@brief Function for checking the version of the Authoritative Border Router Option.
+ *
+ * @param[in]   p_nd      Neighbour Discovery state of the interface.
+ * @param[in]   p_packet  Router Advertisement message.
+ *
+ * @return      ND_ABRO_NEW, ND_ABRO_SAME or ND_ABRO_OLD.
+ */
+static uint32_t nd_abro_check(nd_interface_t * p_nd, const iot_pbuffer_t * p_packet)
+{
+    uint32_t            version;
+    int32_t             diff;
+    uint16_t            curr_opt_offset = ND_RA_HEADER_SIZE;
+    nd_option_t       * p_opt;
+    nd_option_6abro_t * p_abro;
+
+    while (curr_opt_offset < p_packet->length)
+    {
+        p_opt = (nd_option_t *)(p_packet->p_payload + curr_opt_offset);
+
+        if (p_opt->length == 0)
+        {
+            break;
+        }
+
+        if (p_opt->type == ND_OPT_TYPE_6ABRO)
+        {
+            p_abro  = (nd_option_6abro_t *)p_opt;
+            version = ((uint32_t)NTOHS(p_abro->version_high) << 16) | NTOHS(p_abro->version_low);
+
+            if (p_nd->abro_valid)
+            {
+                // Wrap-safe comparison of versions.
+                diff = (int32_t)(version - p_nd->abro_version);
+
+                if (diff < 0)
+                {
+                    return ND_ABRO_OLD;
+                }
+                else if (diff == 0)
+                {
+                    return ND_ABRO_SAME;
+                }
+            }
+
+            p_nd->abro_version = version;
+            p_nd->abro_valid   = true;
+
+            return ND_ABRO_NEW;
+        }
+
+        curr_opt_offset += 8 * p_opt->length;
+    }
+
+    return ND_ABRO_NEW;
+}
+
+
+/**@brief Function for processing the timers of one interface.
+ *
+ * @param[in]   p_nd  Neighbour Discovery state of the interface.
+ *
+ * @return      None.
+ */
+static void nd_interface_process(nd_interface_t * p_nd)
+{
+    uint32_t         index;
+    iot_context_t  * p_context;
+    ipv6_addr_conf_t addr_conf;
+    nd_addr_t      * p_addr;
+
+    // Expire contexts.
+    for (index = 0; index < ND_MAX_CONTEXTS; index++)
+    {
+        if ((p_nd->context_mask & (1 << index)) && nd_time_reached(p_nd->context_expiry[index]))
+        {
+            p_nd->context_mask &= ~(1 << index);
+
+            if (iot_context_manager_get_by_cid(p_nd->p_interface, index, &p_context) == NRF_SUCCESS)
+            {
+                UNUSED_VARIABLE(iot_context_manager_remove(p_nd->p_interface, p_context));
+                ICMP6_TRC("[ICMP6]: Context expired! CID = 0x%02lx\r\n", index);
+            }
+        }
+    }
+
+    // Expire and register addresses.
+    for (index = 0; index < ICMP6_ND_MAX_ADDRESSES; index++)
+    {
+        p_addr = &p_nd->addr[index];
+
+        if ((p_addr->flags & ND_ADDR_USED) == 0)
+        {
+            continue;
+        }
+
+        if (nd_time_reached(p_addr->valid_expiry))
+        {
+            ICMP6_TRC("[ICMP6]: Address expired!\r\n");
+            nd_addr_remove(p_nd, p_addr);
+            continue;
+        }
+
+        if (((p_addr->flags & ND_ADDR_DEPRECATED) == 0) && nd_time_reached(p_addr->preferred_expiry))
+        {
+            p_addr->flags   |= ND_ADDR_DEPRECATED;
+            addr_conf.addr   = p_addr->addr;
+            addr_conf.state  = IPV6_ADDR_STATE_DEPRECATED;
+
+            UNUSED_VARIABLE(ipv6_address_set(p_nd->p_interface, &addr_conf));
+        }
+
+        if ((p_nd->state == ND_STATE_READY) && nd_time_reached(p_addr->aro_time))
+        {
+            nd_aro_send(p_nd, p_addr);
+        }
+    }
+
+    // Refresh or solicit router.
+    if (p_nd->state == ND_STATE_READY)
+    {
+        if (nd_time_reached(p_nd->rs_time))
+        {
+            nd_solicit_start(p_nd);
+        }
+    }
+
+    if ((p_nd->state == ND_STATE_SOLICIT) && nd_time_reached(p_nd->rs_time))
+    {
+        nd_rs_send(p_nd);
+    }
+}
+
+
+/**@brief Function for processing a Router Advertisement in the Neighbour Discovery engine.
+ *
+ * @details Records the router and schedules the next Router Solicitation before the first of the
+ *          router, prefix or context lifetimes expires.
+ *
+ * @param[in]   p_nd             Neighbour Discovery state of the interface.
+ * @param[in]   p_router_addr    Link-local address of the router.
+ * @param[in]   router_lifetime  Router lifetime in seconds.
+ * @param[in]   refresh_time     Earliest refresh time of prefixes and contexts in the message.
+ *
+ * @return      None.
+ */
+static void nd_ra_update(nd_interface_t    * p_nd,
+                         const ipv6_addr_t * p_router_addr,
+                         uint32_t            router_lifetime,
+                         uint32_t            refresh_time)
+{
+    if (router_lifetime == 0)
+    {
+        // Router is leaving.
+        p_nd->router_valid = false;
+        nd_solicit_start(p_nd);
+        return;
+    }
+
+    p_nd->router_addr   = *p_router_addr;
+    p_nd->router_expiry = nd_expiry_time(router_lifetime);
+    p_nd->router_valid  = true;
+    p_nd->state         = ND_STATE_READY;
+    p_nd->rs_time       = nd_time_min(nd_refresh_time(router_lifetime), refresh_time);
+}
+
+#endif // ICMP6_ENABLE_ND_ENGINE
+
 /**@brief Function for initializing default values of IP Header for ICMP.
  *
  * @param[in]   p_ip_header   Pointer to IPv6 header.
@@ -458,6 +1019,19 @@ static uint32_t ra_input(iot_interface_t  * p_interface,
         return ICMP6_INVALID_PACKET_DATA;
     }
 
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+    uint32_t         lifetime;
+    uint32_t         abro_state   = ND_ABRO_NEW;
+    uint32_t         refresh_time = nd_expiry_time(ND_LIFETIME_MAX);
+    nd_interface_t * p_nd         = nd_interface_find(p_interface);
+
+    if(p_nd != NULL)
+    {
+        // ABRO version decides if contexts have to be applied, it may follow the 6CO options.
+        abro_state = nd_abro_check(p_nd, p_packet);
+    }
+#endif
+
     // Read all option we get.
     while(curr_opt_offset < p_packet->length)
     {
@@ -502,15 +1076,46 @@ static uint32_t ra_input(iot_interface_t  * p_interface,
                     {
                         temp_address.state = IPV6_ADDR_STATE_PREFERRED;
 
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+                        if(p_pio->preferred_lifetime == 0)
+                        {
+                            temp_address.state = IPV6_ADDR_STATE_DEPRECATED;
+                        }
+#endif
+
                         err_code = ipv6_address_set(p_interface, &temp_address);
 
                         if(err_code != NRF_SUCCESS)
                         {
                             ICMP6_ERR("[ICMP6]: Cannot add new address! Address table is full!\r\n"); 
                         }
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+                        else if(p_nd != NULL)
+                        {
+                            lifetime = NTOHL(p_pio->valid_lifetime);
+
+                            nd_pio_update(p_nd,
+                                          &temp_address.addr,
+                                          lifetime,
+                                          NTOHL(p_pio->preferred_lifetime));
+
+                            refresh_time = nd_time_min(refresh_time, nd_refresh_time(lifetime));
+                        }
+#endif
                     }
                     else
                     {
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+                        if(p_nd != NULL)
+                        {
+                            nd_addr_t * p_nd_addr = nd_addr_find(p_nd, &temp_address.addr);
+
+                            if(p_nd_addr != NULL)
+                            {
+                                p_nd_addr->flags = 0;
+                            }
+                        }
+#endif
                         err_code = ipv6_address_remove(p_interface, &temp_address.addr);
                         
                         if(err_code != NRF_SUCCESS)
@@ -531,6 +1136,14 @@ static uint32_t ra_input(iot_interface_t  * p_interface,
             {
                 p_6co = (nd_option_6co_t *)p_opt;
 
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+                if(abro_state == ND_ABRO_OLD)
+                {
+                    ICMP6_TRC("[ICMP6]: Ignore context from outdated ABRO version!\r\n");
+                    break;
+                }
+#endif
+
                 memset(context.prefix.u8, 0, IPV6_ADDR_SIZE);
 
                 context.prefix           = p_6co->context;
@@ -556,9 +1169,33 @@ static uint32_t ra_input(iot_interface_t  * p_interface,
                         }
                     }
 
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+                    if(p_nd != NULL)
+                    {
+                        p_nd->context_mask &= ~(1 << context.context_id);
+                    }
+#endif
                 }
                 else
                 {
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+                    if(p_nd != NULL)
+                    {
+                        lifetime = 60 * NTOHS(p_6co->valid_lifetime);
+
+                        p_nd->context_expiry[context.context_id] = nd_expiry_time(lifetime);
+                        refresh_time = nd_time_min(refresh_time, nd_refresh_time(lifetime));
+
+                        if((abro_state == ND_ABRO_SAME) &&
+                           (p_nd->context_mask & (1 << context.context_id)))
+                        {
+                            // Same ABRO version, context is already up to date.
+                            break;
+                        }
+
+                        p_nd->context_mask |= (1 << context.context_id);
+                    }
+#endif
                     err_code = iot_context_manager_update(p_interface, &context);
                         
                     if(err_code == NRF_SUCCESS)
@@ -575,6 +1212,97 @@ static uint32_t ra_input(iot_interface_t  * p_interface,
         curr_opt_offset += 8 * p_opt->length;
     }
 
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+    if(p_nd != NULL)
+    {
+        lifetime = ((uint32_t)p_packet->p_payload[ND_RA_ROUTER_LIFETIME_OFFSET] << 8) |
+                   p_packet->p_payload[ND_RA_ROUTER_LIFETIME_OFFSET + 1];
+
+        nd_ra_update(p_nd, &p_ip_header->srcaddr, lifetime, refresh_time);
+    }
+#endif
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for parsing Neighbour Advertisement message.
+ *        Only the ARO status of addresses registered by the Neighbour Discovery engine is
+ *        processed.
+ *
+ * @param[in]   p_interface   Pointer to external interface from which packet come.
+ * @param[in]   p_packet      Pointer to packet buffer.
+ *
+ * @return      NRF_SUCCESS after successful processing, error otherwise.
+ */
+static uint32_t na_input(iot_interface_t * p_interface,
+                         iot_pbuffer_t   * p_packet)
+{
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+    ipv6_addr_t       target_addr;
+    nd_addr_t       * p_addr;
+    nd_option_t     * p_opt;
+    nd_option_aro_t * p_aro           = NULL;
+    uint16_t          curr_opt_offset = ND_NA_HEADER_SIZE;
+    nd_interface_t  * p_nd            = nd_interface_find(p_interface);
+
+    if(p_nd == NULL || p_packet->length < ND_NA_HEADER_SIZE)
+    {
+        return NRF_SUCCESS;
+    }
+
+    memcpy(target_addr.u8, p_packet->p_payload + ND_NA_TARGET_OFFSET, IPV6_ADDR_SIZE);
+
+    while(curr_opt_offset < p_packet->length)
+    {
+        p_opt = (nd_option_t *)(p_packet->p_payload + curr_opt_offset);
+
+        if(p_opt->length == 0)
+        {
+            return ICMP6_INVALID_PACKET_DATA;
+        }
+
+        if(p_opt->type == ND_OPT_TYPE_ARO)
+        {
+            p_aro = (nd_option_aro_t *)p_opt;
+        }
+
+        curr_opt_offset += 8 * p_opt->length;
+    }
+
+    p_addr = nd_addr_find(p_nd, &target_addr);
+
+    if(p_aro == NULL || p_addr == NULL)
+    {
+        return NRF_SUCCESS;
+    }
+
+    p_addr->retries = 0;
+
+    if(p_aro->status == ND_ARO_STATUS_SUCCESS)
+    {
+        ICMP6_TRC("[ICMP6]: Address registered.\r\n");
+
+        p_addr->flags   |= ND_ADDR_REGISTERED;
+        p_addr->aro_time = nd_refresh_time(60 * NTOHS(p_aro->registration_lifetime));
+    }
+    else if(p_aro->status == ND_ARO_STATUS_NCE_FULL)
+    {
+        ICMP6_ERR("[ICMP6]: Router cannot register more addresses!\r\n");
+
+        p_addr->aro_time = m_nd_now + ND_SEC_TO_MS(ICMP6_ND_MAX_RTR_SOLICITATION_INTERVAL);
+    }
+    else
+    {
+        ICMP6_ERR("[ICMP6]: Address registration refused, status = 0x%02x!\r\n", p_aro->status);
+
+        nd_addr_remove(p_nd, p_addr);
+    }
+#else
+    UNUSED_PARAMETER(p_interface);
+    UNUSED_PARAMETER(p_packet);
+#endif
+
     return NRF_SUCCESS;
 }
 
@@ -617,7 +1345,7 @@ static uint32_t ndisc_input(iot_interface_t  * p_interface,
         case ICMP6_TYPE_NEIGHBOR_ADVERTISEMENT:
             ICMP6_TRC("[ICMP6]: Got Neighbour Advertisement message.\r\n");
 
-            process_result = NRF_SUCCESS;
+            process_result = na_input(p_interface, p_packet);
         break;
 
         default:
@@ -1051,3 +1779,109 @@ uint32_t icmp6_input(iot_interface_t  * p_interface,
 
     return NRF_SUCCESS;
 }
+
+
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+
+uint32_t icmp6_nd_start(const iot_interface_t * p_interface)
+{
+    VERIFY_MODULE_IS_INITIALIZED();
+    NULL_PARAM_CHECK(p_interface);
+
+    uint32_t         err_code = NRF_SUCCESS;
+    nd_interface_t * p_nd;
+
+    ICMP6_MUTEX_LOCK();
+
+    ICMP6_TRC("[ICMP6]: >> icmp6_nd_start\r\n");
+
+    p_nd = nd_interface_find(p_interface);
+
+    if (p_nd == NULL)
+    {
+        p_nd = nd_interface_find(NULL);
+    }
+
+    if (p_nd != NULL)
+    {
+        memset(p_nd, 0, sizeof(nd_interface_t));
+
+        p_nd->p_interface = p_interface;
+
+        nd_solicit_start(p_nd);
+    }
+    else
+    {
+        err_code = (NRF_ERROR_NO_MEM | IOT_ICMP6_ERR_BASE);
+    }
+
+    ICMP6_TRC("[ICMP6]: << icmp6_nd_start\r\n");
+
+    ICMP6_MUTEX_UNLOCK();
+
+    return err_code;
+}
+
+
+uint32_t icmp6_nd_stop(const iot_interface_t * p_interface)
+{
+    VERIFY_MODULE_IS_INITIALIZED();
+    NULL_PARAM_CHECK(p_interface);
+
+    uint32_t         err_code = (NRF_ERROR_NOT_FOUND | IOT_ICMP6_ERR_BASE);
+    nd_interface_t * p_nd;
+
+    ICMP6_MUTEX_LOCK();
+
+    ICMP6_TRC("[ICMP6]: >> icmp6_nd_stop\r\n");
+
+    p_nd = nd_interface_find(p_interface);
+
+    if (p_nd != NULL)
+    {
+        p_nd->p_interface = NULL;
+        p_nd->state       = ND_STATE_IDLE;
+
+        err_code = NRF_SUCCESS;
+    }
+
+    ICMP6_TRC("[ICMP6]: << icmp6_nd_stop\r\n");
+
+    ICMP6_MUTEX_UNLOCK();
+
+    return err_code;
+}
+
+
+void icmp6_timeout_process(uint32_t wall_clock_value)
+{
+    uint32_t index;
+
+    VERIFY_MODULE_IS_INITIALIZED_VOID();
+
+    ICMP6_MUTEX_LOCK();
+
+    m_nd_now = wall_clock_value;
+
+    for (index = 0; index < IPV6_MAX_INTERFACE; index++)
+    {
+        if (m_nd_interfaces[index].p_interface != NULL)
+        {
+            nd_interface_process(&m_nd_interfaces[index]);
+        }
+    }
+
+    ICMP6_MUTEX_UNLOCK();
+}
+
+#endif // ICMP6_ENABLE_ND_ENGINE
+
+
+void icmp6_interface_delete(const iot_interface_t * p_interface)
+{
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+    UNUSED_VARIABLE(icmp6_nd_stop(p_interface));
+#else
+    UNUSED_PARAMETER(p_interface);
+#endif
+}
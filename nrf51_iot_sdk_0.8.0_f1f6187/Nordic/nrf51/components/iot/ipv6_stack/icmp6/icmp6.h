@@ -58,6 +58,15 @@ uint32_t icmp6_input(iot_interface_t  * p_interface,
                      iot_pbuffer_t    * p_packet);
 
 
+
+/**
+ * @brief  Function to notify the module of a deleted interface, stopping Neighbour Discovery on it.
+ *         To be called by the IPv6 stack only and never by the application.
+ *
+ * @param[in] p_interface Identifies network interface being deleted.
+ */
+void icmp6_interface_delete(const iot_interface_t * p_interface);
+
 #endif //ICMP6_H__
 
 /**@} */
@@ -156,6 +156,53 @@ uint32_t icmp6_ns_send(const iot_interface_t  * p_interface,
  */
 uint32_t icmp6_receive_register(icmp6_receive_callback_t cb);
 
+
+#if (ICMP6_ENABLE_ND_ENGINE == 1)
+
+/**@brief   Starts the host Neighbour Discovery engine on an interface, as defined in RFC6775.
+ *
+ * @details The engine solicits a router, registers the addresses formed from its Prefix Information
+ *          Options with ARO, and keeps router, prefix, context and registration lifetimes. Router
+ *          Solicitations and registrations are sent just before a lifetime expires, and are retried
+ *          with exponential backoff. Context Options carrying the version of the Authoritative Border
+ *          Router Option already applied are not passed to the context manager again.
+ *
+ * @note    Declared only when ICMP6_ENABLE_ND_ENGINE is set to 1 in sdk_config.h. Timing is
+ *          configured with the ICMP6_ND_* parameters. The engine is stopped automatically when the
+ *          interface is deleted.
+ *
+ * @param[in]  p_interface  Pointer to the IPv6 interface.
+ *
+ * @retval NRF_SUCCESS       If the engine was started. The first Router Solicitation is sent at
+ *                           the next call to @ref icmp6_timeout_process.
+ * @retval NRF_ERROR_NO_MEM  If the engine runs on IPV6_MAX_INTERFACE interfaces already.
+ */
+uint32_t icmp6_nd_start(const iot_interface_t * p_interface);
+
+
+/**@brief   Stops the host Neighbour Discovery engine on an interface.
+ *
+ * @details Addresses and contexts learned are kept, but are no longer refreshed or expired.
+ *
+ * @param[in]  p_interface  Pointer to the IPv6 interface.
+ *
+ * @retval NRF_SUCCESS          If the engine was stopped.
+ * @retval NRF_ERROR_NOT_FOUND  If the engine was not running on the interface.
+ */
+uint32_t icmp6_nd_stop(const iot_interface_t * p_interface);
+
+
+/**@brief   Function for performing Neighbour Discovery timing.
+ *
+ * @note    Has to be added to the IoT Timer client list when the Neighbour Discovery engine is used.
+ *          A resolution of one second is sufficient.
+ *
+ * @param[in]  wall_clock_value  The value of the IoT Timer wall clock, in milliseconds.
+ */
+void icmp6_timeout_process(uint32_t wall_clock_value);
+
+#endif // ICMP6_ENABLE_ND_ENGINE
+
 #endif //ICMP6_API_H__
 
 /**@} */
@@ -123,13 +123,18 @@ uint32_t ipv6_address_remove(const iot_interface_t * p_interface,
  * 
  * To find the best matched address, IPV6_ADDR_STATE_PREFERRED state of address is required.
  *
+ * When several interfaces are up, the interface with the longest prefix matching p_addr_f, from 
+ * the routing table or from the on-link prefixes of its addresses, is selected. Link-local 
+ * destinations are matched to the peer of the link. Between equal interfaces, the link with 
+ * more free capacity is selected. The address is then selected from the interface addresses by 
+ * scope and longest matching prefix, as in RFC 6724.
+ *
  * @param[out]     pp_interface Interface to be found.
  * @param[out]     p_addr_r     Best matching address if procedure succeeded and this value was not NULL.
  * @param[inout]   p_addr_f     IPv6 address for which best matching interface and/or address are requested.
  *
  * @retval NRF_SUCCESS              If the operation was successful.
  * @retval NRF_ERROR_NOT_FOUND      If no interface was found.
- * @retval NRF_ERROR_NOT_SUPPORTED  If the operation was not supported.
  */
 uint32_t ipv6_address_find_best_match(iot_interface_t     ** pp_interface,
                                       ipv6_addr_t          * p_addr_r,
@@ -154,6 +159,40 @@ uint32_t ipv6_address_find_best_match(iot_interface_t     ** pp_interface,
  */
 uint32_t ipv6_send(const iot_interface_t * p_interface, iot_pbuffer_t * p_packet);
 
+
+/**@brief Adds a route to specific interface.
+ *
+ * @details API used to route destinations matching a prefix over an interface, for example, 
+ *          the prefixes announced by a border router. A prefix length of 0 adds a default route.
+ *          Routes of an interface are removed when the interface is deleted. The size of the 
+ *          routing table is set by IPV6_MAX_ROUTE_COUNT.
+ *
+ * @param[in]   p_interface The interface over which the prefix is reachable.
+ * @param[in]   p_prefix    Destination prefix.
+ * @param[in]   prefix_len  Prefix length in bits.
+ *
+ * @retval NRF_SUCCESS              If the operation was successful.
+ * @retval NRF_ERROR_INVALID_PARAM  If the interface or prefix length was invalid.
+ * @retval NRF_ERROR_NO_MEM         If the routing table was full.
+ */
+uint32_t ipv6_route_add(const iot_interface_t * p_interface,
+                        const ipv6_addr_t     * p_prefix,
+                        uint8_t                 prefix_len);
+
+
+/**@brief Removes a route from specific interface.
+ *
+ * @param[in]   p_interface The interface of the route.
+ * @param[in]   p_prefix    Destination prefix.
+ * @param[in]   prefix_len  Prefix length in bits.
+ *
+ * @retval NRF_SUCCESS              If the operation was successful.
+ * @retval NRF_ERROR_NOT_FOUND      If no route was found.
+ */
+uint32_t ipv6_route_remove(const iot_interface_t * p_interface,
+                           const ipv6_addr_t     * p_prefix,
+                           uint8_t                 prefix_len);
+
 #endif //IPV6_API_H_
 
 /** @} */
@@ -104,13 +104,34 @@
 
 #define DEST_ADDR_OFFSET               24                                                           /**< Offset of destination address in IPv6 packet. */
 
+#ifndef IPV6_MAX_ROUTE_COUNT
+#define IPV6_MAX_ROUTE_COUNT           4                                                            /**< Maximum number of entries in the routing table. */
+#endif
+
+#define IPV6_INVALID_IF_INDEX          0xFF                                                         /**< Invalid interface representation. */
+#define IPV6_ONLINK_PREFIX_LEN         64                                                           /**< Prefix length of on-link prefixes derived from interface addresses. */
+#define IPV6_NO_MATCH                  (-1)                                                         /**< Interface has no route to the destination. */
+
+#define IPV6_SCOPE_LINK_LOCAL          0x02                                                         /**< Link-local scope. */
+#define IPV6_SCOPE_GLOBAL              0x0E                                                         /**< Global scope. */
+
 /**@brief Internal interface structure. */
 typedef struct
 {
     iot_interface_t  * p_interface;                                                                 /**< Pointer to driver interface */
     uint8_t            addr_range[IPV6_MAX_ADDRESS_PER_INTERFACE];                                  /**< Indices to m_address_table indicating the address. If an index is IPV6_INVALID_ADDR_INDEX, it means there is no address entry. */
+    uint8_t            tx_fail_count;                                                               /**< Number of consecutive send failures, used as the congestion indication of the link. */
+    uint32_t           tx_stamp;                                                                    /**< Value of m_tx_seq at the last send, used for spreading traffic over equal links. */
 } interface_t;
 
+/**@brief Routing table entry. */
+typedef struct
+{
+    ipv6_addr_t        prefix;                                                                      /**< Destination prefix. */
+    uint8_t            prefix_len;                                                                  /**< Prefix length in bits. 0 indicates a default route. */
+    uint8_t            interface_id;                                                                /**< Index of egress interface. IPV6_INVALID_IF_INDEX if the entry is unused. */
+} route_t;
+
 /**@brief Application Event Handler. */
 static ipv6_evt_handler_t m_event_handler = NULL;
 
@@ -123,6 +144,15 @@ static interface_t m_interfaces[IPV6_MAX_INTERFACE];
 /**@brief Number of network interfaces. */
 static uint32_t m_interfaces_count = 0;
 
+/**@brief Routing table. */
+static route_t m_route_table[IPV6_MAX_ROUTE_COUNT];
+
+/**@brief Sequence number of sent packets. */
+static uint32_t m_tx_seq = 0;
+
+/**@brief Number of leading zero bits in a nibble. */
+static const uint8_t m_nibble_clz[16] = {4, 3, 2, 2, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0};
+
 /**@brief Global address for IPv6 any. */
 ipv6_addr_t ipv6_addr_any;
 
@@ -280,7 +310,7 @@ static uint32_t addr_set(const iot_interface_t   * p_interface,
         {
             if (m_interfaces[interface_id].addr_range[index] == addr_index)
             {
-                m_address_table[index].state = p_addr->state;
+                m_address_table[addr_index].state = p_addr->state;
 
                 err_code = NRF_SUCCESS;
                 break;
@@ -295,8 +325,8 @@ static uint32_t addr_set(const iot_interface_t   * p_interface,
             {
                 if (m_interfaces[interface_id].addr_range[index] == IPV6_INVALID_ADDR_INDEX)
                 {
-                    m_address_table[index].state = p_addr->state;
-                    memcpy(&m_address_table[index].addr, p_addr, IPV6_ADDR_SIZE);
+                    m_address_table[addr_index].state = p_addr->state;
+                    memcpy(&m_address_table[addr_index].addr, &p_addr->addr, IPV6_ADDR_SIZE);
                     m_interfaces[interface_id].addr_range[index] = addr_index;
 
                     err_code = NRF_SUCCESS;
@@ -310,58 +340,160 @@ static uint32_t addr_set(const iot_interface_t   * p_interface,
 }
 
 
-/**@brief Function for calculating how many bits of addresses are equal.
+/**@brief Function for calculating the length of the common prefix of two addresses.
+ *
+ * @details Addresses are compared a word at a time. Only the first differing byte is examined
+ *          bit-wise, using a nibble table.
  *
  * @param[in]   p_addr1  Base address.
  * @param[in]   p_addr2  Base address.
  *
- * @return      Number of same bits.
+ * @return      Number of same leading bits.
+ */
+static uint32_t addr_prefix_len(const ipv6_addr_t * p_addr1,
+                                const ipv6_addr_t * p_addr2)
+{
+    uint32_t index = 0;
+    uint8_t  diff;
+
+    while ((index < 4) && (p_addr1->u32[index] == p_addr2->u32[index]))
+    {
+        index++;
+    }
+
+    if (index == 4)
+    {
+        return (IPV6_ADDR_SIZE * 8);
+    }
+
+    index <<= 2;
+
+    while (p_addr1->u8[index] == p_addr2->u8[index])
+    {
+        index++;
+    }
+
+    diff = p_addr1->u8[index] ^ p_addr2->u8[index];
+
+    if (diff & 0xF0)
+    {
+        return ((index << 3) + m_nibble_clz[diff >> 4]);
+    }
+
+    return ((index << 3) + 4 + m_nibble_clz[diff]);
+}
+
+
+/**@brief Function for getting the scope of an address, as defined in RFC 4291.
+ *
+ * @param[in]   p_addr  Checked address.
+ *
+ * @return      Scope value. Unicast addresses other than link-local are of global scope.
+ */
+static uint32_t addr_scope(const ipv6_addr_t * p_addr)
+{
+    if (IPV6_ADDRESS_IS_MULTICAST(p_addr))
+    {
+        return (p_addr->u8[1] & 0x0F);
+    }
+
+    if (IPV6_ADDRESS_IS_LINK_LOCAL(p_addr))
+    {
+        return IPV6_SCOPE_LINK_LOCAL;
+    }
+
+    return IPV6_SCOPE_GLOBAL;
+}
+
+
+/**@brief Function for checking if the interface identifier of an address is the one of a peer.
+ *
+ * @param[in]   p_addr       Checked address.
+ * @param[in]   p_interface  Pointer to driver interface.
+ *
+ * @return      true if the address was formed from the EUI-64 of the peer of the interface.
+ */
+static bool addr_is_peer(const ipv6_addr_t * p_addr, const iot_interface_t * p_interface)
+{
+    return (((p_addr->u8[8] ^ IPV6_IID_FLIP_VALUE) == p_interface->peer_addr.identifier[0]) &&
+            (0 == memcmp(&p_addr->u8[9], &p_interface->peer_addr.identifier[1], EUI_64_ADDR_SIZE - 1)));
+}
+
+
+/**@brief Function for finding the longest prefix over which an interface reaches an address.
+ *
+ * @details Both the routing table and the on-link prefixes of the interface addresses are
+ *          considered.
+ *
+ * @param[in]   interface_id  Index of interface.
+ * @param[in]   p_dest_addr   IPv6 address to be matched.
+ *
+ * @return      Length of the longest matching prefix, IPV6_NO_MATCH if no prefix matched.
  */
-static uint32_t addr_bit_equal(const ipv6_addr_t * p_addr1,
-                               const ipv6_addr_t * p_addr2)
+static int32_t interface_route_match(uint32_t interface_id, const ipv6_addr_t * p_dest_addr)
 {
     uint32_t index;
-    uint32_t match = 0;
-    uint8_t  temp;
-    uint32_t index_tab;
+    uint32_t addr_index;
+    int32_t  match_best = IPV6_NO_MATCH;
 
-    for (index = 0; index < IPV6_ADDR_SIZE; index++)
+    for (index = 0; index < IPV6_MAX_ROUTE_COUNT; index++)
     {
-        if (p_addr1->u8[index] == p_addr2->u8[index])
+        if ((m_route_table[index].interface_id == interface_id)                          &&
+            ((int32_t)m_route_table[index].prefix_len > match_best)                        &&
+            (addr_prefix_len(&m_route_table[index].prefix, p_dest_addr) >= m_route_table[index].prefix_len))
         {
-            // Add full 8bits to match
-            match += 8;
+            match_best = m_route_table[index].prefix_len;
         }
-        else
+    }
+
+    if (match_best < IPV6_ONLINK_PREFIX_LEN)
+    {
+        for (index = 0; index < IPV6_MAX_ADDRESS_PER_INTERFACE; index++)
         {
-            // Operation of XOR to detect differences
-            temp = p_addr1->u8[index] ^ p_addr2->u8[index];
+            addr_index = m_interfaces[interface_id].addr_range[index];
 
-            // Check all single bits
-            for (index_tab = 0; index_tab < 8; index_tab++)
+            if ((addr_index != IPV6_INVALID_ADDR_INDEX)                                        &&
+                !IPV6_ADDRESS_IS_LINK_LOCAL(&m_address_table[addr_index].addr)                 &&
+                (addr_prefix_len(&m_address_table[addr_index].addr, p_dest_addr) >= IPV6_ONLINK_PREFIX_LEN))
             {
-                if ((temp & 0x80) == 0)
-                {
-                    // If the oldest bits matched, add one more.
-                    match++;
-
-                    // Check next bit.
-                    temp = temp << 1;
-                }
-                else
-                {
-                    break;
-                }
+                match_best = IPV6_ONLINK_PREFIX_LEN;
+                break;
             }
-
-            break;
         }
     }
 
-    return match;
+    return match_best;
+}
+
+
+/**@brief Function for checking if an interface has more free capacity than another one.
+ *
+ * @details The link with fewer consecutive send failures is preferred. Between equally loaded
+ *          links, the one used least recently is preferred, so traffic is spread over them.
+ *
+ * @param[in]   p_if1  Candidate interface.
+ * @param[in]   p_if2  Currently selected interface.
+ *
+ * @return      true if p_if1 is preferred over p_if2.
+ */
+static bool interface_less_loaded(const interface_t * p_if1, const interface_t * p_if2)
+{
+    if (p_if1->tx_fail_count != p_if2->tx_fail_count)
+    {
+        return (p_if1->tx_fail_count < p_if2->tx_fail_count);
+    }
+
+    // Wrap-safe comparison of send stamps.
+    return ((int32_t)(p_if1->tx_stamp - p_if2->tx_stamp) < 0);
 }
 
+
 /**@brief Function for searching specific network interface by given address.
+ *
+ * @details A link-local destination is sent over the link to the peer it was formed from. Other
+ *          destinations are sent over the interface with the longest matching prefix in the
+ *          routing table or on-link prefixes. If no prefix matches, every interface is assumed
+ *          to lead to a default router. Ties are broken by the free capacity of the link.
  *
  * @param[in]   p_interface  Pointer to IPv6 network interface.
  * @param[in]   p_dest_addr  IPv6 address to be matched.
@@ -370,35 +502,114 @@ static uint32_t addr_bit_equal(const ipv6_addr_t * p_addr1,
  */
 static uint32_t interface_find(iot_interface_t ** pp_interface, const ipv6_addr_t * p_dest_addr)
 {
-    // Currently only host role is implemented, though no need to match addresses.
-    UNUSED_VARIABLE(p_dest_addr);
-
     uint32_t index;
-    uint32_t err_code = (IOT_IPV6_ERR_BASE | NRF_ERROR_NOT_FOUND);
+    int32_t  match_temp;
+    int32_t  match_best = IPV6_NO_MATCH;
+    uint32_t best_index = IPV6_INVALID_IF_INDEX;
+    bool     link_local = IPV6_ADDRESS_IS_LINK_LOCAL(p_dest_addr);
 
-    if(m_interfaces_count == 1)
+    for (index = 0; index < IPV6_MAX_INTERFACE; index++)
     {
-        for (index = 0; index < IPV6_MAX_INTERFACE; index++)
+        if (m_interfaces[index].p_interface == NULL)
+        {
+            continue;
+        }
+
+        if (m_interfaces_count == 1)
         {
-            if (m_interfaces[index].p_interface != NULL)
+            // Single link, no need to match addresses.
+            best_index = index;
+            break;
+        }
+
+        if (link_local)
+        {
+            if (addr_is_peer(p_dest_addr, m_interfaces[index].p_interface))
             {
-                *pp_interface = m_interfaces[index].p_interface;
-                err_code = NRF_SUCCESS;
+                best_index = index;
                 break;
             }
+
+            match_temp = 0;
+        }
+        else if (IPV6_ADDRESS_IS_MULTICAST(p_dest_addr))
+        {
+            match_temp = 0;
+        }
+        else
+        {
+            match_temp = interface_route_match(index, p_dest_addr);
+        }
+
+        if ((best_index == IPV6_INVALID_IF_INDEX)                                            ||
+            (match_temp > match_best)                                                        ||
+            ((match_temp == match_best) &&
+             interface_less_loaded(&m_interfaces[index], &m_interfaces[best_index])))
+        {
+            match_best = match_temp;
+            best_index = index;
         }
     }
-    else if (m_interfaces_count == 0)
+
+    if (best_index == IPV6_INVALID_IF_INDEX)
     {
-        err_code = (IOT_IPV6_ERR_BASE | NRF_ERROR_NOT_FOUND);
+        return (IOT_IPV6_ERR_BASE | NRF_ERROR_NOT_FOUND);
     }
-    else
+
+    *pp_interface = m_interfaces[best_index].p_interface;
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for removing all routes over an interface.
+ *
+ * @param[in]   interface_id  Index of interface.
+ *
+ * @return      None.
+ */
+static void route_flush(uint32_t interface_id)
+{
+    uint32_t index;
+
+    for (index = 0; index < IPV6_MAX_ROUTE_COUNT; index++)
     {
-        // Not supported now.
-        err_code = (IOT_IPV6_ERR_BASE | NRF_ERROR_NOT_SUPPORTED);
+        if (m_route_table[index].interface_id == interface_id)
+        {
+            m_route_table[index].interface_id = IPV6_INVALID_IF_INDEX;
+        }
     }
+}
 
-    return err_code;
+
+/**@brief Function for finding a route entry.
+ *
+ * @param[in]   interface_id  Index of interface, or IPV6_INVALID_IF_INDEX to find a free entry.
+ * @param[in]   p_prefix      Destination prefix. Not used when looking for a free entry.
+ * @param[in]   prefix_len    Prefix length. Not used when looking for a free entry.
+ *
+ * @return      Index of the entry, IPV6_MAX_ROUTE_COUNT if not found.
+ */
+static uint32_t route_find(uint32_t            interface_id,
+                           const ipv6_addr_t * p_prefix,
+                           uint8_t             prefix_len)
+{
+    uint32_t index;
+
+    for (index = 0; index < IPV6_MAX_ROUTE_COUNT; index++)
+    {
+        if (m_route_table[index].interface_id == interface_id)
+        {
+            if ((interface_id == IPV6_INVALID_IF_INDEX)                                          ||
+                ((m_route_table[index].prefix_len == prefix_len) &&
+                 (addr_prefix_len(&m_route_table[index].prefix, p_prefix) >= prefix_len)))
+            {
+                break;
+            }
+        }
+    }
+
+    return index;
 }
 
 
@@ -413,7 +624,9 @@ static void interface_reset(interface_t * p_interface)
     uint32_t index;
     uint8_t addr_index;
 
-    p_interface->p_interface = NULL;
+    p_interface->p_interface   = NULL;
+    p_interface->tx_fail_count = 0;
+    p_interface->tx_stamp      = 0;
 
     for(index = 0; index < IPV6_MAX_ADDRESS_PER_INTERFACE; index++)
     {
@@ -422,7 +635,7 @@ static void interface_reset(interface_t * p_interface)
         if (addr_index != IPV6_INVALID_ADDR_INDEX)
         {
             p_interface->addr_range[index] = IPV6_INVALID_ADDR_INDEX;
-            addr_free(index, true);
+            addr_free(addr_index, true);
         }
     }
 }
@@ -489,6 +702,7 @@ static uint32_t interface_add(iot_interface_t * p_interface,
  */
 static void interface_delete(uint32_t index)
 {
+    route_flush(index);
     interface_reset(&m_interfaces[index]);
 }
 
@@ -689,6 +903,9 @@ static void ble_6lowpan_evt_handler(iot_interface_t     * p_interface,
                 // Notify application.
                 app_notify_interface_delete(p_interface);
 
+                // Stop Neighbour Discovery on the interface.
+                icmp6_interface_delete(p_interface);
+
                 err_code = iot_context_manager_table_free(p_interface);
 
                 if(err_code == NRF_SUCCESS)
@@ -841,6 +1058,14 @@ uint32_t ipv6_init(const ipv6_init_t * p_init)
         addr_free(index, false);
     }
 
+    // Clear routing table.
+    for(index = 0; index < IPV6_MAX_ROUTE_COUNT; index++)
+    {
+        m_route_table[index].interface_id = IPV6_INVALID_IF_INDEX;
+    }
+
+    m_tx_seq = 0;
+
     // 6LoWPAN module initialization.
     init_params.p_eui64       = p_init->p_eui64;
     init_params.event_handler = ble_6lowpan_evt_handler;
@@ -890,6 +1115,8 @@ uint32_t ipv6_address_find_best_match(iot_interface_t   ** pp_interface,
     uint32_t      index;
     uint32_t      err_code;
     uint32_t      addr_index;
+    uint32_t      scope;
+    uint32_t      dest_scope;
     uint32_t      match_temp  = 0;
     uint32_t      match_best  = 0;
     ipv6_addr_t * p_best_addr = NULL;
@@ -902,6 +1129,10 @@ uint32_t ipv6_address_find_best_match(iot_interface_t   ** pp_interface,
     {
         uint32_t interface_id = (uint32_t)(*pp_interface)->p_upper_stack;
 
+        dest_scope = addr_scope(p_addr_f);
+
+        // Source address selection following RFC 6724: prefer the destination address itself,
+        // then an address of appropriate scope, then the longest matching prefix.
         for(index = 0; index < IPV6_MAX_ADDRESS_PER_INTERFACE; index++)
         {
             addr_index = m_interfaces[interface_id].addr_range[index];
@@ -910,7 +1141,25 @@ uint32_t ipv6_address_find_best_match(iot_interface_t   ** pp_interface,
             {
                 if(m_address_table[addr_index].state == IPV6_ADDR_STATE_PREFERRED)
                 {
-                    match_temp = addr_bit_equal(p_addr_f, &m_address_table[addr_index].addr);
+                    scope      = addr_scope(&m_address_table[addr_index].addr);
+                    match_temp = addr_prefix_len(p_addr_f, &m_address_table[addr_index].addr);
+
+                    if (match_temp == (IPV6_ADDR_SIZE * 8))
+                    {
+                        // Same address.
+                        match_temp |= (1 << 16);
+                    }
+
+                    if (scope >= dest_scope)
+                    {
+                        // Sufficient scope, the smallest one is preferred.
+                        match_temp |= ((0x20 - scope) << 8);
+                    }
+                    else
+                    {
+                        // Too small scope, the largest one is preferred.
+                        match_temp |= (scope << 8);
+                    }
 
                     if(match_temp >= match_best)
                     {
@@ -970,7 +1219,7 @@ uint32_t ipv6_address_remove(const iot_interface_t * p_interface,
                 m_interfaces[interface_id].addr_range[index] = IPV6_INVALID_ADDR_INDEX;
 
                 // Remove address if no reference to interface found.
-                addr_free(index, true);
+                addr_free(addr_index, true);
 
                 err_code = NRF_SUCCESS;
 
@@ -1000,10 +1249,26 @@ uint32_t ipv6_send(const iot_interface_t * p_interface, iot_pbuffer_t * p_packet
 
     IPV6_TRC("[IPV6]: >> ipv6_send\r\n");
 
+    uint32_t interface_id = (uint32_t)p_interface->p_upper_stack;
+
     err_code = ble_6lowpan_interface_send(p_interface,
                                           p_packet->p_payload,
                                           p_packet->length);
 
+    if (interface_id < IPV6_MAX_INTERFACE)
+    {
+        m_interfaces[interface_id].tx_stamp = ++m_tx_seq;
+
+        if (err_code == NRF_SUCCESS)
+        {
+            m_interfaces[interface_id].tx_fail_count = 0;
+        }
+        else if (m_interfaces[interface_id].tx_fail_count < UINT8_MAX)
+        {
+            m_interfaces[interface_id].tx_fail_count++;
+        }
+    }
+
     if(err_code != NRF_SUCCESS)
     {
         IPV6_TRC("[IPV6]: Cannot send packet!\r\n");
@@ -1018,3 +1283,91 @@ uint32_t ipv6_send(const iot_interface_t * p_interface, iot_pbuffer_t * p_packet
 
     return err_code;
 }
+
+
+uint32_t ipv6_route_add(const iot_interface_t * p_interface,
+                        const ipv6_addr_t     * p_prefix,
+                        uint8_t                 prefix_len)
+{
+    VERIFY_MODULE_IS_INITIALIZED();
+
+    NULL_PARAM_CHECK(p_prefix);
+    NULL_PARAM_CHECK(p_interface);
+
+    uint32_t index;
+    uint32_t err_code     = NRF_SUCCESS;
+    uint32_t interface_id = (uint32_t)p_interface->p_upper_stack;
+
+    if ((interface_id >= IPV6_MAX_INTERFACE) || (prefix_len > (IPV6_ADDR_SIZE * 8)))
+    {
+        return (IOT_IPV6_ERR_BASE | NRF_ERROR_INVALID_PARAM);
+    }
+
+    IPV6_MUTEX_LOCK();
+
+    IPV6_TRC("[IPV6]: >> ipv6_route_add\r\n");
+
+    index = route_find(interface_id, p_prefix, prefix_len);
+
+    if (index == IPV6_MAX_ROUTE_COUNT)
+    {
+        index = route_find(IPV6_INVALID_IF_INDEX, NULL, 0);
+    }
+
+    if (index < IPV6_MAX_ROUTE_COUNT)
+    {
+        IPV6_ADDRESS_INITIALIZE(&m_route_table[index].prefix);
+        memcpy(m_route_table[index].prefix.u8, p_prefix->u8, (prefix_len + 7) >> 3);
+
+        m_route_table[index].prefix_len   = prefix_len;
+        m_route_table[index].interface_id = interface_id;
+    }
+    else
+    {
+        err_code = (IOT_IPV6_ERR_BASE | NRF_ERROR_NO_MEM);
+    }
+
+    IPV6_TRC("[IPV6]: << ipv6_route_add\r\n");
+
+    IPV6_MUTEX_UNLOCK();
+
+    return err_code;
+}
+
+
+uint32_t ipv6_route_remove(const iot_interface_t * p_interface,
+                           const ipv6_addr_t     * p_prefix,
+                           uint8_t                 prefix_len)
+{
+    VERIFY_MODULE_IS_INITIALIZED();
+
+    NULL_PARAM_CHECK(p_prefix);
+    NULL_PARAM_CHECK(p_interface);
+
+    uint32_t index;
+    uint32_t err_code     = (IOT_IPV6_ERR_BASE | NRF_ERROR_NOT_FOUND);
+    uint32_t interface_id = (uint32_t)p_interface->p_upper_stack;
+
+    if (interface_id >= IPV6_MAX_INTERFACE)
+    {
+        return err_code;
+    }
+
+    IPV6_MUTEX_LOCK();
+
+    IPV6_TRC("[IPV6]: >> ipv6_route_remove\r\n");
+
+    index = route_find(interface_id, p_prefix, prefix_len);
+
+    if (index < IPV6_MAX_ROUTE_COUNT)
+    {
+        m_route_table[index].interface_id = IPV6_INVALID_IF_INDEX;
+        err_code = NRF_SUCCESS;
+    }
+
+    IPV6_TRC("[IPV6]: << ipv6_route_remove\r\n");
+
+    IPV6_MUTEX_UNLOCK();
+
+    return err_code;
+}
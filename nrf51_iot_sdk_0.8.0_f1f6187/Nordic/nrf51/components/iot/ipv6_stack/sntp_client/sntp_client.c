@@ -90,6 +90,13 @@
 #define TIME_AT_1970          2208988800UL  // Number of seconds between 1st Jan 1900 and 1st Jan 1970, for NTP<->Unix time conversion. 
 #define PROTOCOL_MODE_SERVER             4
 
+#define NTP_TIME_SECOND       (1ULL << 32)  /**< One second in NTP timestamp format (32-bit seconds, 32-bit fraction). */
+#define FREQ_PPB_PER_PPM      1000          /**< Parts per billion in one part per million. */
+#define POLL_STABLE_COUNT     4             /**< Number of consecutive small offsets after which the poll interval is doubled. */
+#define DELAY_SPIKE_FACTOR    4             /**< Responses with a round-trip delay larger than this times the minimum delay seen are not used for frequency estimation. */
+#define KOD_CODE_DENY         0x44454E59UL  /**< Kiss code "DENY", access denied by the server. */
+#define KOD_CODE_RSTR         0x52535452UL  /**< Kiss code "RSTR", access restricted by the server. */
+
 /**@brief NTP Header Format. */
 typedef struct
 {
@@ -113,12 +120,33 @@ typedef enum
     SNTP_CLIENT_STATE_BUSY
 } sntp_client_state_t;
 
+/**@brief Local clock model.
+ *
+ * @details The local time is the NTP time at the reference wall clock value, plus the wall clock
+ *          time elapsed since, corrected by the estimated frequency error of the wall clock.
+ */
 typedef struct
 {
-    time_t                   unix_time;
-    iot_timer_time_in_ms_t   wall_clock_value;
+    uint64_t                 ntp_time;              /**< NTP time at the reference, 32-bit seconds and 32-bit fraction. */
+    iot_timer_time_in_ms_t   wall_clock_value;      /**< Wall clock value at the reference. */
+    int32_t                  freq_ppb;              /**< Frequency correction of the wall clock in parts per billion. */
 } local_timestamp_t;
 
+/**@brief Clock discipline state. */
+typedef struct
+{
+    bool                     synchronized;          /**< Indicates if the local time was set from a server. */
+    bool                     freq_valid;            /**< Indicates if the frequency correction has been measured. */
+    bool                     polling;               /**< Indicates if the module queries the server on its own. */
+    uint8_t                  stable_count;          /**< Number of consecutive offsets below SNTP_POLL_ADJUST_THRESHOLD_MS. */
+    uint32_t                 poll_interval;         /**< Current poll interval in seconds. */
+    iot_timer_time_in_ms_t   time_of_last_poll;     /**< Wall clock value when the last poll was started. */
+    iot_timer_time_in_ms_t   time_of_last_sync;     /**< Wall clock value of the last update of the local time. */
+    uint64_t                 originate_time;        /**< Local NTP time sent in the last query. */
+    uint32_t                 delay_min_us;          /**< Smallest round-trip delay seen, in microseconds. */
+    sntp_client_discipline_status_t status;         /**< Status reported to the application. */
+} discipline_t;
+
 SDK_MUTEX_DEFINE(m_sntp_c_mutex)                                                                  /**< Mutex variable. Currently unused, this declaration does not occupy any space in RAM. */
 static sntp_client_state_t      m_sntp_client_state = SNTP_CLIENT_STATE_UNINITIALIZED;
 static ipv6_addr_t            * m_p_ntp_server_address;
@@ -129,6 +157,192 @@ static uint8_t                  m_retransmission_count;
 static sntp_evt_handler_t       m_app_evt_handler;
 static udp6_socket_t            m_udp_socket;
 static local_timestamp_t        m_local_time;
+static discipline_t             m_discipline;
+
+/**@brief Function for converting milliseconds to NTP timestamp format. */
+static uint64_t ms_to_ntp_time(uint32_t ms)
+{
+    return (((uint64_t)(ms / 1000)) << 32) + ((((uint64_t)(ms % 1000)) << 32) / 1000);
+}
+
+
+/**@brief Function for converting a signed NTP time difference to microseconds. */
+static int64_t ntp_time_to_us(int64_t ntp_time)
+{
+    int64_t seconds = ntp_time / (int64_t)NTP_TIME_SECOND;
+    int64_t fraction = ntp_time % (int64_t)NTP_TIME_SECOND;
+
+    return (seconds * 1000000) + ((fraction * 1000000) / (int64_t)NTP_TIME_SECOND);
+}
+
+
+/**@brief Function for reading a timestamp from an NTP header field. */
+static uint64_t ntp_timestamp_read(const uint32_t * p_field)
+{
+    return (((uint64_t)HTONL(p_field[0])) << 32) | HTONL(p_field[1]);
+}
+
+
+/**@brief Function for getting the local time in NTP timestamp format.
+ *
+ * @param[out] p_ntp_time          Local NTP time.
+ * @param[out] p_wall_clock_value  Wall clock value the local time was computed for. Can be NULL.
+ */
+static uint32_t local_ntp_time_get(uint64_t * p_ntp_time, iot_timer_time_in_ms_t * p_wall_clock_value)
+{
+    uint32_t               err_code;
+    iot_timer_time_in_ms_t delta_ms;
+    int64_t                correction_ns;
+
+    err_code = iot_timer_wall_clock_delta_get(&m_local_time.wall_clock_value, &delta_ms);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Frequency correction of the elapsed time, 1 ms at 1 ppb is 1 ps.
+    correction_ns = ((int64_t)delta_ms * m_local_time.freq_ppb) / 1000;
+
+    *p_ntp_time = m_local_time.ntp_time + ms_to_ntp_time(delta_ms);
+    *p_ntp_time += (correction_ns / 1000000000) * (int64_t)NTP_TIME_SECOND;
+    *p_ntp_time += ((correction_ns % 1000000000) * (int64_t)NTP_TIME_SECOND) / 1000000000;
+
+    if (p_wall_clock_value != NULL)
+    {
+        *p_wall_clock_value = m_local_time.wall_clock_value + delta_ms;
+    }
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for updating the local clock from the four timestamps of an NTP exchange.
+ *
+ * @details Offset and round-trip delay are computed as in RFC 4330. The local time is set to the
+ *          corrected time. If the offset is below @ref SNTP_STEP_THRESHOLD_MS, it is taken as
+ *          the error accumulated since the previous update, and used for correcting the frequency
+ *          estimate of the wall clock. The poll interval is doubled after a number of small offsets
+ *          in a row, and halved when the offset is large.
+ *
+ * @param[in] p_ntp_header  NTP response to the last query.
+ *
+ * @retval NRF_SUCCESS  Local time updated.
+ */
+static uint32_t local_time_discipline(const ntp_header_t * p_ntp_header)
+{
+    uint32_t               err_code;
+    uint64_t               t1 = ntp_timestamp_read(p_ntp_header->originate_timestamp);
+    uint64_t               t2 = ntp_timestamp_read(p_ntp_header->receive_timestamp);
+    uint64_t               t3 = ntp_timestamp_read(p_ntp_header->transmit_timestamp);
+    uint64_t               t4;
+    iot_timer_time_in_ms_t wall_clock_value;
+    iot_timer_time_in_ms_t interval_ms;
+    int64_t                offset;
+    int64_t                delay;
+    int64_t                offset_us;
+    bool                   step;
+
+    err_code = local_ntp_time_get(&t4, &wall_clock_value);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    // Halve each difference first, the first offset after startup spans more than a century.
+    offset = ((int64_t)(t2 - t1) / 2) + ((int64_t)(t3 - t4) / 2);
+    delay  = (int64_t)(t4 - t1) - (int64_t)(t3 - t2);
+
+    if (delay < 0)
+    {
+        delay = 0;
+    }
+
+    offset_us = ntp_time_to_us(offset);
+    step      = (!m_discipline.synchronized) ||
+                (offset_us >  ((int64_t)SNTP_STEP_THRESHOLD_MS * 1000)) ||
+                (offset_us < -((int64_t)SNTP_STEP_THRESHOLD_MS * 1000));
+
+    m_discipline.status.offset_us = offset_us;
+    m_discipline.status.delay_us  = (uint32_t)ntp_time_to_us(delay);
+
+    if ((m_discipline.delay_min_us == 0) || (m_discipline.status.delay_us < m_discipline.delay_min_us))
+    {
+        m_discipline.delay_min_us = m_discipline.status.delay_us;
+    }
+
+    if (step)
+    {
+        SNTP_TRC("[SNTP]: Stepping local time.\r\n");
+
+        m_discipline.poll_interval = SNTP_POLL_INTERVAL_MIN;
+        m_discipline.stable_count  = 0;
+    }
+    else
+    {
+        UNUSED_VARIABLE(iot_timer_wall_clock_delta_get(&m_discipline.time_of_last_sync, &interval_ms));
+
+        // The offset is the error accumulated since the last update. Skip frequency correction
+        // for short intervals and for delay spikes, where the offset is mostly jitter.
+        if ((interval_ms >= SEC_TO_MILLISEC(SNTP_POLL_INTERVAL_MIN) / 2) &&
+            (m_discipline.status.delay_us <= (DELAY_SPIKE_FACTOR * m_discipline.delay_min_us)))
+        {
+            int64_t freq_ppb = m_local_time.freq_ppb;
+            int64_t error_ppb = (offset_us * 1000000) / (int64_t)interval_ms;
+
+            freq_ppb += m_discipline.freq_valid ? (error_ppb / 2) : error_ppb;
+
+            if (freq_ppb > (SNTP_FREQ_MAX_PPM * FREQ_PPB_PER_PPM))
+            {
+                freq_ppb = SNTP_FREQ_MAX_PPM * FREQ_PPB_PER_PPM;
+            }
+            else if (freq_ppb < -(SNTP_FREQ_MAX_PPM * FREQ_PPB_PER_PPM))
+            {
+                freq_ppb = -(SNTP_FREQ_MAX_PPM * FREQ_PPB_PER_PPM);
+            }
+
+            m_local_time.freq_ppb   = (int32_t)freq_ppb;
+            m_discipline.freq_valid = true;
+        }
+
+        if ((offset_us <  ((int64_t)SNTP_POLL_ADJUST_THRESHOLD_MS * 1000)) &&
+            (offset_us > -((int64_t)SNTP_POLL_ADJUST_THRESHOLD_MS * 1000)))
+        {
+            if (++m_discipline.stable_count >= POLL_STABLE_COUNT)
+            {
+                m_discipline.stable_count = 0;
+                if (m_discipline.poll_interval < SNTP_POLL_INTERVAL_MAX)
+                {
+                    m_discipline.poll_interval *= 2;
+                }
+            }
+        }
+        else
+        {
+            m_discipline.stable_count = 0;
+            if (m_discipline.poll_interval > SNTP_POLL_INTERVAL_MIN)
+            {
+                m_discipline.poll_interval /= 2;
+            }
+        }
+    }
+
+    m_local_time.ntp_time         = t4 + offset;
+    m_local_time.wall_clock_value = wall_clock_value;
+    m_discipline.time_of_last_sync = wall_clock_value;
+    m_discipline.synchronized     = true;
+
+    m_discipline.status.freq_ppb      = m_local_time.freq_ppb;
+    m_discipline.status.poll_interval = m_discipline.poll_interval;
+
+    SNTP_TRC("[SNTP]: Offset %ld us, delay %lu us, frequency %ld ppb, poll %lu s.\r\n",
+             (int32_t)offset_us,
+             m_discipline.status.delay_us,
+             m_local_time.freq_ppb,
+             m_discipline.poll_interval);
+
+    return NRF_SUCCESS;
+}
+
 
 /**@brief Function for checking if a received NTP packet is valid.
  *
@@ -149,6 +363,52 @@ static bool is_response_valid(ntp_header_t * p_ntp_response)
 }
 
 
+/**@brief Function for checking if a received NTP packet answers the last query.
+ *
+ * @details The server copies the transmit timestamp of the query to the originate timestamp of
+ *          the response. Responses to earlier queries, duplicates and forged packets do not match.
+ *
+ * @param[in] p_ntp_response Pointer to the NTP packet header.
+ */
+static bool is_response_to_last_query(ntp_header_t * p_ntp_response)
+{
+    return (ntp_timestamp_read(p_ntp_response->originate_timestamp) == m_discipline.originate_time);
+}
+
+
+/**@brief Function for backing off polling after a Kiss-o'-Death packet.
+ *
+ * @details Polling stops on DENY and RSTR, as RFC 4330 requires. On any other kiss code, such as
+ *          RATE, the poll interval is set to @ref SNTP_POLL_INTERVAL_MAX and the next poll is
+ *          scheduled from now.
+ *
+ * @param[in] kiss_code Kiss code from the reference identifier field, in network byte order.
+ */
+static void kod_backoff(uint32_t kiss_code)
+{
+    if (!m_discipline.polling)
+    {
+        return;
+    }
+
+    if ((HTONL(kiss_code) == KOD_CODE_DENY) || (HTONL(kiss_code) == KOD_CODE_RSTR))
+    {
+        SNTP_TRC("[SNTP]: Server denied access, polling stopped.\r\n");
+
+        m_discipline.polling = false;
+    }
+    else
+    {
+        m_discipline.poll_interval = SNTP_POLL_INTERVAL_MAX;
+        m_discipline.stable_count  = 0;
+
+        UNUSED_VARIABLE(iot_timer_wall_clock_get(&m_discipline.time_of_last_poll));
+    }
+
+    m_discipline.status.poll_interval = m_discipline.poll_interval;
+}
+
+
 /**@brief Callback handler to receive data on the UDP port.
  *
  * @param[in]   p_socket         Socket identifier.
@@ -206,6 +466,17 @@ static uint32_t port_data_callback(const udp6_socket_t * p_socket,
             SNTP_TRC("[SNTP]: << ntp_server_response\r\n");
             return err_code;
         }
+        else if (!is_response_to_last_query(p_ntp_header))
+        {
+            // Discard silently, the response to the last query may still arrive before the
+            // retransmission timer expires.
+            SNTP_ERR("[SNTP]: Response does not match the last query, discarded.\r\n");
+
+            SNTP_C_MUTEX_UNLOCK();
+
+            SNTP_TRC("[SNTP]: << ntp_server_response\r\n");
+            return NRF_SUCCESS;
+        }
         else
         {
             if (!is_response_valid(p_ntp_header))
@@ -241,6 +512,8 @@ static uint32_t port_data_callback(const udp6_socket_t * p_socket,
                     m_retransmission_count = 0;
                     m_do_sync_local_time   = false;
 
+                    kod_backoff(p_ntp_header->reference_id);
+
                     SNTP_C_MUTEX_UNLOCK();
 
                     if (m_app_evt_handler != NULL)
@@ -262,10 +535,7 @@ static uint32_t port_data_callback(const udp6_socket_t * p_socket,
                     
                     if (m_do_sync_local_time)
                     {
-                        iot_timer_time_in_ms_t wall_clock_value;
-                        UNUSED_VARIABLE(iot_timer_wall_clock_get(&wall_clock_value));
-                        m_local_time.unix_time        = time_from_response;
-                        m_local_time.wall_clock_value = wall_clock_value;
+                        err_code = local_time_discipline(p_ntp_header);
                         m_do_sync_local_time = false;
                     }
 
@@ -278,13 +548,13 @@ static uint32_t port_data_callback(const udp6_socket_t * p_socket,
                     {
                         m_app_evt_handler(&(p_ip_header->srcaddr),                      \
                                           p_udp_header->srcport,                        \
-                                          NRF_SUCCESS,                                  \
+                                          err_code,                                     \
                                           (sntp_client_cb_param_t){ .time_from_server = \
                                                                         time_from_response });
                     }
 
                     SNTP_TRC("[SNTP]: << ntp_server_response\r\n");
-                    return NRF_SUCCESS;
+                    return err_code;
                 }
             }
         }
@@ -305,6 +575,9 @@ uint32_t sntp_client_init(const sntp_client_init_param_t * p_sntp_client_init_pa
     uint32_t err_code;
 
     memset(&m_local_time, 0x00, sizeof(m_local_time));
+    memset(&m_discipline, 0x00, sizeof(m_discipline));
+    m_local_time.ntp_time      = ((uint64_t)TIME_AT_1970) << 32;
+    m_discipline.poll_interval = SNTP_POLL_INTERVAL_MIN;
     m_app_evt_handler = p_sntp_client_init_param->app_evt_handler;
 
     //Request new socket creation.
@@ -343,15 +616,16 @@ uint32_t sntp_client_init(const sntp_client_init_param_t * p_sntp_client_init_pa
 
 static uint32_t local_time_get(time_t * p_local_time)
 {
-    uint32_t err_code = NRF_SUCCESS;
-    iot_timer_time_in_ms_t delta_ms;
-    err_code = iot_timer_wall_clock_delta_get(&m_local_time.wall_clock_value, &delta_ms);
+    uint32_t err_code;
+    uint64_t ntp_time;
+
+    err_code = local_ntp_time_get(&ntp_time, NULL);
     if (err_code != NRF_SUCCESS)
     {
         return err_code;
     }
 
-    *p_local_time = m_local_time.unix_time + (delta_ms / 1000);
+    *p_local_time = (time_t)((ntp_time >> 32) - TIME_AT_1970);
 
     return err_code;
 }
@@ -378,6 +652,45 @@ uint32_t sntp_client_local_time_get(time_t * p_current_time)
 }
 
 
+uint32_t sntp_client_local_time_precise_get(time_t * p_current_time, uint32_t * p_fraction)
+{
+    VERIFY_MODULE_IS_INITIALIZED();
+    NULL_PARAM_CHECK(p_current_time);
+    NULL_PARAM_CHECK(p_fraction);
+
+    uint32_t err_code;
+    uint64_t ntp_time;
+
+    SNTP_C_MUTEX_LOCK();
+
+    err_code = local_ntp_time_get(&ntp_time, NULL);
+    if (err_code == NRF_SUCCESS)
+    {
+        *p_current_time = (time_t)((ntp_time >> 32) - TIME_AT_1970);
+        *p_fraction     = (uint32_t)ntp_time;
+    }
+
+    SNTP_C_MUTEX_UNLOCK();
+
+    return err_code;
+}
+
+
+uint32_t sntp_client_discipline_status_get(sntp_client_discipline_status_t * p_status)
+{
+    VERIFY_MODULE_IS_INITIALIZED();
+    NULL_PARAM_CHECK(p_status);
+
+    SNTP_C_MUTEX_LOCK();
+
+    *p_status = m_discipline.status;
+
+    SNTP_C_MUTEX_UNLOCK();
+
+    return NRF_SUCCESS;
+}
+
+
 /**@brief Function for sending SNTP query.
  *
  * @retval NRF_SUCCESS on successful execution of procedure, otherwise an error code indicating reason
@@ -388,9 +701,9 @@ static uint32_t sntp_query_send()
     uint32_t                    err_code;
     iot_pbuffer_t             * p_buffer;
     iot_pbuffer_alloc_param_t   buffer_param;
-    time_t                      current_local_time;
+    uint64_t                    current_local_time;
 
-    err_code = local_time_get(&current_local_time);
+    err_code = local_ntp_time_get(&current_local_time, NULL);
     if (err_code != NRF_SUCCESS)
     {
         SNTP_TRC("[SNTP]: An error occured while getting local time value. \r\n");
@@ -413,7 +726,10 @@ static uint32_t sntp_query_send()
 
         // Fill NTP header fields.
         p_ntp_header->flags                 = 0x1B; // LI = 0; VN = 3; Mode = 3
-        p_ntp_header->transmit_timestamp[0] = HTONL((uint32_t)(current_local_time  + TIME_AT_1970));
+        p_ntp_header->transmit_timestamp[0] = HTONL((uint32_t)(current_local_time >> 32));
+        p_ntp_header->transmit_timestamp[1] = HTONL((uint32_t)current_local_time);
+
+        m_discipline.originate_time = current_local_time;
 
         // Send NTP query using UDP socket.
         err_code = udp6_socket_sendto(&m_udp_socket,          \
@@ -474,6 +790,77 @@ uint32_t sntp_client_server_query(ipv6_addr_t * p_ntp_server_address, \
 }
 
 
+uint32_t sntp_client_discipline_start(ipv6_addr_t * p_ntp_server_address, \
+                                      uint16_t      ntp_server_udp_port)
+{
+    VERIFY_MODULE_IS_INITIALIZED();
+    NULL_PARAM_CHECK(p_ntp_server_address);
+    ZERO_PARAM_CHECK(ntp_server_udp_port);
+
+    uint32_t err_code = NRF_SUCCESS;
+
+    SNTP_TRC("[SNTP]: >> sntp_client_discipline_start\r\n");
+
+    SNTP_C_MUTEX_LOCK();
+
+    if (m_sntp_client_state != SNTP_CLIENT_STATE_IDLE)
+    {
+        err_code = (NRF_ERROR_BUSY | IOT_NTP_ERR_BASE);
+    }
+    else
+    {
+        m_p_ntp_server_address = p_ntp_server_address;
+        m_ntp_server_port      = ntp_server_udp_port;
+        m_do_sync_local_time   = true;
+        m_discipline.polling   = true;
+
+        UNUSED_VARIABLE(iot_timer_wall_clock_get(&m_discipline.time_of_last_poll));
+
+        err_code = sntp_query_send();
+        if (err_code == NRF_SUCCESS)
+        {
+            m_sntp_client_state = SNTP_CLIENT_STATE_BUSY;
+        }
+    }
+
+    SNTP_TRC("[SNTP]: << sntp_client_discipline_start\r\n");
+
+    SNTP_C_MUTEX_UNLOCK();
+
+    return err_code;
+}
+
+
+uint32_t sntp_client_discipline_stop(void)
+{
+    VERIFY_MODULE_IS_INITIALIZED();
+
+    SNTP_C_MUTEX_LOCK();
+
+    m_discipline.polling = false;
+
+    SNTP_C_MUTEX_UNLOCK();
+
+    return NRF_SUCCESS;
+}
+
+
+/**@brief Function for determining whether it is time to poll the server.
+ *
+ */
+static bool is_it_time_to_poll()
+{
+    iot_timer_time_in_ms_t delta_ms = 0;
+
+    if (iot_timer_wall_clock_delta_get(&m_discipline.time_of_last_poll, &delta_ms) != NRF_SUCCESS)
+    {
+        return true;
+    }
+
+    return (delta_ms >= SEC_TO_MILLISEC(m_discipline.poll_interval));
+}
+
+
 /**@brief Function for determining whether it is time to retransmit a query.
  *
  */
@@ -514,6 +901,11 @@ void sntp_client_timeout_process(iot_timer_time_in_ms_t wall_clock_value)
                 m_sntp_client_state    = SNTP_CLIENT_STATE_IDLE;
                 m_retransmission_count = 0;
                 m_do_sync_local_time   = false;
+
+                if (m_discipline.poll_interval > SNTP_POLL_INTERVAL_MIN)
+                {
+                    m_discipline.poll_interval /= 2;
+                }
                 
                 SNTP_C_MUTEX_UNLOCK();
 
@@ -535,6 +927,21 @@ void sntp_client_timeout_process(iot_timer_time_in_ms_t wall_clock_value)
             }
         }
     }
+    else if ((m_sntp_client_state == SNTP_CLIENT_STATE_IDLE) && m_discipline.polling)
+    {
+        if (is_it_time_to_poll())
+        {
+            SNTP_TRC("[SNTP]: Polling server, interval %lu s.\r\n", m_discipline.poll_interval);
+
+            UNUSED_VARIABLE(iot_timer_wall_clock_get(&m_discipline.time_of_last_poll));
+
+            m_do_sync_local_time = true;
+            if (sntp_query_send() == NRF_SUCCESS)
+            {
+                m_sntp_client_state = SNTP_CLIENT_STATE_BUSY;
+            }
+        }
+    }
 
     SNTP_C_MUTEX_UNLOCK();
     return;
@@ -555,6 +962,7 @@ uint32_t sntp_client_uninitialize()
     m_sntp_client_state    = SNTP_CLIENT_STATE_UNINITIALIZED;
     m_retransmission_count = 0;
     m_do_sync_local_time   = false;
+    m_discipline.polling   = false;
 
     SNTP_TRC("[SNTP]: << sntp_client_uninitialize\r\n");
 
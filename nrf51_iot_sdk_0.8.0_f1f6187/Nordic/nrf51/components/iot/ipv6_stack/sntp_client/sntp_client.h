@@ -20,6 +20,13 @@
  * @details Concurrent queries are not supported. Exponential-backoff algorithm for 
  *          retransmissions is not implemented, retransmissions are triggered at regular intervals. 
  *
+ *          Responses used for synchronizing the local time are compensated for the round-trip
+ *          delay, using the four timestamps of the exchange. The local time is kept in NTP
+ *          timestamp format and the frequency error of the IoT Timer wall clock is estimated from
+ *          the offsets measured across queries. With @ref sntp_client_discipline_start, the module
+ *          polls the server on its own, lengthening the poll interval from
+ *          @ref SNTP_POLL_INTERVAL_MIN up to @ref SNTP_POLL_INTERVAL_MAX as the local clock settles.
+ *
  */
 
 #ifndef SNTP_CLIENT_H__
@@ -70,6 +77,15 @@ typedef void (*sntp_evt_handler_t)(const ipv6_addr_t      * p_ntp_srv_addr,
                                    uint32_t                 process_result,      \
                                    sntp_client_cb_param_t   callback_parameter);
 
+/**@brief Clock discipline status. */
+typedef struct
+{
+    int64_t  offset_us;          /**< Offset of the local clock measured by the last response, in microseconds. Positive if the local clock was behind. */
+    uint32_t delay_us;           /**< Round-trip delay of the last response, in microseconds. */
+    int32_t  freq_ppb;           /**< Estimated frequency correction of the wall clock, in parts per billion. */
+    uint32_t poll_interval;      /**< Current poll interval, in seconds. */
+} sntp_client_discipline_status_t;
+
 /**@brief SNTP client initialization structure. 
  *
  * @note  @ref app_evt_handler can be set to zero to disable callbacks. 
@@ -149,9 +165,75 @@ uint32_t sntp_client_server_query(ipv6_addr_t * p_ntp_server_address, \
  */
 uint32_t sntp_client_local_time_get(time_t * p_current_time);
 
+/**@brief Function for getting the local unix time from the module, with the fraction of the
+ *        current second.
+ *
+ * @details The accuracy of the output is depending on the wall clock resolution of the IoT Timer
+ *          module and on the round-trip delay variation to the NTP server.
+ *
+ * @param[out] p_current_time  Local unix time.
+ * @param[out] p_fraction      Fraction of the current second, in units of 2^-32 seconds.
+ *
+ * @retval NRF_SUCCESS                    Getting locally stored unix time successful.
+ * @retval SDK_ERR_MODULE_NOT_INITIALZED  The module was not initialized.
+ * @retval NRF_ERROR_NULL                 If @b p_current_time or @b p_fraction is a NULL pointer.
+ *
+ */
+uint32_t sntp_client_local_time_precise_get(time_t * p_current_time, uint32_t * p_fraction);
+
+/**@brief Function for starting periodic synchronization of the local time with an NTP server.
+ *
+ * @details A query is sent immediately. Further queries are sent from
+ *          @ref sntp_client_timeout_process at the poll interval, which starts at
+ *          @ref SNTP_POLL_INTERVAL_MIN. It is doubled after several responses in a row show an
+ *          offset below @ref SNTP_POLL_ADJUST_THRESHOLD_MS, up to @ref SNTP_POLL_INTERVAL_MAX, and
+ *          halved on larger offsets or if the server does not respond. A Kiss-o'-Death response
+ *          sets it to @ref SNTP_POLL_INTERVAL_MAX, or stops polling if the kiss code is DENY or
+ *          RSTR. Every response is reported to the event handler, as for
+ *          @ref sntp_client_server_query. Responses that do not answer the last query are
+ *          discarded without an event.
+ *
+ * @param[in] p_ntp_server_address  Pointer to the IPv6 address of the NTP server. This memory must
+ *                                  be resident until @ref sntp_client_discipline_stop is called.
+ * @param[in] ntp_server_udp_port   Destination port of the NTP server.
+ *
+ * @retval NRF_SUCCESS                    First query successfully sent.
+ * @retval SDK_ERR_MODULE_NOT_INITIALZED  The module was not initialized.
+ * @retval NRF_ERROR_NULL                 If @b p_ntp_server_address or @b ntp_server_udp_port
+ *                                        is a NULL pointer.
+ * @retval NRF_ERROR_BUSY                 A query is in progress.
+ *
+ */
+uint32_t sntp_client_discipline_start(ipv6_addr_t * p_ntp_server_address, \
+                                      uint16_t      ntp_server_udp_port);
+
+/**@brief Function for stopping periodic synchronization of the local time.
+ *
+ * @details A query in progress is completed. The local time keeps running with the last frequency
+ *          correction.
+ *
+ * @retval NRF_SUCCESS                    Periodic synchronization stopped.
+ * @retval SDK_ERR_MODULE_NOT_INITIALZED  The module was not initialized.
+ *
+ */
+uint32_t sntp_client_discipline_stop(void);
+
+/**@brief Function for getting the clock discipline status.
+ *
+ * @param[out] p_status  Offset and delay of the last response, frequency correction and poll
+ *                       interval.
+ *
+ * @retval NRF_SUCCESS                    Status successfully read.
+ * @retval SDK_ERR_MODULE_NOT_INITIALZED  The module was not initialized.
+ * @retval NRF_ERROR_NULL                 If @b p_status is a NULL pointer.
+ *
+ */
+uint32_t sntp_client_discipline_status_get(sntp_client_discipline_status_t * p_status);
+
 /**@brief Function for performing retransmissions of SNTP queries.
  *
- * @details The SNTP client module implements the retransmission mechanism by invoking this 
+ * @details The SNTP client module implements the retransmission mechanism, and the periodic
+ *          queries started by @ref sntp_client_discipline_start, by invoking this 
  *          function periodically. This procedure is to be added to the IoT Timer client list 
  *          and has to be called repeatedly with a minimum period of SNTP_RETRANSMISSION_INTERVAL.
  *
@@ -98,6 +98,7 @@ static uint32_t m_buffer[MAX_BUFFER_SIZE];
 static uint32_t m_buffer_len;
 static uint8_t m_dtls_state;
 static uint8_t m_dtls_role = COAP_DTLS_UNASSIGNED;
+static iot_pbuffer_t * mp_tx_buffer;                       /**< Packet buffer in which tinydtls builds the record being written by @ref secure_write, NULL otherwise. */
             
 int random_vector_generate(unsigned char * p_buffer, size_t size)
 {
@@ -186,11 +187,40 @@ static uint32_t port_data_callback(const udp6_socket_t * p_socket,
 }
 
 
-uint32_t port_write(const uint8_t * p_remote_addr, uint16_t port, uint32_t index, const uint8_t * p_data, uint16_t datalen)
+/**@brief Sends a packet buffer on the port at index in m_port_table.
+ *
+ * @details The packet buffer is freed if sending fails.
+ */
+static uint32_t port_send(const uint8_t * p_remote_addr, uint16_t port, uint32_t index, iot_pbuffer_t * p_buffer)
 {
     uint32_t                       err_code;
     udp6_socket_t                  socket;
     ipv6_addr_t                    remote_addr;
+
+    memcpy(remote_addr.u8, p_remote_addr, IPV6_ADDR_SIZE);
+
+    socket.socket_id = m_port_table[index].socket_id;
+
+    //Send on UDP port.
+    err_code = udp6_socket_sendto(&socket,
+                                  &remote_addr,
+                                  port,
+                                  p_buffer);
+
+    COAP_TRANSPORT_TRC("[CoAP-DTLS]: port_send->udp6_socket_sendto result 0x%08X \r\n", err_code);
+    if(err_code != NRF_SUCCESS)
+    {
+        //Free the allocated buffer as send procedure has failed.
+        UNUSED_VARIABLE(iot_pbuffer_free(p_buffer, true));
+    }
+
+    return err_code;
+}
+
+
+uint32_t port_write(const uint8_t * p_remote_addr, uint16_t port, uint32_t index, const uint8_t * p_data, uint16_t datalen)
+{
+    uint32_t                       err_code;
     iot_pbuffer_t                * p_buffer;
     iot_pbuffer_alloc_param_t      buffer_param;
     
@@ -200,8 +230,6 @@ uint32_t port_write(const uint8_t * p_remote_addr, uint16_t port, uint32_t index
     
     COAP_TRANSPORT_TRC("[CoAP-DTLS]: port_write, datalen %d \r\n", datalen);
     
-    memcpy(remote_addr.u8, p_remote_addr, IPV6_ADDR_SIZE);
-    
     //Allocate buffer to send the data on port.
     err_code = iot_pbuffer_allocate(&buffer_param, &p_buffer);  
 
@@ -209,23 +237,10 @@ uint32_t port_write(const uint8_t * p_remote_addr, uint16_t port, uint32_t index
 
     if(err_code == NRF_SUCCESS)
     {
-        socket.socket_id = m_port_table[index].socket_id;
-        
         //Make a copy of the data onto the buffer.
         memcpy (p_buffer->p_payload, p_data, datalen);
 
-        //Send on UDP port.
-        err_code = udp6_socket_sendto(&socket,
-                                      &remote_addr,
-                                      port,
-                                      p_buffer);
-
-        COAP_TRANSPORT_TRC("[CoAP-DTLS]: port_write->udp6_socket_sendto result 0x%08X \r\n", err_code);
-        if(err_code != NRF_SUCCESS)
-        {
-            //Free the allocated buffer as send procedure has failed.
-            UNUSED_VARIABLE(iot_pbuffer_free(p_buffer, true));
-        }
+        err_code = port_send(p_remote_addr, port, index, p_buffer);
     }
     
     return err_code;
@@ -234,6 +249,24 @@ uint32_t port_write(const uint8_t * p_remote_addr, uint16_t port, uint32_t index
 
 int dtls_transport_write(struct dtls_context_t *ctx, session_t *session, uint8 *buf, size_t len)
 {
+    iot_pbuffer_t * p_buffer = mp_tx_buffer;
+
+    if ((p_buffer != NULL) &&
+        (buf >= p_buffer->p_payload) &&
+        (buf + len <= p_buffer->p_payload + p_buffer->length))
+    {
+        //The record was built in the packet buffer of secure_write, send it without copying.
+        mp_tx_buffer = NULL;
+
+        if (buf != p_buffer->p_payload)
+        {
+            memmove(p_buffer->p_payload, buf, len);
+        }
+        p_buffer->length = len;
+
+        return port_send(session->addr.u8, session->port, m_secure_port_index, p_buffer);
+    }
+
     return port_write(session->addr.u8, session->port, m_secure_port_index, (uint8_t *) buf, len);
 }
 
@@ -356,6 +389,54 @@ int dtls_ecdsa_key_verify_callback(struct dtls_context_t *ctx,
 }
 
 
+/**@brief Writes application data on the established DTLS session.
+ *
+ * @details The data is copied once, into a packet buffer that leaves room for the DTLS record
+ *          header in front of it and for the MAC behind it. tinydtls encrypts the data in place
+ *          and passes the record to @ref dtls_transport_write, which sends the packet buffer
+ *          itself.
+ *
+ * @param[in]   p_data   Data to be written.
+ * @param[in]   datalen  Length of the data.
+ *
+ * @retval NRF_SUCCESS   Indicates if the data was written successfully, else an error code
+ *                       indicating reason for failure.
+ */
+static uint32_t secure_write(const uint8_t * p_data, uint16_t datalen)
+{
+    uint32_t                       err_code;
+    iot_pbuffer_t                * p_buffer;
+    iot_pbuffer_alloc_param_t      buffer_param;
+    int                            err;
+
+    buffer_param.type   = UDP6_PACKET_TYPE;
+    buffer_param.flags  = PBUFFER_FLAG_DEFAULT;
+    buffer_param.length = DTLS_RECORD_HEADROOM + datalen + DTLS_RECORD_TAILROOM;
+
+    err_code = iot_pbuffer_allocate(&buffer_param, &p_buffer);
+    if (err_code != NRF_SUCCESS)
+    {
+        return err_code;
+    }
+
+    memcpy(p_buffer->p_payload + DTLS_RECORD_HEADROOM, p_data, datalen);
+
+    mp_tx_buffer = p_buffer;
+    err = dtls_write_inplace(m_dtls_context,
+                             &m_dtls_session,
+                             p_buffer->p_payload + DTLS_RECORD_HEADROOM,
+                             datalen);
+    if (mp_tx_buffer != NULL)
+    {
+        //No record was sent from the buffer.
+        mp_tx_buffer = NULL;
+        UNUSED_VARIABLE(iot_pbuffer_free(p_buffer, true));
+    }
+
+    return (err < 0) ? NRF_ERROR_INTERNAL : NRF_SUCCESS;
+}
+
+
 /**@brief Creates port as requested in p_port.
  *
  * @details Creates port as requested in p_port.
@@ -468,15 +549,7 @@ uint32_t coap_transport_write(const coap_port_t    * p_port,
             if ((index == m_secure_port_index) && (m_dtls_state == DTLS_SESSION_ESTABLISHED))                    
             {
                 COAP_TRANSPORT_TRC ("[CoAP-DTLS]: dtls_write as server\r\n");
-                err = dtls_write(m_dtls_context, &m_dtls_session, (uint8_t *)p_data, datalen);
-                if (err < 0)
-                {
-                    err_code = NRF_ERROR_INTERNAL;
-                }
-                else
-                {
-                    err_code = NRF_SUCCESS;
-                }
+                err_code = secure_write(p_data, datalen);
             }
             else if (p_remote->port_number == COAP_SECURE_PORT)
             {
@@ -544,6 +544,57 @@
  */
 #define SNTP_RETRANSMISSION_INTERVAL                       2
 
+/**
+ * @brief Shortest interval between periodic queries in seconds.
+ *
+ * @details Used after start of periodic synchronization and after the local time was stepped.
+ *          Minimum value      : SNTP_RETRANSMISSION_INTERVAL * (SNTP_MAX_RETRANSMISSION_COUNT + 1)
+ *          Maximum value      : SNTP_POLL_INTERVAL_MAX.
+ *          Dependencies       : None.
+ */
+#define SNTP_POLL_INTERVAL_MIN                             64
+
+/**
+ * @brief Longest interval between periodic queries in seconds.
+ *
+ * @details Must be SNTP_POLL_INTERVAL_MIN multiplied by a power of two.
+ *          Minimum value      : SNTP_POLL_INTERVAL_MIN
+ *          Maximum value      : 2000000.
+ *          Dependencies       : None.
+ */
+#define SNTP_POLL_INTERVAL_MAX                             4096
+
+/**
+ * @brief Offset in milliseconds above which the local time is stepped.
+ *
+ * @details Smaller offsets are also used for correcting the frequency of the local clock.
+ *          Should be well above IOT_TIMER_RESOLUTION_IN_MS.
+ *          Minimum value      : 1
+ *          Maximum value      : 1000000.
+ *          Dependencies       : None.
+ */
+#define SNTP_STEP_THRESHOLD_MS                             500
+
+/**
+ * @brief Offset in milliseconds below which the local clock is considered settled.
+ *
+ * @details The poll interval is doubled after several offsets below this value in a row, and
+ *          halved on a larger offset.
+ *          Minimum value      : IOT_TIMER_RESOLUTION_IN_MS
+ *          Maximum value      : SNTP_STEP_THRESHOLD_MS.
+ *          Dependencies       : None.
+ */
+#define SNTP_POLL_ADJUST_THRESHOLD_MS                      250
+
+/**
+ * @brief Largest frequency correction of the local clock in parts per million.
+ *
+ * @details Minimum value      : 1
+ *          Maximum value      : 2000.
+ *          Dependencies       : None.
+ */
+#define SNTP_FREQ_MAX_PPM                                  500
+
 /** @} */
 /** @} */
 
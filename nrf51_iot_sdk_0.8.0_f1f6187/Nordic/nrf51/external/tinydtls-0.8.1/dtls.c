@@ -184,6 +184,25 @@ dtls_send_multi(dtls_context_t *ctx, dtls_peer_t *peer,
 		unsigned char type, uint8 *buf_array[],
 		size_t buf_len_array[], size_t buf_array_len);
 
+static int
+dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
+		    unsigned char type,
+		    uint8 *data_array[], size_t data_len_array[],
+		    size_t data_array_len,
+		    uint8 *sendbuf, size_t *rlen);
+
+/**
+ * Returns the number of bytes between the start of a record and its
+ * payload for the cipher selected in \p security: the record header,
+ * followed by the explicit nonce when a cipher is in use.
+ */
+static inline size_t
+dtls_record_headroom(dtls_security_parameters_t *security) {
+  if (!security || security->cipher == TLS_NULL_WITH_NULL_NULL)
+    return DTLS_RH_LENGTH;
+  return DTLS_RECORD_HEADROOM;
+}
+
 /** 
  * Sends the fragment of length \p buflen given in \p buf to the
  * specified \p peer. The data will be MAC-protected and encrypted
@@ -208,7 +227,7 @@ dtls_send(dtls_context_t *ctx, dtls_peer_t *peer, unsigned char type,
 /**
  * Stops ongoing retransmissions of handshake messages for @p peer.
  */
-static void dtls_stop_retransmission(dtls_context_t *context, dtls_peer_t *peer);
+static void dtls_stop_retransmission(dtls_context_t *context, dtls_peer_t *peer, int sample_rtt);
 
 dtls_peer_t *
 dtls_get_peer(const dtls_context_t *ctx, const session_t *session) {
@@ -259,6 +278,36 @@ dtls_write(struct dtls_context_t *ctx,
   }
 }
 
+int
+dtls_write_inplace(struct dtls_context_t *ctx,
+		   session_t *dst, uint8 *buf, size_t len) {
+  dtls_security_parameters_t *security;
+  dtls_peer_t *peer;
+  uint8 *record;
+  size_t rlen;
+  int res;
+
+  peer = dtls_get_peer(ctx, dst);
+  if (!peer || peer->state != DTLS_STATE_CONNECTED)
+    return dtls_write(ctx, dst, buf, len);
+
+  /* the record is built around buf, which dtls_prepare_record()
+   * recognizes as already being in place */
+  security = dtls_security_params(peer);
+  record = buf - dtls_record_headroom(security);
+  rlen = dtls_record_headroom(security) + len + DTLS_RECORD_TAILROOM;
+
+  res = dtls_prepare_record(peer, security, DTLS_CT_APPLICATION_DATA,
+			    &buf, &len, 1, record, &rlen);
+  if (res < 0)
+    return res;
+
+  dtls_debug_hexdump("send header", record, sizeof(dtls_record_header_t));
+
+  res = CALL(ctx, write, &peer->session, record, rlen);
+  return res <= 0 ? res : (int)(len - (rlen - res));
+}
+
 static int
 dtls_get_cookie(uint8 *msg, size_t msglen, uint8 **cookie) {
   /* To access the cookie, we have to determine the session id's
@@ -1177,6 +1226,10 @@ check_finished(dtls_context_t *ctx, dtls_peer_t *peer,
  *                on success. On error, the value of \p rlen is
  *                undefined. 
  * \return Less than zero on error, or greater than zero success.
+ *
+ * A payload that already lies at its position in the record, i.e.
+ * dtls_record_headroom() bytes behind \p sendbuf, is not copied, so
+ * a record can be built in place around its payload.
  */
 static int
 dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
@@ -1207,7 +1260,8 @@ dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
         return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
       }
 
-      memcpy(p, data_array[i], data_len_array[i]);
+      if (p != data_array[i])
+        memcpy(p, data_array[i], data_len_array[i]);
       p += data_len_array[i];
       res += data_len_array[i];
     }
@@ -1279,11 +1333,18 @@ dtls_prepare_record(dtls_peer_t *peer, dtls_security_parameters_t *security,
         return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
       }
 
-      memcpy(p, data_array[i], data_len_array[i]);
+      if (p != data_array[i])
+        memcpy(p, data_array[i], data_len_array[i]);
       p += data_len_array[i];
       res += data_len_array[i];
     }
 
+    /* room for the MAC added by dtls_encrypt() */
+    if (*rlen < res + DTLS_RH_LENGTH + DTLS_RECORD_TAILROOM) {
+      dtls_debug("dtls_prepare_record: send buffer too small\n");
+      return dtls_alert_fatal_create(DTLS_ALERT_INTERNAL_ERROR);
+    }
+
     memset(nonce, 0, DTLS_CCM_BLOCKSIZE);
     memcpy(nonce, dtls_kb_local_iv(security, peer->role),
 	   dtls_kb_iv_size(security, peer->role));
@@ -1392,11 +1453,64 @@ dtls_send_handshake_msg(dtls_context_t *ctx,
      (dtls_uint16_to_int(DTLS_RECORD_HEADER(Data)->epoch > 0) ||	\
       (dtls_uint16_to_int(HANDSHAKE(Data)->message_seq) > 0)))))
 
+/* Output buffer for records whose payload must be copied, either
+ * because it is scattered over several buffers or because it is
+ * encrypted while the plaintext is kept for retransmission. Records
+ * are built and handed to the write callback one at a time, so a
+ * single buffer serves dtls_send_multi() and dtls_retransmit(). */
+static unsigned char sendbuf[DTLS_MAX_BUF];
+
+/**
+ * Sends the payload stored in the retransmit buffer @p node as a
+ * record protected with @p security. The payload is kept behind
+ * DTLS_RECORD_HEADROOM bytes of spare room and is never modified.
+ * Without a cipher, the record header is written into that room and
+ * the record is passed to the write callback directly from @p node.
+ * Otherwise the payload is encrypted into sendbuf, which leaves the
+ * plaintext in @p node for later retransmissions.
+ *
+ * @return Less than zero in case of an error or the number of
+ *   payload bytes that have been sent otherwise.
+ */
+static int
+dtls_send_node(dtls_context_t *ctx, netq_t *node,
+	       dtls_security_parameters_t *security, session_t *session)
+{
+  uint8 *data = node->data + DTLS_RECORD_HEADROOM;
+  size_t length = node->length;
+  uint8 *record;
+  size_t len;
+  int res;
+
+  if (dtls_record_headroom(security) == DTLS_RH_LENGTH) {
+    record = data - DTLS_RH_LENGTH;
+    len = DTLS_RH_LENGTH + length;
+  } else {
+    record = sendbuf;
+    len = sizeof(sendbuf);
+  }
+
+  res = dtls_prepare_record(node->peer, security, node->type, &data, &length,
+			    1, record, &len);
+  if (res < 0)
+    return res;
+
+  dtls_debug_hexdump("send header", record, sizeof(dtls_record_header_t));
+  dtls_debug_hexdump("send unencrypted", data, length);
+
+  res = CALL(ctx, write, session, record, len);
+  return res <= 0 ? res : (int)(length - (len - res));
+}
+
 /**
  * Sends the data passed in @p buf as a DTLS record of type @p type to
  * the given peer. The data will be encrypted and compressed according
  * to the security parameters for @p peer.
  *
+ * Handshake messages that must be retransmitted are gathered once
+ * into a retransmit buffer, and the record is sent from that buffer
+ * by dtls_send_node(). All other records are built in sendbuf.
+ *
  * @param ctx    The DTLS context in effect.
  * @param peer   The remote party where the packet is sent.
  * @param type   The content type of this record.
@@ -1411,51 +1525,42 @@ dtls_send_multi(dtls_context_t *ctx, dtls_peer_t *peer,
 		unsigned char type, uint8 *buf_array[],
 		size_t buf_len_array[], size_t buf_array_len)
 {
-  /* We cannot use ctx->sendbuf here as it is reserved for collecting
-   * the input for this function, i.e. buf == ctx->sendbuf.
-   *
-   * TODO: check if we can use the receive buf here. This would mean
-   * that we might not be able to handle multiple records stuffed in
-   * one UDP datagram */
-  static unsigned char sendbuf[DTLS_MAX_BUF];
   size_t len = sizeof(sendbuf);
   int res;
   unsigned int i;
   size_t overall_len = 0;
 
-  res = dtls_prepare_record(peer, security, type, buf_array, buf_len_array, buf_array_len, sendbuf, &len);
-
-  if (res < 0)
-    return res;
-
-  /* if (peer && MUST_HASH(peer, type, buf, buflen)) */
-  /*   update_hs_hash(peer, buf, buflen); */
-
-  dtls_debug_hexdump("send header", sendbuf, sizeof(dtls_record_header_t));
   for (i = 0; i < buf_array_len; i++) {
-    dtls_debug_hexdump("send unencrypted", buf_array[i], buf_len_array[i]);
     overall_len += buf_len_array[i];
   }
 
   if ((type == DTLS_CT_HANDSHAKE && buf_array[0][0] != DTLS_HT_HELLO_VERIFY_REQUEST) ||
       type == DTLS_CT_CHANGE_CIPHER_SPEC) {
     /* copy handshake messages other than HelloVerify into retransmit buffer */
-    netq_t *n = netq_node_new(overall_len);
+    netq_t *n = netq_node_new(DTLS_RECORD_HEADROOM + overall_len);
     if (n) {
       dtls_tick_t now;
       dtls_ticks(&now);
-      n->t = now + 2 * CLOCK_SECOND;
+      n->timeout = peer ? peer->rto : DTLS_RTO_INITIAL;
+      n->t = now + n->timeout;
       n->retransmit_cnt = 0;
-      n->timeout = 2 * CLOCK_SECOND;
       n->peer = peer;
       n->epoch = (security) ? security->epoch : 0;
       n->type = type;
       n->length = 0;
       for (i = 0; i < buf_array_len; i++) {
-        memcpy(n->data + n->length, buf_array[i], buf_len_array[i]);
+        memcpy(n->data + DTLS_RECORD_HEADROOM + n->length, buf_array[i], buf_len_array[i]);
         n->length += buf_len_array[i];
       }
 
+      /* Send before queueing, so that a record that cannot be
+       * built or written is never retransmitted. */
+      res = dtls_send_node(ctx, n, security, session);
+      if (res < 0) {
+	netq_node_free(n);
+	return res;
+      }
+
       if (!netq_insert_node(ctx->sendqueue, n)) {
 	dtls_warn("cannot add packet to retransmit buffer\n");
 	netq_node_free(n);
@@ -1466,13 +1571,28 @@ dtls_send_multi(dtls_context_t *ctx, dtls_peer_t *peer,
 	etimer_set(&ctx->retransmit_timer, n->timeout);
 	PROCESS_CONTEXT_END(&dtls_retransmit_process);
 #else /* WITH_CONTIKI */
+      } else {
 	dtls_debug("copied to sendqueue\n");
 #endif /* WITH_CONTIKI */
       }
+      return res;
     } else 
       dtls_warn("retransmit buffer full\n");
   }
 
+  res = dtls_prepare_record(peer, security, type, buf_array, buf_len_array, buf_array_len, sendbuf, &len);
+
+  if (res < 0)
+    return res;
+
+  /* if (peer && MUST_HASH(peer, type, buf, buflen)) */
+  /*   update_hs_hash(peer, buf, buflen); */
+
+  dtls_debug_hexdump("send header", sendbuf, sizeof(dtls_record_header_t));
+  for (i = 0; i < buf_array_len; i++) {
+    dtls_debug_hexdump("send unencrypted", buf_array[i], buf_len_array[i]);
+  }
+
   /* FIXME: copy to peer's sendqueue (after fragmentation if
    * necessary) and initialize retransmit timer */
   res = CALL(ctx, write, session, sendbuf, len);
@@ -3003,7 +3123,7 @@ handle_handshake_msg(dtls_context_t *ctx, dtls_peer_t *peer, session_t *session,
    * we do everything accordingly to the DTLS 1.2 standard this should
    * not be a problem. */
   if (peer) {
-    dtls_stop_retransmission(ctx, peer);
+    dtls_stop_retransmission(ctx, peer, 1);
   }
 
   /* The following switch construct handles the given message with
@@ -3556,7 +3676,7 @@ handle_alert(dtls_context_t *ctx, dtls_peer_t *peer,
   }
   
   if (free_peer) {
-    dtls_stop_retransmission(ctx, peer);
+    dtls_stop_retransmission(ctx, peer, 0);
     dtls_destroy_peer(ctx, peer, 0);
   }
 
@@ -3655,7 +3775,7 @@ dtls_handle_message(dtls_context_t *ctx,
 
     case DTLS_CT_CHANGE_CIPHER_SPEC:
       if (peer) {
-        dtls_stop_retransmission(ctx, peer);
+        dtls_stop_retransmission(ctx, peer, 1);
       }
       err = handle_ccs(ctx, peer, msg, data, data_length);
       if (err < 0) {
@@ -3672,7 +3792,7 @@ dtls_handle_message(dtls_context_t *ctx,
 
     case DTLS_CT_ALERT:
       if (peer) {
-        dtls_stop_retransmission(ctx, peer);
+        dtls_stop_retransmission(ctx, peer, 0);
       }
       err = handle_alert(ctx, peer, msg, data, data_length);
       if (err < 0 || err == 1) {
@@ -3716,7 +3836,7 @@ dtls_handle_message(dtls_context_t *ctx,
       }
       if (peer && peer->state == DTLS_STATE_CONNECTED) {
 	/* stop retransmissions */
-	dtls_stop_retransmission(ctx, peer);
+	dtls_stop_retransmission(ctx, peer, 0);
 	CALL(ctx, event, &peer->session, 0, DTLS_EVENT_CONNECTED);
       }
       break;
@@ -3728,7 +3848,7 @@ dtls_handle_message(dtls_context_t *ctx,
         // TODO: should we send a alert here?
         return -1;
       }
-      dtls_stop_retransmission(ctx, peer);
+      dtls_stop_retransmission(ctx, peer, 0);
       CALL(ctx, read, &peer->session, data, data_length);
       break;
     default:
@@ -3880,17 +4000,25 @@ dtls_retransmit(dtls_context_t *context, netq_t *node) {
 
   /* re-initialize timeout when maximum number of retransmissions are not reached yet */
   if (node->retransmit_cnt < DTLS_DEFAULT_MAX_RETRANSMIT) {
-      unsigned char sendbuf[DTLS_MAX_BUF];
-      size_t len = sizeof(sendbuf);
       int err;
-      unsigned char *data = node->data;
-      size_t length = node->length;
+      unsigned char *data = node->data + DTLS_RECORD_HEADROOM;
       dtls_tick_t now;
+      clock_time_t timeout;
       dtls_security_parameters_t *security = dtls_security_params_epoch(node->peer, node->epoch);
 
       dtls_ticks(&now);
       node->retransmit_cnt++;
-      node->t = now + (node->timeout << node->retransmit_cnt);
+      timeout = node->timeout << node->retransmit_cnt;
+      if (timeout > DTLS_RTO_MAX)
+        timeout = DTLS_RTO_MAX;
+      node->t = now + timeout;
+
+      /* Keep the backed off timeout for the next flights until a valid
+       * round-trip time sample is taken (RFC 6298, Section 5.5). All
+       * records of a flight compute the same value, so it is not
+       * doubled once per record. */
+      if (node->peer->rto < timeout)
+        node->peer->rto = timeout;
       netq_insert_node(context->sendqueue, node);
       
       if (node->type == DTLS_CT_HANDSHAKE) {
@@ -3902,17 +4030,10 @@ dtls_retransmit(dtls_context_t *context, netq_t *node) {
 	dtls_debug("** retransmit packet\n");
       }
       
-      err = dtls_prepare_record(node->peer, security, node->type, &data, &length,
-				1, sendbuf, &len);
+      err = dtls_send_node(context, node, security, &node->peer->session);
       if (err < 0) {
 	dtls_warn("can not retransmit packet, err: %i\n", err);
-	return;
       }
-      dtls_debug_hexdump("retransmit header", sendbuf,
-			 sizeof(dtls_record_header_t));
-      dtls_debug_hexdump("retransmit unencrypted", node->data, node->length);
-
-      (void)CALL(context, write, &node->peer->session, sendbuf, len);
       return;
   }
 
@@ -3924,20 +4045,78 @@ dtls_retransmit(dtls_context_t *context, netq_t *node) {
   netq_node_free(node);
 }
 
+/**
+ * Updates the retransmission timeout of @p peer with a round-trip
+ * time sample @p rtt as described in RFC 6298, Section 2.
+ */
+static void
+dtls_rtt_update(dtls_peer_t *peer, clock_time_t rtt) {
+  clock_time_t delta;
+
+  if (rtt == 0)
+    rtt = 1;
+
+  if (peer->srtt == 0) {
+    peer->srtt = rtt;
+    peer->rttvar = rtt / 2;
+  } else {
+    delta = (peer->srtt > rtt) ? peer->srtt - rtt : rtt - peer->srtt;
+    peer->rttvar = peer->rttvar - peer->rttvar / 4 + delta / 4;
+    peer->srtt = peer->srtt - peer->srtt / 8 + rtt / 8;
+  }
+
+  peer->rto = peer->srtt + 4 * peer->rttvar;
+  if (peer->rto < DTLS_RTO_MIN)
+    peer->rto = DTLS_RTO_MIN;
+  else if (peer->rto > DTLS_RTO_MAX)
+    peer->rto = DTLS_RTO_MAX;
+
+  dtls_debug("rtt %u, srtt %u, rto %u\n", (unsigned int)rtt,
+	     (unsigned int)peer->srtt, (unsigned int)peer->rto);
+}
+
+/**
+ * Removes the flight sent to @p peer from the retransmit queue. If
+ * @p sample_rtt is set, the caller has received the peer's answer to
+ * the flight, and the time since the flight was sent is used as
+ * round-trip time sample unless part of the flight has been
+ * retransmitted, in which case it is unknown which transmission was
+ * answered (Karn's algorithm). Callers that stop retransmission for
+ * other reasons (alerts, closing the peer, the end of the handshake
+ * or application data) must not set @p sample_rtt.
+ */
 static void
-dtls_stop_retransmission(dtls_context_t *context, dtls_peer_t *peer) {
+dtls_stop_retransmission(dtls_context_t *context, dtls_peer_t *peer, int sample_rtt) {
   netq_t *node;
+  dtls_tick_t now, sent = 0;
+  int found = 0, retransmitted = 0;
+
   node = list_head(context->sendqueue); 
 
   while (node) {
     if (dtls_session_equals(&node->peer->session, &peer->session)) {
       netq_t *tmp = node;
+
+      if (node->retransmit_cnt) {
+        retransmitted = 1;
+      } else if (!found || node->t - node->timeout > sent) {
+        /* not retransmitted yet, so t is still the first send time
+         * plus the initial timeout */
+        sent = node->t - node->timeout;
+        found = 1;
+      }
+
       node = list_item_next(node);
       list_remove(context->sendqueue, tmp);
       netq_node_free(tmp);
     } else
       node = list_item_next(node);    
   }
+
+  if (sample_rtt && found && !retransmitted) {
+    dtls_ticks(&now);
+    dtls_rtt_update(peer, now - sent);
+  }
 }
 
 void
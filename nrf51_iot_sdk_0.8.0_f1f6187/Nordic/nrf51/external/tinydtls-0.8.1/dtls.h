@@ -315,6 +315,36 @@ int dtls_renegotiate(dtls_context_t *ctx, const session_t *dst);
 int dtls_write(struct dtls_context_t *ctx, session_t *session, 
 	       uint8 *buf, size_t len);
 
+/** Space needed in front of application data passed to dtls_write_inplace(). */
+#define DTLS_RECORD_HEADROOM (sizeof(dtls_record_header_t) + 8)
+
+/** Space needed behind application data passed to dtls_write_inplace(). */
+#define DTLS_RECORD_TAILROOM 8
+
+/**
+ * Writes the application data given in @p buf to the peer specified
+ * by @p session without copying it. The caller must provide
+ * DTLS_RECORD_HEADROOM writable bytes in front of @p buf and
+ * DTLS_RECORD_TAILROOM writable bytes behind it. The record header
+ * and explicit nonce are written in front of the data, the data is
+ * encrypted in place and the MAC is appended. The write callback is
+ * then called with a pointer into the caller's buffer, not more than
+ * DTLS_RECORD_HEADROOM bytes before @p buf. The contents of @p buf
+ * are lost.
+ *
+ * If the session is not connected yet, this function behaves like
+ * dtls_write().
+ *
+ * @param ctx      The DTLS context to use.
+ * @param session  The remote transport address and local interface.
+ * @param buf      The data to write, with head and tail room around it.
+ * @param len      The actual length of @p buf.
+ *
+ * @return The number of bytes written or a value less than zero on error.
+ */
+int dtls_write_inplace(struct dtls_context_t *ctx, session_t *session,
+		       uint8 *buf, size_t len);
+
 /**
  * Checks sendqueue of given DTLS context object for any outstanding
  * packets to be transmitted. 
@@ -68,6 +68,23 @@ typedef unsigned char uint48[6];
 #define DTLS_DEFAULT_MAX_RETRANSMIT 7
 #endif
 
+#ifndef DTLS_RTO_INITIAL
+/** Retransmission timeout in clock ticks until the round-trip time
+    to a peer has been measured. */
+#define DTLS_RTO_INITIAL (2 * CLOCK_SECOND)
+#endif
+
+#ifndef DTLS_RTO_MIN
+/** Lower limit of the measured retransmission timeout in clock ticks. */
+#define DTLS_RTO_MIN (CLOCK_SECOND / 2)
+#endif
+
+#ifndef DTLS_RTO_MAX
+/** Upper limit of the retransmission timeout in clock ticks, also
+    after exponential backoff. See RFC 6347, Section 4.2.4.1. */
+#define DTLS_RTO_MAX (60 * CLOCK_SECOND)
+#endif
+
 /** Known cipher suites.*/
 typedef enum { 
   TLS_NULL_WITH_NULL_NULL = 0x0000,   /**< NULL cipher  */
@@ -109,29 +109,46 @@ dtls_hmac_new(const unsigned char *key, size_t klen) {
 
 void
 dtls_hmac_init(dtls_hmac_context_t *ctx, const unsigned char *key, size_t klen) {
+  unsigned char pad[DTLS_HMAC_BLOCKSIZE];
   int i;
 
   assert(ctx);
 
-  memset(ctx, 0, sizeof(dtls_hmac_context_t));
+  memset(pad, 0, sizeof(pad));
 
   if (klen > DTLS_HMAC_BLOCKSIZE) {
     dtls_hash_init(&ctx->data);
     dtls_hash_update(&ctx->data, key, klen);
-    dtls_hash_finalize(ctx->pad, &ctx->data);
+    dtls_hash_finalize(pad, &ctx->data);
   } else
-    memcpy(ctx->pad, key, klen);
+    memcpy(pad, key, klen);
 
-  /* create ipad: */
+  /* create ipad and save the hash state after it: */
   for (i=0; i < DTLS_HMAC_BLOCKSIZE; ++i)
-    ctx->pad[i] ^= 0x36;
+    pad[i] ^= 0x36;
 
   dtls_hash_init(&ctx->data);
-  dtls_hmac_update(ctx, ctx->pad, DTLS_HMAC_BLOCKSIZE);
+  dtls_hash_update(&ctx->data, pad, DTLS_HMAC_BLOCKSIZE);
+  dtls_hash_state_save(ctx->inner, &ctx->data);
 
   /* create opad by xor-ing pad[i] with 0x36 ^ 0x5C: */
   for (i=0; i < DTLS_HMAC_BLOCKSIZE; ++i)
-    ctx->pad[i] ^= 0x6A;
+    pad[i] ^= 0x6A;
+
+  dtls_hash_init(&ctx->data);
+  dtls_hash_update(&ctx->data, pad, DTLS_HMAC_BLOCKSIZE);
+  dtls_hash_state_save(ctx->outer, &ctx->data);
+
+  /* do not leave key material on the stack */
+  memset(pad, 0, sizeof(pad));
+
+  dtls_hmac_reset(ctx);
+}
+
+void
+dtls_hmac_reset(dtls_hmac_context_t *ctx) {
+  assert(ctx);
+  dtls_hash_state_restore(&ctx->data, ctx->inner);
 }
 
 void
@@ -150,8 +167,7 @@ dtls_hmac_finalize(dtls_hmac_context_t *ctx, unsigned char *result) {
   
   len = dtls_hash_finalize(buf, &ctx->data);
 
-  dtls_hash_init(&ctx->data);
-  dtls_hash_update(&ctx->data, ctx->pad, DTLS_HMAC_BLOCKSIZE);
+  dtls_hash_state_restore(&ctx->data, ctx->outer);
   dtls_hash_update(&ctx->data, buf, len);
 
   len = dtls_hash_finalize(result, &ctx->data);
@@ -27,6 +27,7 @@
 #define _DTLS_HMAC_H_
 
 //#include <sys/types.h>
+#include <string.h>
 
 #include "global.h"
 
@@ -54,6 +55,29 @@ dtls_hash_finalize(unsigned char *buf, dtls_hash_t ctx) {
   SHA256_Final(buf, (SHA256_CTX *)ctx);
   return SHA256_DIGEST_LENGTH;
 }
+
+/** Size of the chaining state of the hash function. */
+#define DTLS_HASH_STATE_SIZE sizeof(((SHA256_CTX *)0)->state)
+
+/**
+ * Copies the chaining state of @p ctx to @p state. Must only be
+ * called when the data hashed so far fills complete blocks.
+ */
+static inline void
+dtls_hash_state_save(unsigned char *state, dtls_hash_t ctx) {
+  memcpy(state, ((SHA256_CTX *)ctx)->state, DTLS_HASH_STATE_SIZE);
+}
+
+/**
+ * Sets @p ctx to the chaining state saved by dtls_hash_state_save()
+ * after hashing exactly one block, as if that block had just been
+ * hashed again.
+ */
+static inline void
+dtls_hash_state_restore(dtls_hash_t ctx, const unsigned char *state) {
+  memcpy(((SHA256_CTX *)ctx)->state, state, DTLS_HASH_STATE_SIZE);
+  ((SHA256_CTX *)ctx)->bitcount = SHA256_BLOCK_LENGTH << 3;
+}
 #endif /* WITH_SHA256 */
 
 #ifndef WITH_CONTIKI
@@ -88,13 +112,17 @@ typedef enum {
 /**
  * Context for HMAC generation. This object is initialized with
  * dtls_hmac_init() and must be passed to dtls_hmac_update() and
- * dtls_hmac_finalize(). Once, finalized, the component \c H is
- * invalid and must be initialized again with dtls_hmac_init() before
- * the structure can be used again. 
+ * dtls_hmac_finalize(). Once, finalized, the component \c data is
+ * invalid and must be reset with dtls_hmac_reset() before the
+ * structure can be used again with the same key.
+ *
+ * The hash states after the ipad and opad blocks are computed once
+ * per key, so that neither block is hashed again for every MAC.
  */
 typedef struct {
-  unsigned char pad[DTLS_HMAC_BLOCKSIZE]; /**< ipad and opad storage */
-  dtls_hash_ctx data;		          /**< context for hash function */
+  unsigned char inner[DTLS_HASH_STATE_SIZE]; /**< hash state after the ipad block */
+  unsigned char outer[DTLS_HASH_STATE_SIZE]; /**< hash state after the opad block */
+  dtls_hash_ctx data;		             /**< context for hash function */
 } dtls_hmac_context_t;
 
 /**
@@ -106,6 +134,15 @@ typedef struct {
  */
 void dtls_hmac_init(dtls_hmac_context_t *ctx, const unsigned char *key, size_t klen);
 
+/**
+ * Prepares an initialized HMAC context for a new MAC with the same
+ * key. This is much cheaper than calling dtls_hmac_init() again, as
+ * the key pads are not hashed again.
+ *
+ * @param ctx The HMAC context to reset.
+ */
+void dtls_hmac_reset(dtls_hmac_context_t *ctx);
+
 /**
  * Allocates a new HMAC context \p ctx with the given secret key.
  * This function returns \c 1 if \c ctx has been set correctly, or \c
@@ -141,7 +178,8 @@ void dtls_hmac_update(dtls_hmac_context_t *ctx,
  * output parameter \c result. The buffer must be large enough to hold
  * the message digest created by the actual hash function. If in
  * doubt, use \c DTLS_HMAC_MAX. The function returns the number of
- * bytes written to \c result. 
+ * bytes written to \c result. Call dtls_hmac_reset() before using
+ * \c ctx for another MAC.
  *
  * \param ctx    The HMAC context.
  * \param result Output parameter where the MAC is written to.
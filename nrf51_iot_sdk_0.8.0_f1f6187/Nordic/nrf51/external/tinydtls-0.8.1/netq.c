@@ -26,7 +26,11 @@
 
 static inline netq_t *
 netq_malloc_node(size_t size) {
-  return (netq_t *)malloc(sizeof(netq_t) + size);
+  netq_t *node = (netq_t *)malloc(sizeof(netq_t) + size);
+
+  if (node)
+    node->data = (unsigned char *)(node + 1);
+  return node;
 }
 
 static inline void
@@ -89,19 +93,20 @@ netq_init() {
 
 int 
 netq_insert_node(list_t queue, netq_t *node) {
-  netq_t *p;
+  netq_t *p, *prev = NULL;
 
   assert(queue);
   assert(node);
 
+  /* keep the queue sorted by expiry, so that the next node to
+   * retransmit is always at the head */
   p = (netq_t *)list_head(queue);
-  while(p && p->t <= node->t && list_item_next(p))
+  while(p && p->t <= node->t) {
+    prev = p;
     p = list_item_next(p);
+  }
 
-  if (p)
-    list_insert(queue, p, node);
-  else
-    list_push(queue, node);
+  list_insert(queue, prev, node);
 
   return 1;
 }
@@ -32,8 +32,10 @@
 
 /** 
  * Datagrams in the netq_t structure have a fixed maximum size of
- * DTLS_MAX_BUF to simplify memory management on constrained nodes. */ 
-typedef unsigned char netq_packet_t[DTLS_MAX_BUF];
+ * DTLS_MAX_BUF to simplify memory management on constrained nodes.
+ * The payload is stored behind DTLS_RECORD_HEADROOM bytes of room
+ * for the record header. */ 
+typedef unsigned char netq_packet_t[DTLS_RECORD_HEADROOM + DTLS_MAX_BUF];
 
 typedef struct netq_t {
   struct netq_t *next;
@@ -46,7 +48,10 @@ typedef struct netq_t {
   uint8_t type;
   unsigned char retransmit_cnt;	/**< retransmission counter, will be removed when zero */
 
-  size_t length;		/**< actual length of data */
+  size_t length;		/**< actual length of the payload, which starts
+				 * DTLS_RECORD_HEADROOM bytes into data for
+				 * the sendqueue and at data for the
+				 * reorder_queue */
 #ifndef WITH_CONTIKI
   unsigned char * data;		/**< the datagram to send */
 #else
@@ -105,6 +105,7 @@ dtls_new_peer(const session_t *session) {
   if (peer) {
     memset(peer, 0, sizeof(dtls_peer_t));
     memcpy(&peer->session, session, sizeof(session_t));
+    peer->rto = DTLS_RTO_INITIAL;
     peer->security_params[0] = dtls_security_new();
 
     if (!peer->security_params[0]) {
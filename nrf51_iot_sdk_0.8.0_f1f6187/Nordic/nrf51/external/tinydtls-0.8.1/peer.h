@@ -39,6 +39,7 @@
 
 #include "state.h"
 #include "crypto.h"
+#include "dtls_time.h"
 
 #if (!defined WITH_CONTIKI) && (!defined WITH_NORDIC_IP)
 #include "uthash.h"
@@ -63,6 +64,10 @@ typedef struct dtls_peer_t {
 
   dtls_security_parameters_t *security_params[2];
   dtls_handshake_parameters_t *handshake_params;
+
+  clock_time_t srtt;         /**< smoothed round-trip time, 0 until measured */
+  clock_time_t rttvar;       /**< round-trip time variation */
+  clock_time_t rto;          /**< retransmission timeout of the next flight, backed off on retransmission */
 } dtls_peer_t;
 
 static inline dtls_security_parameters_t *dtls_security_params_epoch(dtls_peer_t *peer, uint16_t epoch)
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "tinydtls.h"
+#include "debug.h"
+#include "global.h"
+#include "hmac.h"
+#include "crypto.h"
+
+/* HMAC-SHA-256 test cases 1 to 4 and 6 of RFC 4231 */
+struct hmac_testcase {
+  const unsigned char *key;
+  size_t keylen;
+  const unsigned char *data;
+  size_t datalen;
+  unsigned char mac[DTLS_HMAC_DIGEST_SIZE];
+};
+
+static unsigned char key1[20], key3[20], key6[131], data3[50];
+
+static const unsigned char key4[] = {
+  0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+  0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14,
+  0x15, 0x16, 0x17, 0x18, 0x19
+};
+
+static unsigned char data4[50];
+
+static const struct hmac_testcase hmac_data[] = {
+  { key1, sizeof(key1), (const unsigned char *)"Hi There", 8,
+    { 0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53, 0x5c, 0xa8, 0xaf, 0xce, 0xaf, 0x0b, 0xf1, 0x2b,
+      0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7, 0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7 } },
+  { (const unsigned char *)"Jefe", 4,
+    (const unsigned char *)"what do ya want for nothing?", 28,
+    { 0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+      0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43 } },
+  { key3, sizeof(key3), data3, sizeof(data3),
+    { 0x77, 0x3e, 0xa9, 0x1e, 0x36, 0x80, 0x0e, 0x46, 0x85, 0x4d, 0xb8, 0xeb, 0xd0, 0x91, 0x81, 0xa7,
+      0x29, 0x59, 0x09, 0x8b, 0x3e, 0xf8, 0xc1, 0x22, 0xd9, 0x63, 0x55, 0x14, 0xce, 0xd5, 0x65, 0xfe } },
+  { key4, sizeof(key4), data4, sizeof(data4),
+    { 0x82, 0x55, 0x8a, 0x38, 0x9a, 0x44, 0x3c, 0x0e, 0xa4, 0xcc, 0x81, 0x98, 0x99, 0xf2, 0x08, 0x3a,
+      0x85, 0xf0, 0xfa, 0xa3, 0xe5, 0x78, 0xf8, 0x07, 0x7a, 0x2e, 0x3f, 0xf4, 0x67, 0x29, 0x66, 0x5b } },
+  { key6, sizeof(key6),
+    (const unsigned char *)"Test Using Larger Than Block-Size Key - Hash Key First", 54,
+    { 0x60, 0xe4, 0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f, 0x0d, 0x8a, 0x26, 0xaa, 0xcb, 0xf5, 0xb7, 0x7f,
+      0x8e, 0x0b, 0xc6, 0x21, 0x37, 0x28, 0xc5, 0x14, 0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f, 0x54 } }
+};
+
+/* TLS 1.2 PRF with SHA-256,
+ * see http://www.ietf.org/mail-archive/web/tls/current/msg03416.html */
+static const unsigned char prf_key[] = {
+  0x9b, 0xbe, 0x43, 0x6b, 0xa9, 0x40, 0xf0, 0x17, 0xb1, 0x76, 0x52, 0x84, 0x9a, 0x71, 0xdb, 0x35
+};
+static const unsigned char prf_label[] = "test label";
+static const unsigned char prf_random1[] = { 0xa0, 0xba, 0x9f, 0x93, 0x6c, 0xda, 0x31, 0x18 };
+static const unsigned char prf_random2[] = { 0x27, 0xa6, 0xf7, 0x96, 0xff, 0xd5, 0x19, 0x8c };
+static const unsigned char prf_result[100] = {
+  0xe3, 0xf2, 0x29, 0xba, 0x72, 0x7b, 0xe1, 0x7b, 0x8d, 0x12, 0x26, 0x20, 0x55, 0x7c, 0xd4, 0x53,
+  0xc2, 0xaa, 0xb2, 0x1d, 0x07, 0xc3, 0xd4, 0x95, 0x32, 0x9b, 0x52, 0xd4, 0xe6, 0x1e, 0xdb, 0x5a,
+  0x6b, 0x30, 0x17, 0x91, 0xe9, 0x0d, 0x35, 0xc9, 0xc9, 0xa4, 0x6b, 0x4e, 0x14, 0xba, 0xf9, 0xaf,
+  0x0f, 0xa0, 0x22, 0xf7, 0x07, 0x7d, 0xef, 0x17, 0xab, 0xfd, 0x37, 0x97, 0xc0, 0x56, 0x4b, 0xab,
+  0x4f, 0xbc, 0x91, 0x66, 0x6e, 0x9d, 0xef, 0x9b, 0x97, 0xfc, 0xe3, 0x4f, 0x79, 0x67, 0x89, 0xba,
+  0xa4, 0x80, 0x82, 0xd1, 0x22, 0xee, 0x42, 0xc5, 0xa7, 0x2e, 0x5a, 0x51, 0x10, 0xff, 0xf7, 0x01,
+  0x87, 0x34, 0x7b, 0x66
+};
+
+int 
+main() {
+  dtls_hmac_context_t ctx;
+  unsigned char buf[sizeof(prf_result)];
+  size_t n, len;
+  int failed = 0;
+
+  memset(key1, 0x0b, sizeof(key1));
+  memset(key3, 0xaa, sizeof(key3));
+  memset(key6, 0xaa, sizeof(key6));
+  memset(data3, 0xdd, sizeof(data3));
+  memset(data4, 0xcd, sizeof(data4));
+
+  for (n = 0; n < sizeof(hmac_data)/sizeof(struct hmac_testcase); n++) {
+    dtls_hmac_init(&ctx, hmac_data[n].key, hmac_data[n].keylen);
+    dtls_hmac_update(&ctx, hmac_data[n].data, hmac_data[n].datalen);
+    len = dtls_hmac_finalize(&ctx, buf);
+
+    if (len != DTLS_HMAC_DIGEST_SIZE || memcmp(buf, hmac_data[n].mac, len) != 0) {
+      printf("HMAC test %zu: FAILED\n", n + 1);
+      failed++;
+      continue;
+    }
+
+    /* the same MAC again, after resetting to the cached pad states */
+    dtls_hmac_reset(&ctx);
+    dtls_hmac_update(&ctx, hmac_data[n].data, hmac_data[n].datalen);
+    dtls_hmac_finalize(&ctx, buf);
+
+    if (memcmp(buf, hmac_data[n].mac, len) != 0) {
+      printf("HMAC test %zu after reset: FAILED\n", n + 1);
+      failed++;
+    } else {
+      printf("HMAC test %zu: OK\n", n + 1);
+    }
+  }
+
+  /* all output lengths up to the full vector, to cover partial blocks */
+  for (len = 1; len <= sizeof(prf_result); len++) {
+    dtls_prf(prf_key, sizeof(prf_key),
+	     prf_label, sizeof(prf_label) - 1,
+	     prf_random1, sizeof(prf_random1),
+	     prf_random2, sizeof(prf_random2),
+	     buf, len);
+
+    if (memcmp(buf, prf_result, len) != 0) {
+      printf("PRF test with %zu bytes: FAILED\n", len);
+      failed++;
+    }
+  }
+
+  printf("PRF test: %s\n", failed ? "FAILED" : "OK");
+
+  return failed ? 1 : 0;
+}